@@ -0,0 +1,43 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_cycle.c
+ * Description:     A stabil es periodikus mintak felismerese
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#include <stdint.h>
+#include "gol_main.h"
+#include "gol_cycle.h"
+
+void cycle_reset(CycleDetector *cycle) {
+    cycle->count = 0;
+    cycle->head = 0;
+    cycle->period = 0;
+}
+
+int cycle_push(CycleDetector *cycle, uint64_t hash, int period_max) {
+    int p;
+    if (cycle->period > 0) {
+        return 0;
+    }
+    if (period_max > CYCLE_HISTORY) {
+        period_max = CYCLE_HISTORY;
+    }
+    if (period_max > cycle->count) {
+        period_max = cycle->count;
+    }
+    // A legrovidebb periodust keressuk: p generacioval korabbi hash a (head - p). helyen van
+    for (p=1; p<=period_max; p++) {
+        if (cycle->hashes[(cycle->head - p + CYCLE_HISTORY) % CYCLE_HISTORY] == hash) {
+            cycle->period = p;
+            break;
+        }
+    }
+    cycle->hashes[cycle->head] = hash;
+    cycle->head = (cycle->head + 1) % CYCLE_HISTORY;
+    if (cycle->count < CYCLE_HISTORY) {
+        cycle->count++;
+    }
+    return cycle->period;
+}
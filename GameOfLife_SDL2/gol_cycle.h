@@ -0,0 +1,32 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_cycle.h
+ * Description:     A stabil es periodikus mintak felismerese
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#ifndef __GOL_CYCLE_H_INCLUDED__
+#define __GOL_CYCLE_H_INCLUDED__
+
+/** \brief Torli a ciklusfigyelo elozmenyeit (szerkesztes, szabaly- vagy modvaltas utan)
+ *
+ * \param cycle CycleDetector* a ciklusfigyelore mutato pointer
+ * \return void
+ *
+ */
+void cycle_reset(CycleDetector *cycle);
+
+/** \brief Hozzaadja egy uj generacio hash erteket az elozmenyekhez
+ *
+ * A megtalalt periodus rogzul, a kovetkezo cycle_reset hivasig nem keres tovabb.
+ *
+ * \param cycle CycleDetector* a ciklusfigyelore mutato pointer
+ * \param hash uint64_t az uj generacio hash erteke
+ * \param period_max int a figyelt leghosszabb periodus (1..CYCLE_HISTORY)
+ * \return int a periodus, ha most derult ki, hogy a minta periodikus; kulonben 0
+ *
+ */
+int cycle_push(CycleDetector *cycle, uint64_t hash, int period_max);
+
+#endif // __GOL_CYCLE_H_INCLUDED__
@@ -12,10 +12,30 @@
 #include "gol_file.h"
 #include "gol_font.h"
 #include "gol_events.h"
+#include "gol_thread.h"
+#include "gol_kernel.h"
+#include "gol_hashlife.h"
+#include "gol_world.h"
+#include "gol_lenia.h"
+#include "gol_rule.h"
+#include "gol_cycle.h"
+#include "gol_sim.h"
 
 static MouseState mouse_state = MOUSESTATE_BOTH_UP;
 
 static const char SAVE_FILE_NAME[] = "save/grid.txt";
+static const int THREAD_COUNT_MAX = 64;
+static const int HASHLIFE_CACHE_MIN_MB = 16;
+static const int HASHLIFE_CACHE_MAX_MB = 4096;
+static const int KERNEL_BENCH_SIZE = 512;
+static const int KERNEL_BENCH_GENERATIONS = 50;
+static const int SPEED_MAX_LOG2 = 16;
+static const int CELL_MAX_SIZE = 1024;
+static const int ZOOM_MAX_LOG2 = MIP_BLOCK_LOG2 + MIP_LEVELS - 1;
+static const double LENIA_MU_STEP = 0.005;
+static const double LENIA_MU_MAX = 1.0;
+static const double LENIA_SIGMA_STEP = 0.001;
+static const double LENIA_SIGMA_MAX = 0.5;
 
 /** \brief Segedfuggveny az ablak atmeretezesehez
  *
@@ -30,6 +50,459 @@ static void Event_SetWindowSize(GameVars *game_vars, int x, int y) {
     game_vars->window_size.h = y;
 }
 
+/** \brief Segedfuggveny a leptetes szalszamanak modositasahoz
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param thread_count int Az uj szalszam (0: a processzormagok szama)
+ * \return void
+ *
+ */
+static void Event_SetThreadCount(GameVars *game_vars, int thread_count) {
+    game_vars->settings.thread_count = thread_count;
+    thread_pool_free(game_vars->thread_pool);
+    game_vars->thread_pool = thread_pool_new(thread_count);
+    if (game_vars->grid != NULL) {
+        game_vars->grid->pool = game_vars->thread_pool;
+    }
+    if (game_vars->world != NULL) {
+        game_vars->world->pool = game_vars->thread_pool;
+    }
+    if (game_vars->lenia != NULL) {
+        game_vars->lenia->pool = game_vars->thread_pool;
+    }
+}
+
+/** \brief Segedfuggveny a veges grid es a vegtelen vilag kozotti valtashoz
+ *
+ * Futo szimulacio kozben az allapotot is atmasolja. A vilagbol a gridbe csak
+ * a nem negativ koordinataju cellak kerulnek at.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param unbounded int 1: vegtelen vilag, 0: veges grid
+ * \return void
+ *
+ */
+static void Event_SetWorldMode(GameVars *game_vars, int unbounded) {
+    uint64_t lost;
+    cycle_reset(&game_vars->cycle);
+    if (unbounded && !rule_is_life(kernel_rule())) {
+        // A vegtelen vilag leptetese csak az eletjatek szabalyat ismeri
+#ifdef NDEBUG
+        fprintf(stderr, "Figyelmeztetes: a vegtelen vilag csak a B3/S23 szaballyal hasznalhato.\n");
+#endif // NDEBUG
+        unbounded = 0;
+    }
+    game_vars->settings.unbounded = unbounded;
+    if (game_vars->grid == NULL) {
+        return;
+    }
+    if (unbounded && game_vars->world == NULL) {
+        // A vegtelen vilag nyilt sik, a grid is ilyenne valik (igy a visszaalakitas sem veszit cellat)
+        game_vars->settings.topology = TOPOLOGY_PLANE;
+        grid_set_topology(game_vars->grid, TOPOLOGY_PLANE);
+        game_vars->world = world_new();
+        if (game_vars->world == NULL) {
+            game_vars->settings.unbounded = 0;
+            return;
+        }
+        game_vars->world->pool = game_vars->thread_pool;
+        world_from_grid(game_vars->world, game_vars->grid);
+        game_vars->view_x = 0;
+        game_vars->view_y = 0;
+    } else if (!unbounded && game_vars->world != NULL) {
+        lost = world_to_grid(game_vars->world, game_vars->grid);
+        if (lost > 0) {
+#ifdef NDEBUG
+            fprintf(stderr, "Figyelmeztetes: %llu elo cella nem fert el a gridben.\n", (unsigned long long)lost);
+#endif // NDEBUG
+        }
+        world_free(game_vars->world);
+        game_vars->world = NULL;
+    }
+}
+
+/** \brief Segedfuggveny a binaris es a folytonos (Lenia) szimulacio kozotti valtashoz
+ *
+ * A mezo a grid elo cellaibol indul (a vegtelen vilag elobb a gridbe kerul),
+ * visszavaltaskor a legalabb 0.5 erteku cellak lesznek elok.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param continuous int 1: folytonos mezo, 0: binaris grid
+ * \return void
+ *
+ */
+static void Event_SetLeniaMode(GameVars *game_vars, int continuous) {
+    game_vars->settings.continuous = continuous;
+    cycle_reset(&game_vars->cycle);
+    if (game_vars->grid == NULL) {
+        return;
+    }
+    if (continuous && game_vars->lenia == NULL) {
+        Event_SetWorldMode(game_vars, 0);
+        game_vars->lenia = lenia_new(game_vars->grid->size_x, game_vars->grid->size_y, game_vars->settings.lenia);
+        if (game_vars->lenia == NULL) {
+            game_vars->settings.continuous = 0;
+            return;
+        }
+        game_vars->lenia->pool = game_vars->thread_pool;
+        lenia_from_grid(game_vars->lenia, game_vars->grid);
+        // A folytonos mezo nem kicsinyitheto
+        game_vars->zoom_log2 = 0;
+    } else if (!continuous && game_vars->lenia != NULL) {
+        lenia_to_grid(game_vars->lenia, game_vars->grid);
+        lenia_free(game_vars->lenia);
+        game_vars->lenia = NULL;
+    }
+}
+
+/** \brief Segedfuggveny a folytonos mod parametereinek beallitasahoz
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param params LeniaParams Az uj parameterek
+ * \return void
+ *
+ */
+static void Event_SetLeniaParams(GameVars *game_vars, LeniaParams params) {
+    if (game_vars->lenia == NULL || lenia_set_params(game_vars->lenia, params)) {
+        game_vars->settings.lenia = params;
+    }
+}
+
+/** \brief Segedfuggveny a veges grid topologiajanak beallitasahoz
+ *
+ * A torusz, a Klein-palack es a zart doboz csak veges gridben letezik, ezekre valtva a vegtelen vilag megszunik.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param topology Topology Az uj topologia
+ * \return void
+ *
+ */
+static void Event_SetTopology(GameVars *game_vars, Topology topology) {
+    if (topology != TOPOLOGY_PLANE) {
+        Event_SetWorldMode(game_vars, 0);
+    }
+    game_vars->settings.topology = topology;
+    cycle_reset(&game_vars->cycle);
+    if (game_vars->grid != NULL) {
+        grid_set_topology(game_vars->grid, topology);
+    }
+}
+
+/** \brief Segedfuggveny a szimulacio szabalyanak beallitasahoz
+ *
+ * A vegtelen vilag csak az eletjatekot ismeri, mas szabalyra valtva a szimulacio a gridben folytatodik.
+ * A Generations szabalyok haldoklo allapotainak a grid foglal helyet.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param rule Rule Az uj szabaly
+ * \return void
+ *
+ */
+static void Event_SetRule(GameVars *game_vars, Rule rule) {
+    game_vars->settings.rule = rule;
+    kernel_set_rule(rule);
+    cycle_reset(&game_vars->cycle);
+    if (!rule_is_life(rule)) {
+        Event_SetWorldMode(game_vars, 0);
+    }
+    if (game_vars->grid != NULL) {
+        grid_set_dying_states(game_vars->grid, rule.dying);
+    }
+}
+
+/** \brief Segedfuggveny a ciklusfigyeles beallitasahoz
+ *
+ * A grid csak bekapcsolt ciklusfigyeles mellett frissiti leptetes kozben a hash erteket.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param action CycleAction Mit tegyen a szimulacio egy ciklus megtalalasakor
+ * \return void
+ *
+ */
+static void Event_SetCycleAction(GameVars *game_vars, CycleAction action) {
+    game_vars->settings.cycle_action = action;
+    cycle_reset(&game_vars->cycle);
+    if (game_vars->grid != NULL) {
+        grid_set_hashing(game_vars->grid, action != CYCLE_OFF);
+    }
+}
+
+/** \brief Segedfuggveny egy cella beallitasahoz az eger pozicioja alapjan
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param x int Az eger x koordinataja pixelekben
+ * \param y int Az eger y koordinataja pixelekben
+ * \param state CellState A cella uj allapota
+ * \return void
+ *
+ */
+static void Event_SetCell(GameVars *game_vars, int x, int y, CellState state) {
+    // Kicsinyitett nezetben a pixel blokkjanak bal felso cellaja
+    const int zoom = game_vars->zoom_log2;
+    const Grid *grid = sim_view_grid(game_vars);
+    int64_t cell_x, cell_y;
+    x /= game_vars->settings.cell_size;
+    y /= game_vars->settings.cell_size;
+    cell_x = ((game_vars->view_x >> zoom) + x)*((int64_t)1 << zoom);
+    cell_y = ((game_vars->view_y >> zoom) + y)*((int64_t)1 << zoom);
+    if (game_vars->lenia == NULL && game_vars->world == NULL) {
+        if (zoom > 0 && (cell_x >= grid->size_x || cell_y >= grid->size_y)) {
+            // Kicsinyitett nezetben a grid utani pixelek nagyon messzi cellakat jelolnenek, ezekkel nem noveljuk a gridet
+            return;
+        }
+        if (sim_running(game_vars->sim)) {
+            // A futo szimulacio gridjet csak a szimulacios szal irhatja, a kovetkezo leptetes elott
+            sim_edit(game_vars->sim, (int)cell_x, (int)cell_y, state);
+            return;
+        }
+    }
+    cycle_reset(&game_vars->cycle);
+    if (game_vars->lenia != NULL) {
+        // Egy pont a folytonos mezoben azonnal elhalna: az ecset egy kernelnyi, veletlen ertekekkel teli kor
+        lenia_paint(game_vars->lenia, x, y, game_vars->settings.lenia.radius, state == dead);
+    } else if (game_vars->world != NULL) {
+        world_set(game_vars->world, cell_x, cell_y, (Cell) {
+            state, alive
+        });
+    } else if (state == alive) {
+        grid_set_alive(game_vars->grid, (int)cell_x, (int)cell_y);
+    } else {
+        grid_set_dead(game_vars->grid, (int)cell_x, (int)cell_y);
+    }
+}
+
+/** \brief Segedfuggveny a nezet (kamera) mozgatasahoz
+ *
+ * A vegtelen vilagban a nezet barhova mozoghat, a gridben a grid teruleten belul marad.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param dx int A mozgatas vizszintes iranya (-1, 0, +1)
+ * \param dy int A mozgatas fuggoleges iranya (-1, 0, +1)
+ * \return void
+ *
+ */
+static void Event_PanView(GameVars *game_vars, int dx, int dy) {
+    const int64_t cols = (int64_t)(game_vars->window_size.w/game_vars->settings.cell_size) << game_vars->zoom_log2;
+    const int64_t rows = (int64_t)(game_vars->window_size.h/game_vars->settings.cell_size) << game_vars->zoom_log2;
+    int64_t max_x, max_y;
+    if (game_vars->lenia != NULL) {
+        return;
+    }
+    // Egy lepes a kepernyo negyede
+    game_vars->view_x += dx*(cols/4 + 1);
+    game_vars->view_y += dy*(rows/4 + 1);
+    if (game_vars->world == NULL) {
+        // A grid jobb also sarka legfeljebb a kepernyo jobb also sarkaig mozdulhat
+        const Grid *grid = sim_view_grid(game_vars);
+        max_x = grid->size_x - cols > 0 ? grid->size_x - cols : 0;
+        max_y = grid->size_y - rows > 0 ? grid->size_y - rows : 0;
+        game_vars->view_x = game_vars->view_x < 0 ? 0 : (game_vars->view_x > max_x ? max_x : game_vars->view_x);
+        game_vars->view_y = game_vars->view_y < 0 ? 0 : (game_vars->view_y > max_y ? max_y : game_vars->view_y);
+    }
+}
+
+/** \brief Segedfuggveny a nagyitashoz es a kicsinyiteshez
+ *
+ * A cellameret 1 es 1024 pixel kozott duplazodik vagy felezodik; 1 pixeles cellaknal a tovabbi
+ * kicsinyites mar blokkokat mutat (egy pixel egy 2^zoom_log2 oldalu blokk surusege).
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param direction int 1: nagyitas, -1: kicsinyites
+ * \return void
+ *
+ */
+static void Event_Zoom(GameVars *game_vars, int direction) {
+    if (direction > 0) {
+        if (game_vars->zoom_log2 > 0) {
+            game_vars->zoom_log2--;
+        } else if (game_vars->settings.cell_size < CELL_MAX_SIZE) {
+            game_vars->settings.cell_size*=2;
+        }
+    } else {
+        if (game_vars->settings.cell_size > 1) {
+            game_vars->settings.cell_size/=2;
+        } else if (game_vars->lenia == NULL && game_vars->zoom_log2 < ZOOM_MAX_LOG2) {
+            game_vars->zoom_log2++;
+        }
+    }
+}
+
+/** \brief Segedfuggveny a HashLife ugrashoz: a gridet 2^jump_log2 generacioval lepteti
+ *
+ * A HashLife peldany az ugrasok kozott megmarad, igy a megjegyzett eredmenyek
+ * (peldaul egy periodikus minta reszletei) a kovetkezo ugrasnal is felhasznalhatoak.
+ * Ha a ciklusfigyelo mar megtalalta a grid periodusat, az ugras barmely szaballyal
+ * elvegezheto: eleg az ugras periodussal vett maradekanyi generaciot kiszamolni.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \return void
+ *
+ */
+static void Event_Jump(GameVars *game_vars) {
+    uint64_t lost, steps, i;
+    if (game_vars->lenia != NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Figyelmeztetes: a HashLife ugras a folytonos modban nem hasznalhato.\n");
+#endif // NDEBUG
+        return;
+    }
+    steps = (uint64_t)1 << game_vars->settings.jump_log2;
+    if (game_vars->world == NULL && game_vars->cycle.period > 0) {
+        for (i=0; i<steps % (uint64_t)game_vars->cycle.period; i++) {
+            grid_logic(game_vars->grid);
+        }
+        game_vars->generation += steps;
+        return;
+    }
+    if (!rule_is_life(kernel_rule())) {
+        // A HashLife alapesete az eletjatek szabalyat szamolja
+#ifdef NDEBUG
+        fprintf(stderr, "Figyelmeztetes: a HashLife ugras csak a B3/S23 szaballyal hasznalhato.\n");
+#endif // NDEBUG
+        return;
+    }
+    if (game_vars->hashlife == NULL) {
+        game_vars->hashlife = hashlife_new((size_t)game_vars->settings.hashlife_cache_mb << 20);
+        if (game_vars->hashlife == NULL) {
+            return;
+        }
+    }
+    if (game_vars->world != NULL) {
+        // A vegtelen vilag es a HashLife is 64 bites koordinatakat hasznal, itt nincs veszteseg
+        if (!hashlife_from_world(game_vars->hashlife, game_vars->world) || !hashlife_step(game_vars->hashlife, game_vars->settings.jump_log2)) {
+#ifdef NDEBUG
+            fprintf(stderr, "Figyelmeztetes: a HashLife ugras nem sikerult, a vilag valtozatlan.\n");
+#endif // NDEBUG
+            return;
+        }
+        hashlife_to_world(game_vars->hashlife, game_vars->world);
+        game_vars->generation += steps;
+        return;
+    }
+    if (game_vars->grid->topology != TOPOLOGY_PLANE) {
+        // A HashLife vegtelen sikon dolgozik, a grid szeleit nem tudja kovetni
+#ifdef NDEBUG
+        fprintf(stderr, "Figyelmeztetes: a HashLife ugras csak nyilt sikon hasznalhato.\n");
+#endif // NDEBUG
+        return;
+    }
+    if (!hashlife_from_grid(game_vars->hashlife, game_vars->grid) || !hashlife_step(game_vars->hashlife, game_vars->settings.jump_log2)) {
+#ifdef NDEBUG
+        fprintf(stderr, "Figyelmeztetes: a HashLife ugras nem sikerult, a grid valtozatlan.\n");
+#endif // NDEBUG
+        return;
+    }
+    lost = hashlife_to_grid(game_vars->hashlife, game_vars->grid);
+    game_vars->generation += steps;
+    // Az elozmenyek az ugras elotti generaciokhoz tartoznak
+    cycle_reset(&game_vars->cycle);
+    if (lost > 0) {
+#ifdef NDEBUG
+        fprintf(stderr, "Figyelmeztetes: %llu elo cella a griden kivulre kerult.\n", (unsigned long long)lost);
+#endif // NDEBUG
+    }
+}
+
+/** \brief Segedfuggveny a beallitasok menu kivalasztott elemenek modositasahoz
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param dir int A modositas iranya (+1 vagy -1)
+ * \return void
+ *
+ */
+static void Event_ChangeSetting(GameVars *game_vars, int dir) {
+    KernelType kernel;
+    LeniaParams params = game_vars->settings.lenia;
+    int preset, growth;
+    switch (game_vars->settings_item) {
+    case SETTINGS_THREADS:
+        if (game_vars->settings.thread_count+dir >= 0 && game_vars->settings.thread_count+dir <= THREAD_COUNT_MAX) {
+            Event_SetThreadCount(game_vars, game_vars->settings.thread_count+dir);
+        }
+        break;
+    case SETTINGS_KERNEL:
+        // A kovetkezo, ezen a gepen futtathato kernel
+        kernel = game_vars->settings.kernel;
+        do {
+            kernel = (kernel + KERNEL_COUNT + dir) % KERNEL_COUNT;
+        } while (!kernel_available(kernel));
+        game_vars->settings.kernel = kernel;
+        kernel_select(kernel);
+        break;
+    case SETTINGS_SPEED:
+        if (game_vars->settings.speed_log2+dir >= 0 && game_vars->settings.speed_log2+dir <= SPEED_MAX_LOG2) {
+            game_vars->settings.speed_log2 += dir;
+        }
+        break;
+    case SETTINGS_JUMP:
+        if (game_vars->settings.jump_log2+dir >= 0 && game_vars->settings.jump_log2+dir <= HASHLIFE_STEP_MAX) {
+            game_vars->settings.jump_log2 += dir;
+        }
+        break;
+    case SETTINGS_HASHLIFE_CACHE:
+        if (dir > 0 && game_vars->settings.hashlife_cache_mb < HASHLIFE_CACHE_MAX_MB) {
+            game_vars->settings.hashlife_cache_mb *= 2;
+        } else if (dir < 0 && game_vars->settings.hashlife_cache_mb > HASHLIFE_CACHE_MIN_MB) {
+            game_vars->settings.hashlife_cache_mb /= 2;
+        }
+        if (game_vars->hashlife != NULL) {
+            hashlife_set_cache_size(game_vars->hashlife, (size_t)game_vars->settings.hashlife_cache_mb << 20);
+        }
+        break;
+    case SETTINGS_WORLD:
+        if (!game_vars->settings.unbounded) {
+            Event_SetLeniaMode(game_vars, 0);
+        }
+        Event_SetWorldMode(game_vars, !game_vars->settings.unbounded);
+        break;
+    case SETTINGS_TOPOLOGY:
+        Event_SetTopology(game_vars, (game_vars->settings.topology + TOPOLOGY_COUNT + dir) % TOPOLOGY_COUNT);
+        break;
+    case SETTINGS_RULE:
+        // Az elore megadott szabalyok kozott lepked; listan kivuli szabalyrol az elsore (vagy az utolsora) ugrik
+        preset = rule_preset_index(game_vars->settings.rule);
+        if (preset < 0) {
+            preset = dir > 0 ? -1 : 0;
+        }
+        Event_SetRule(game_vars, rule_preset((preset + rule_preset_count() + dir) % rule_preset_count()));
+        break;
+    case SETTINGS_LENIA:
+        // Ki, majd a novekedesi fuggvenyek sorban
+        growth = game_vars->settings.continuous ? (int)params.growth + 1 : 0;
+        growth = (growth + LENIA_GROWTH_COUNT + 1 + dir) % (LENIA_GROWTH_COUNT + 1);
+        if (growth == 0) {
+            Event_SetLeniaMode(game_vars, 0);
+        } else {
+            params.growth = growth - 1;
+            Event_SetLeniaParams(game_vars, params);
+            Event_SetLeniaMode(game_vars, 1);
+        }
+        break;
+    case SETTINGS_LENIA_MU:
+        if (params.mu + dir*LENIA_MU_STEP > 0 && params.mu + dir*LENIA_MU_STEP <= LENIA_MU_MAX) {
+            params.mu += dir*LENIA_MU_STEP;
+            Event_SetLeniaParams(game_vars, params);
+        }
+        break;
+    case SETTINGS_LENIA_SIGMA:
+        if (params.sigma + dir*LENIA_SIGMA_STEP > 0 && params.sigma + dir*LENIA_SIGMA_STEP <= LENIA_SIGMA_MAX) {
+            params.sigma += dir*LENIA_SIGMA_STEP;
+            Event_SetLeniaParams(game_vars, params);
+        }
+        break;
+    case SETTINGS_CYCLE:
+        Event_SetCycleAction(game_vars, (game_vars->settings.cycle_action + CYCLE_ACTION_COUNT + dir) % CYCLE_ACTION_COUNT);
+        break;
+    case SETTINGS_CYCLE_PERIOD:
+        if (game_vars->settings.cycle_period_max+dir >= 1 && game_vars->settings.cycle_period_max+dir <= CYCLE_HISTORY) {
+            game_vars->settings.cycle_period_max += dir;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
 GameEvent events_parse(SDL_Event *ev) {
     switch (ev->type) {
     case SDL_KEYDOWN:
@@ -48,6 +521,16 @@ GameEvent events_parse(SDL_Event *ev) {
             return EV_KEY_RIGHT;
         case SDLK_q:
             return EV_KEY_Q;
+        case SDLK_j:
+            return EV_KEY_J;
+        case SDLK_w:
+            return EV_KEY_W;
+        case SDLK_a:
+            return EV_KEY_A;
+        case SDLK_s:
+            return EV_KEY_S;
+        case SDLK_d:
+            return EV_KEY_D;
         default:
             return EV_INVALID;
         }
@@ -143,7 +626,18 @@ GameState events_menu_load(GameVars *game_vars) {
             if (game_vars->grid == NULL) {
                 game_vars->grid = grid_new(-1, -1);
                 grid_init(game_vars->grid);
+                game_vars->grid->pool = game_vars->thread_pool;
+                Event_SetWorldMode(game_vars, game_vars->settings.unbounded);
                 file_load_grid(SAVE_FILE_NAME, game_vars);
+                // A mentes a szabalyt is tartalmazhatja
+                Event_SetRule(game_vars, game_vars->settings.rule);
+                // A betoltes meg novelheti a gridet, a topologia csak utana rogzitheti a meretet
+                Event_SetTopology(game_vars, game_vars->settings.topology);
+                Event_SetLeniaMode(game_vars, game_vars->settings.continuous);
+                Event_SetCycleAction(game_vars, game_vars->settings.cycle_action);
+                game_vars->generation = 0;
+                game_vars->view_x = 0;
+                game_vars->view_y = 0;
             }
             return STATE_SIM_PAUSED;
         case EV_RESIZE:
@@ -169,6 +663,15 @@ GameState events_menu_new(GameVars *game_vars) {
             if (game_vars->grid == NULL) {
                 game_vars->grid = grid_new(game_vars->grid_size.x, game_vars->grid_size.y);
                 grid_init(game_vars->grid);
+                game_vars->grid->pool = game_vars->thread_pool;
+                Event_SetWorldMode(game_vars, game_vars->settings.unbounded);
+                Event_SetRule(game_vars, game_vars->settings.rule);
+                Event_SetTopology(game_vars, game_vars->settings.topology);
+                Event_SetLeniaMode(game_vars, game_vars->settings.continuous);
+                Event_SetCycleAction(game_vars, game_vars->settings.cycle_action);
+                game_vars->generation = 0;
+                game_vars->view_x = 0;
+                game_vars->view_y = 0;
             }
             return STATE_SIM_PAUSED;
         case EV_KEY_UP:
@@ -209,6 +712,14 @@ GameState events_menu_sim_menu(GameVars *game_vars) {
                 grid_free(game_vars->grid);
                 game_vars->grid = NULL;
             }
+            if (game_vars->world != NULL) {
+                world_free(game_vars->world);
+                game_vars->world = NULL;
+            }
+            if (game_vars->lenia != NULL) {
+                lenia_free(game_vars->lenia);
+                game_vars->lenia = NULL;
+            }
             return STATE_MAIN_MENU;
         case EV_KEY_ESC:
             return STATE_SIM_PAUSED;
@@ -235,6 +746,27 @@ GameState events_menu_settings(GameVars *game_vars) {
             return STATE_EXIT;
         case EV_KEY_ESC:
             return STATE_SIM_MENU;
+        case EV_KEY_UP:
+            game_vars->settings_item = (game_vars->settings_item + SETTINGS_ITEM_COUNT - 1) % SETTINGS_ITEM_COUNT;
+            break;
+        case EV_KEY_DOWN:
+            game_vars->settings_item = (game_vars->settings_item + 1) % SETTINGS_ITEM_COUNT;
+            break;
+        case EV_KEY_RIGHT:
+            Event_ChangeSetting(game_vars, 1);
+            break;
+        case EV_KEY_LEFT:
+            Event_ChangeSetting(game_vars, -1);
+            break;
+        case EV_KEY_SPACE:
+            // A kernel soran az osszes futtathato kernel sebesseget megmerjuk
+            if (game_vars->settings_item == SETTINGS_KERNEL) {
+                KernelType kernel;
+                for (kernel=KERNEL_AUTO+1; kernel<KERNEL_COUNT; kernel++) {
+                    kernel_benchmark(kernel, KERNEL_BENCH_SIZE, KERNEL_BENCH_GENERATIONS);
+                }
+            }
+            break;
         case EV_RESIZE:
             Event_SetWindowSize(game_vars, ev.window.data1, ev.window.data2);
             break;
@@ -255,6 +787,10 @@ GameState events_menu_save(GameVars *game_vars) {
         case EV_KEY_ESC:
             return STATE_SIM_MENU;
         case EV_KEY_SPACE:
+            // A mentes binaris: a folytonos mezobol a kuszobolt kep kerul bele
+            if (game_vars->lenia != NULL) {
+                lenia_to_grid(game_vars->lenia, game_vars->grid);
+            }
             file_save_grid(SAVE_FILE_NAME, game_vars);
             game_vars->settings.save_modified = time(0);
             return STATE_SIM_SAVE_CONF;
@@ -299,39 +835,50 @@ GameState events_sim_paused(GameVars *game_vars) {
         case EV_KEY_SPACE:
             return STATE_SIM_RUNNING;
         case EV_KEY_RIGHT:
-            grid_logic(game_vars->grid);
+            Game_Step(game_vars, 1);
+            break;
+        case EV_KEY_J:
+            Event_Jump(game_vars);
             break;
         case EV_MOUSE_L_D:
             if (mouse_state == MOUSESTATE_LEFT_DOWN) {
-                grid_set_alive(game_vars->grid, ev.motion.x/game_vars->settings.cell_size, ev.motion.y/game_vars->settings.cell_size);
+                Event_SetCell(game_vars, ev.motion.x, ev.motion.y, alive);
             }
             break;
         case EV_MOUSE_R_D:
             if (mouse_state == MOUSESTATE_RIGHT_DOWN) {
-                grid_set_dead(game_vars->grid, ev.motion.x/game_vars->settings.cell_size, ev.motion.y/game_vars->settings.cell_size);
+                Event_SetCell(game_vars, ev.motion.x, ev.motion.y, dead);
             }
             break;
         case EV_MOUSE_MOTION:
             switch (mouse_state) {
             case MOUSESTATE_LEFT_DOWN:
-                grid_set_alive(game_vars->grid, ev.motion.x/game_vars->settings.cell_size, ev.motion.y/game_vars->settings.cell_size);
+                Event_SetCell(game_vars, ev.motion.x, ev.motion.y, alive);
                 break;
             case MOUSESTATE_RIGHT_DOWN:
-                grid_set_dead(game_vars->grid, ev.motion.x/game_vars->settings.cell_size, ev.motion.y/game_vars->settings.cell_size);
+                Event_SetCell(game_vars, ev.motion.x, ev.motion.y, dead);
                 break;
             default:
                 break;
             }
             break;
+        case EV_KEY_W:
+            Event_PanView(game_vars, 0, -1);
+            break;
+        case EV_KEY_A:
+            Event_PanView(game_vars, -1, 0);
+            break;
+        case EV_KEY_S:
+            Event_PanView(game_vars, 0, 1);
+            break;
+        case EV_KEY_D:
+            Event_PanView(game_vars, 1, 0);
+            break;
         case EV_MWHEELUP:
-            if (game_vars->settings.cell_size < 1024) {
-                game_vars->settings.cell_size*=2;
-            }
+            Event_Zoom(game_vars, 1);
             break;
         case EV_MWHEELDOWN:
-            if (game_vars->settings.cell_size > 1) {
-                game_vars->settings.cell_size/=2;
-            }
+            Event_Zoom(game_vars, -1);
             break;
         case EV_RESIZE:
             Event_SetWindowSize(game_vars, ev.window.data1, ev.window.data2);
@@ -355,32 +902,40 @@ GameState events_sim_running(GameVars *game_vars) {
         case EV_KEY_SPACE:
             return STATE_SIM_PAUSED;
         case EV_MOUSE_L_D:
-            grid_set_alive(game_vars->grid, ev.motion.x/game_vars->settings.cell_size, ev.motion.y/game_vars->settings.cell_size);
+            Event_SetCell(game_vars, ev.motion.x, ev.motion.y, alive);
             break;
         case EV_MOUSE_R_D:
-            grid_set_dead(game_vars->grid, ev.motion.x/game_vars->settings.cell_size, ev.motion.y/game_vars->settings.cell_size);
+            Event_SetCell(game_vars, ev.motion.x, ev.motion.y, dead);
             break;
         case EV_MOUSE_MOTION:
             switch (mouse_state) {
             case MOUSESTATE_LEFT_DOWN:
-                grid_set_alive(game_vars->grid, ev.motion.x/game_vars->settings.cell_size, ev.motion.y/game_vars->settings.cell_size);
+                Event_SetCell(game_vars, ev.motion.x, ev.motion.y, alive);
                 break;
             case MOUSESTATE_RIGHT_DOWN:
-                grid_set_dead(game_vars->grid, ev.motion.x/game_vars->settings.cell_size, ev.motion.y/game_vars->settings.cell_size);
+                Event_SetCell(game_vars, ev.motion.x, ev.motion.y, dead);
                 break;
             default:
                 break;
             }
             break;
+        case EV_KEY_W:
+            Event_PanView(game_vars, 0, -1);
+            break;
+        case EV_KEY_A:
+            Event_PanView(game_vars, -1, 0);
+            break;
+        case EV_KEY_S:
+            Event_PanView(game_vars, 0, 1);
+            break;
+        case EV_KEY_D:
+            Event_PanView(game_vars, 1, 0);
+            break;
         case EV_MWHEELUP:
-            if (game_vars->settings.cell_size < 1024) {
-                game_vars->settings.cell_size*=2;
-            }
+            Event_Zoom(game_vars, 1);
             break;
         case EV_MWHEELDOWN:
-            if (game_vars->settings.cell_size > 1) {
-                game_vars->settings.cell_size/=2;
-            }
+            Event_Zoom(game_vars, -1);
             break;
         case EV_RESIZE:
             Event_SetWindowSize(game_vars, ev.window.data1, ev.window.data2);
@@ -25,6 +25,11 @@ typedef enum t_game_event {
     EV_KEY_LEFT,         /**< Balra gomb megnyomasa */
     EV_KEY_RIGHT,        /**< Jobbra gomb megnyomasa */
     EV_KEY_Q,            /**< Q billentyu megnyomasa */
+    EV_KEY_J,            /**< J billentyu megnyomasa */
+    EV_KEY_W,            /**< W billentyu megnyomasa */
+    EV_KEY_A,            /**< A billentyu megnyomasa */
+    EV_KEY_S,            /**< S billentyu megnyomasa */
+    EV_KEY_D,            /**< D billentyu megnyomasa */
     EV_MWHEELUP,         /**< Egergorgo felfele gorgetese */
     EV_MWHEELDOWN,       /**< Egergorgo lefele gorgetese */
     EV_RESIZE,           /**< Az ablak atmeretezese */
@@ -10,6 +10,9 @@
 #include <time.h>
 #include "gol_main.h"
 #include "gol_grid.h"
+#include "gol_world.h"
+#include "gol_kernel.h"
+#include "gol_rule.h"
 
 int file_load_settings(const char *filename, GameVars *game_vars) {
     FILE *fp;
@@ -40,11 +43,30 @@ void file_load_grid(const char *filename, GameVars *game_vars) {
 #endif // NDEBUG
         return;
     }
-    int i,j,state;
-    while (fscanf(fp, "%d;%d;%d", &i, &j, &state) != EOF) {
-        grid_set(game_vars->grid, i, j, (Cell) {
-            state?alive:dead, dead, alive
-        });
+    long long i,j;
+    int state;
+    char rule_text[RULE_TEXT_LENGTH];
+    Rule rule;
+    // Az opcionalis elso sor a szabaly ("rule;B3/S23"); a regi mentesekben nincs ilyen sor
+    if (fscanf(fp, " rule;%79s", rule_text) == 1 && rule_parse(rule_text, &rule)) {
+        game_vars->settings.rule = rule;
+        kernel_set_rule(rule);
+        // A haldoklo cellak betoltesehez a gridnek mar ismernie kell az allapotok szamat
+        if (game_vars->grid != NULL) {
+            grid_set_dying_states(game_vars->grid, rule.dying);
+        }
+    }
+    // A vegtelen vilag mentese negativ koordinatakat is tartalmazhat, ezek a gridbe nem toltodnek be
+    while (fscanf(fp, "%lld;%lld;%d", &i, &j, &state) == 3) {
+        // A 2, 3, ... allapotok a Generations szabalyok haldoklo cellai
+        Cell cell = (Cell) {
+            state > 0 ? (CellState)state : dead, alive
+        };
+        if (game_vars->world != NULL) {
+            world_set(game_vars->world, i, j, cell);
+        } else if (i >= 0 && j >= 0 && i < GRID_COORD_LIMIT && j < GRID_COORD_LIMIT) {
+            grid_set(game_vars->grid, (int)i, (int)j, cell);
+        }
     }
     fclose(fp);
 }
@@ -62,8 +84,34 @@ void file_save_settings(const char *filename, GameVars *game_vars) {
     fclose(fp);
 }
 
+/** \brief A vegtelen vilag cellainak mentese a grid mentesevel azonos formatumban
+ *
+ * \param fp FILE* A megnyitott fajl
+ * \param world const World* A vilagra mutato pointer
+ * \return void
+ *
+ */
+static void file_save_world(FILE *fp, const World *world) {
+    size_t i;
+    int r, bit;
+    const WorldChunk *chunk;
+    for (i=0; i<world->table_size; i++) {
+        for (chunk=world->table[i]; chunk!=NULL; chunk=chunk->next) {
+            for (r=0; r<WORLD_CHUNK_SIZE; r++) {
+                uint64_t bits = chunk->cells[r] | chunk->was_alive[r];
+                for (bit=0; bits!=0; bit++, bits>>=1) {
+                    if (bits & 1) {
+                        fprintf(fp, "%lld;%lld;%d\n", (long long)(chunk->cx*WORLD_CHUNK_SIZE + bit), (long long)(chunk->cy*WORLD_CHUNK_SIZE + r), (int)((chunk->cells[r] >> bit) & 1));
+                    }
+                }
+            }
+        }
+    }
+}
+
 void file_save_grid(const char *filename, GameVars *game_vars) {
     FILE *fp;
+    char rule_text[RULE_TEXT_LENGTH];
     fp = fopen(filename, "wt");
     if (fp == NULL) {
 #ifdef NDEBUG
@@ -71,6 +119,13 @@ void file_save_grid(const char *filename, GameVars *game_vars) {
 #endif // NDEBUG
         return;
     }
+    rule_format(game_vars->settings.rule, rule_text);
+    fprintf(fp, "rule;%s\n", rule_text);
+    if (game_vars->world != NULL) {
+        file_save_world(fp, game_vars->world);
+        fclose(fp);
+        return;
+    }
     int i,j;
     Cell tmpcell;
     // A mentes a jobb szelso cellatol kezdodik,
@@ -79,7 +134,7 @@ void file_save_grid(const char *filename, GameVars *game_vars) {
     for (i=game_vars->grid->size_x-1; i>=0; i--) {
         for (j=game_vars->grid->size_y-1; j>=0; j--) {
             tmpcell = grid_get(game_vars->grid, i, j);
-            if (tmpcell.state == alive || tmpcell.was_alive == alive) {
+            if (tmpcell.state != dead || tmpcell.was_alive == alive) {
                 fprintf(fp, "%d;%d;%d\n", i, j, tmpcell.state);
             }
         }
@@ -7,11 +7,148 @@
  *
  **********************************/
 #include <stdlib.h>
+#include <string.h>
 #include "gol_main.h"
 #include "gol_font.h"
 
+static const int FONT_ATLAS_WIDTH = 512;
+// A glifatlaszba az ASCII karaktereken kivul a magyar ekezetes betuk kerulnek
+static const char FONT_ATLAS_EXTRA[] = "áéíóöőúüűÁÉÍÓÖŐÚÜŰ";
+
+/** \brief Visszaadja egy szoveg hash erteket (FNV-1a)
+ *
+ * \param str const char* a szoveg
+ * \return uint32_t a hash ertek
+ *
+ */
+static uint32_t Game_FontHash(const char *str) {
+    uint32_t hash = 2166136261u;
+    for (; *str != '\0'; str++) {
+        hash = (hash ^ (unsigned char)*str) * 16777619u;
+    }
+    return hash;
+}
+
+/** \brief Kiolvassa egy UTF-8 szoveg kovetkezo karakteret
+ *
+ * \param str const char** a szovegre mutato pointer, a karakter utanra lep
+ * \return Uint16 a karakter kodja (UCS-2; hibas vagy 16 bitnel nagyobb kod eseten 0xFFFF)
+ *
+ */
+static Uint16 Game_FontNextChar(const char **str) {
+    const unsigned char *s = (const unsigned char *)*str;
+    Uint16 ch = 0xFFFF;
+    if (s[0] < 0x80) {
+        ch = s[0];
+        *str += 1;
+    } else if ((s[0] & 0xE0) == 0xC0 && (s[1] & 0xC0) == 0x80) {
+        ch = (Uint16)((s[0] & 0x1F) << 6 | (s[1] & 0x3F));
+        *str += 2;
+    } else if ((s[0] & 0xF0) == 0xE0 && (s[1] & 0xC0) == 0x80 && (s[2] & 0xC0) == 0x80) {
+        ch = (Uint16)((s[0] & 0x0F) << 12 | (s[1] & 0x3F) << 6 | (s[2] & 0x3F));
+        *str += 3;
+    } else {
+        *str += 1;
+    }
+    return ch;
+}
+
+/** \brief Megkeresi egy karakter sorszamat a glifatlaszban
+ *
+ * \param gamefont const GameFont* A fontra mutato pointer
+ * \param ch Uint16 a karakter kodja
+ * \return int a karakter sorszama (-1, ha nincs az atlaszban)
+ *
+ */
+static int Game_FontGlyph(const GameFont *gamefont, Uint16 ch) {
+    int i;
+    if (ch >= 32 && ch < 127 && ch - 32 < gamefont->glyph_count) {
+        return ch - 32;
+    }
+    for (i=127-32; i<gamefont->glyph_count; i++) {
+        if (gamefont->glyphs[i].ch == ch) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/** \brief Kirajzolja a glifatlaszt: karakterenkent egy teljes sormagassagu kep, soronkent FONT_ATLAS_WIDTH szelessegig
+ *
+ * Hiba eseten az atlasz nem jon letre, a szovegek ekkor a gyorsitotaron at rajzolodnak.
+ *
+ * \param gamefont GameFont* A fontra mutato pointer
+ * \return void
+ *
+ */
+static void Game_BuildFontAtlas(GameFont *gamefont) {
+    SDL_Surface *glyphs[FONT_ATLAS_GLYPHS];
+    SDL_Surface *atlas = NULL;
+    const char *extra = FONT_ATLAS_EXTRA;
+    int count = 0, rendered = 0, x = 0, y = 0, row_h = 0, i;
+    // A karakterek kodjai
+    for (i=32; i<127; i++) {
+        gamefont->glyphs[count++].ch = (Uint16)i;
+    }
+    while (*extra != '\0' && count < FONT_ATLAS_GLYPHS) {
+        gamefont->glyphs[count++].ch = Game_FontNextChar(&extra);
+    }
+    // A karakterek kepei es helyuk az atlaszban
+    for (rendered=0; rendered<count; rendered++) {
+        Uint16 text[2] = {gamefont->glyphs[rendered].ch, 0};
+        SDL_Surface *glyph = TTF_RenderUNICODE_Blended(gamefont->font, text, gamefont->color);
+        if (glyph == NULL) {
+            break;
+        }
+        glyphs[rendered] = glyph;
+        if (TTF_GlyphMetrics(gamefont->font, text[0], NULL, NULL, NULL, NULL, &gamefont->glyphs[rendered].advance) != 0) {
+            rendered++;
+            break;
+        }
+        if (x + glyph->w > FONT_ATLAS_WIDTH) {
+            x = 0;
+            y += row_h;
+            row_h = 0;
+        }
+        gamefont->glyphs[rendered].rect = (SDL_Rect) {
+            x, y, glyph->w, glyph->h
+        };
+        x += glyph->w;
+        row_h = glyph->h > row_h ? glyph->h : row_h;
+    }
+    if (rendered < count) {
+#ifdef NDEBUG
+        fprintf(stderr, "SDL_ttf hiba a glifatlasz letrehozasanal: %s\n", TTF_GetError());
+#endif // NDEBUG
+    } else {
+        atlas = SDL_CreateRGBSurface(0, FONT_ATLAS_WIDTH, y + row_h, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    }
+    if (atlas != NULL) {
+        SDL_FillRect(atlas, NULL, 0);
+        for (i=0; i<count; i++) {
+            // Az atlaszba a karakter kepe atlatszosagostul, keveres nelkul masolodik
+            SDL_SetSurfaceBlendMode(glyphs[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(glyphs[i], NULL, atlas, &gamefont->glyphs[i].rect);
+        }
+        gamefont->atlas = SDL_CreateTextureFromSurface(gamefont->renderer, atlas);
+        SDL_FreeSurface(atlas);
+    }
+    if (gamefont->atlas != NULL) {
+        SDL_SetTextureBlendMode(gamefont->atlas, SDL_BLENDMODE_BLEND);
+        gamefont->glyph_count = count;
+    } else if (rendered == count) {
+#ifdef NDEBUG
+        fprintf(stderr, "SDL hiba a glifatlasz letrehozasanal: %s\n", SDL_GetError());
+#endif // NDEBUG
+    }
+    for (i=0; i<rendered; i++) {
+        SDL_FreeSurface(glyphs[i]);
+    }
+}
+
 GameFont *Game_LoadFont(SDL_Renderer *renderer, const char *path, const char *init_str, const SDL_Color color, const int text_size) {
     GameFont *gamefont = malloc(sizeof(GameFont));
+    int i;
     if (gamefont == NULL) {
 #ifdef NDEBUG
         fprintf(stderr, "Malloc hiba a font letrehozasa kozben!\n");
@@ -22,6 +159,18 @@ GameFont *Game_LoadFont(SDL_Renderer *renderer, const char *path, const char *in
     gamefont->renderer = renderer;
     gamefont->font = NULL;
     gamefont->texture = NULL;
+    gamefont->texture_size = (Vec2D) {
+        0, 0
+    };
+    for (i=0; i<FONT_CACHE_SIZE; i++) {
+        gamefont->cache[i].text = NULL;
+        gamefont->cache[i].texture = NULL;
+    }
+    gamefont->cache_clock = 0;
+    gamefont->atlas = NULL;
+    gamefont->glyph_count = 0;
+    gamefont->dynamic = 0;
+    gamefont->dynamic_length = 0;
 
     gamefont->font = TTF_OpenFont(path, text_size);
     if (gamefont->font == NULL) {
@@ -33,6 +182,7 @@ GameFont *Game_LoadFont(SDL_Renderer *renderer, const char *path, const char *in
     }
 
     gamefont->color = color;
+    Game_BuildFontAtlas(gamefont);
     if (!Game_SetFontText(gamefont, init_str)) {
         Game_FreeFont(gamefont);
         return NULL;
@@ -42,14 +192,46 @@ GameFont *Game_LoadFont(SDL_Renderer *renderer, const char *path, const char *in
 }
 
 void Game_RenderFont(GameFont *game_font, int x, int y) {
+    int i;
+    if (game_font->dynamic) {
+        // Karakterenkent az atlaszbol, a karakterek elorelepese szerint egymas melle
+        for (i=0; i<game_font->dynamic_length; i++) {
+            const FontGlyph *glyph = &game_font->glyphs[game_font->dynamic_glyphs[i]];
+            SDL_Rect glyphrect = {x, y, glyph->rect.w, glyph->rect.h};
+            SDL_RenderCopy(game_font->renderer, game_font->atlas, &glyph->rect, &glyphrect);
+            x += glyph->advance;
+        }
+        return;
+    }
     SDL_Rect fontrect = {x, y, game_font->texture_size.x, game_font->texture_size.y};
     SDL_RenderCopy(game_font->renderer, game_font->texture, NULL, &fontrect);
 }
 
 int Game_SetFontText(GameFont *gamefont, const char *str) {
-    if (gamefont->texture != NULL) {
-        SDL_DestroyTexture(gamefont->texture);
-        gamefont->texture = NULL;
+    const uint32_t hash = Game_FontHash(str);
+    FontCacheEntry *entry = NULL;
+    int i;
+    gamefont->dynamic = 0;
+    gamefont->cache_clock++;
+    for (i=0; i<FONT_CACHE_SIZE; i++) {
+        if (gamefont->cache[i].text != NULL && gamefont->cache[i].hash == hash && strcmp(gamefont->cache[i].text, str) == 0) {
+            // A szoveg mar ki van rajzolva
+            gamefont->cache[i].last_used = gamefont->cache_clock;
+            gamefont->texture = gamefont->cache[i].texture;
+            gamefont->texture_size = gamefont->cache[i].size;
+            return 1;
+        }
+        // Az uj szoveg helye: egy ures hely, vagy a legregebben hasznalt szoveg
+        if (entry == NULL || (entry->text != NULL && (gamefont->cache[i].text == NULL || gamefont->cache[i].last_used < entry->last_used))) {
+            entry = &gamefont->cache[i];
+        }
+    }
+    gamefont->texture = NULL;
+    if (entry->text != NULL) {
+        SDL_DestroyTexture(entry->texture);
+        free(entry->text);
+        entry->text = NULL;
+        entry->texture = NULL;
     }
 
     // Render font to texture
@@ -61,27 +243,70 @@ int Game_SetFontText(GameFont *gamefont, const char *str) {
 #endif // NDEBUG
         return 0;
     }
-    gamefont->texture = SDL_CreateTextureFromSurface(gamefont->renderer, surface);
-    if (gamefont->texture == NULL) {
+    entry->texture = SDL_CreateTextureFromSurface(gamefont->renderer, surface);
+    if (entry->texture == NULL) {
 #ifdef NDEBUG
         fprintf(stderr, "SDL hiba: %s\n", SDL_GetError());
 #endif // NDEBUG
+        SDL_FreeSurface(surface);
         return 0;
     }
-    gamefont->texture_size = (Vec2D) {
+    entry->size = (Vec2D) {
         surface->w, surface->h
     };
     SDL_FreeSurface(surface);
+    entry->text = malloc(strlen(str) + 1);
+    if (entry->text == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a szoveg gyorsitotarazasanal!\n");
+#endif // NDEBUG
+        SDL_DestroyTexture(entry->texture);
+        entry->texture = NULL;
+        return 0;
+    }
+    strcpy(entry->text, str);
+    entry->hash = hash;
+    entry->last_used = gamefont->cache_clock;
+    gamefont->texture = entry->texture;
+    gamefont->texture_size = entry->size;
+
+    return 1;
+}
 
+int Game_SetFontDynamicText(GameFont *gamefont, const char *str) {
+    const char *s = str;
+    int length = 0, width = 0, height = 0;
+    while (*s != '\0') {
+        int glyph = Game_FontGlyph(gamefont, Game_FontNextChar(&s));
+        if (glyph < 0 || length == FONT_DYNAMIC_LENGTH || gamefont->atlas == NULL) {
+            // Az atlaszban nem szereplo karakter (vagy tul hosszu szoveg): a szoveg egyben rajzolodik ki
+            return Game_SetFontText(gamefont, str);
+        }
+        gamefont->dynamic_glyphs[length++] = (uint8_t)glyph;
+        width += gamefont->glyphs[glyph].advance;
+        height = gamefont->glyphs[glyph].rect.h > height ? gamefont->glyphs[glyph].rect.h : height;
+    }
+    gamefont->dynamic = 1;
+    gamefont->dynamic_length = length;
+    gamefont->texture_size = (Vec2D) {
+        width, height
+    };
     return 1;
 }
 
 void Game_FreeFont(GameFont *gamefont) {
+    int i;
     if (gamefont->font != NULL) {
         TTF_CloseFont(gamefont->font);
     }
-    if (gamefont->texture != NULL) {
-        SDL_DestroyTexture(gamefont->texture);
+    for (i=0; i<FONT_CACHE_SIZE; i++) {
+        if (gamefont->cache[i].texture != NULL) {
+            SDL_DestroyTexture(gamefont->cache[i].texture);
+        }
+        free(gamefont->cache[i].text);
+    }
+    if (gamefont->atlas != NULL) {
+        SDL_DestroyTexture(gamefont->atlas);
     }
     free(gamefont);
 }
@@ -40,6 +40,17 @@ void Game_RenderFont(GameFont *game_font, int x, int y);
  */
 int Game_SetFontText(GameFont *gamefont, const char *str);
 
+/** \brief Beallitja egy font gyakran valtozo (pl. szamokat tartalmazo) szoveget, amit a glifatlaszbol rajzol ki
+ *
+ * Ha a szoveg az atlaszban nem szereplo karaktert tartalmaz, a Game_SetFontText-hez hasonloan egyben rajzolodik ki.
+ *
+ * \param gamefont GameFont* A fontra mutato pointer
+ * \param str const char* A beallitando szoveg (UTF-8 kodolassal)
+ * \return int A szoveg beallitasa sikeres-e
+ *
+ */
+int Game_SetFontDynamicText(GameFont *gamefont, const char *str);
+
 /** \brief Felszabaditja a fontot
  *
  * \param gamefont GameFont* A fontra mutato pointer
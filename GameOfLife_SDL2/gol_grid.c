@@ -7,12 +7,219 @@
  *
  **********************************/
 #include <stdlib.h>
+#include <string.h>
 #include "gol_main.h"
 #include "gol_grid.h"
+#include "gol_thread.h"
+#include "gol_kernel.h"
 
 static const int GRID_CAP_OVERHEAD = 32;
 const int GRID_SIZE_DEFAULT = 255;
 
+/** \brief Visszaadja a csempejelzok szamat
+ *
+ * \param grid const Grid* a gridre mutato pointer
+ * \return size_t a kapacitas szerinti csempek szama
+ *
+ */
+static size_t grid_tile_count(const Grid *grid) {
+    return (size_t)grid->tile_stride*((grid->cap_y + GRID_TILE_ROWS - 1) / GRID_TILE_ROWS);
+}
+
+/** \brief Visszaadja, hany bitsik kell a haldoklas fokainak tarolasahoz
+ *
+ * \param dying_states int a haldoklo allapotok szama
+ * \return int a bitsikok szama (a 0..dying_states ertekekhez)
+ *
+ */
+static int grid_age_planes_for(int dying_states) {
+    int planes = 0;
+    while ((1 << planes) <= dying_states) {
+        planes++;
+    }
+    return planes;
+}
+
+/** \brief Visszaadja egy szo hash erteket (a Zobrist-hash egy tagja)
+ *
+ * Az ures szo hash erteke 0, igy a grid novekedese es az ures teruletek nem valtoztatjak a hash-t.
+ * A hely a szo sorabol, oszlopabol es bitsikjabol all, igy a grid atmeretezese utan is ervenyes.
+ *
+ * \param place uint64_t a szo helye
+ * \param word uint64_t a szo tartalma
+ * \return uint64_t a hash ertek
+ *
+ */
+static inline uint64_t grid_word_hash(uint64_t place, uint64_t word) {
+    uint64_t h;
+    if (word == 0) {
+        return 0;
+    }
+    // A MurmurHash3 64 bites keveroje
+    h = word ^ place*0x9E3779B97F4A7C15ULL;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/** \brief Visszaadja egy szo helyet a hash szamara
+ *
+ * \param plane int a bitsik (0: cellak, 1..: a haldoklas fokainak bitsikjai)
+ * \param y int a sor
+ * \param word int a szo sorszama a sorban (keret nelkul)
+ * \return uint64_t a hely
+ *
+ */
+static inline uint64_t grid_word_place(int plane, int y, int word) {
+    return (uint64_t)plane << 56 | (uint64_t)y << 28 | (uint64_t)word;
+}
+
+/** \brief Visszaadja a sor egy szavanak a gridbe eso bitjeit
+ *
+ * Torusz es Klein-palack eseten az utolso szo grid utani bitjei a keret masolatat tartalmazzak,
+ * ezek nem resze az allapotnak.
+ *
+ * \param grid const Grid* a gridre mutato pointer
+ * \param word int a szo sorszama a sorban (keret nelkul)
+ * \return uint64_t a maszk
+ *
+ */
+static inline uint64_t grid_word_mask(const Grid *grid, int word) {
+    int bits = grid->size_x - word*GRID_WORD_BITS;
+    return bits >= GRID_WORD_BITS ? ~(uint64_t)0 : ((uint64_t)1 << bits) - 1;
+}
+
+/** \brief Az osszes csempet valtozottnak jeloli, igy a kovetkezo generacioban mindegyik szamolodik
+ * (es a mip piramis kovetkezo frissitese is mindegyiket ujraszamolja)
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \return void
+ *
+ */
+static void grid_wake_all(Grid *grid) {
+    memset(grid->tile_changed, 1, grid_tile_count(grid));
+    memset(grid->tile_dirty, 1, grid_tile_count(grid));
+}
+
+/** \brief Atmeretezi a grid tarolojat a megadott kapacitasra
+ *
+ * Egyetlen uj puffert foglal a harom bitsiknak es a haldoklas bitsikjainak, es a meglevo
+ * sorokat egy menetben atmasolja. A keret es az uj teruletek nullazva (halott cellakkal) jonnek letre.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param cap_x int az uj szelessegi kapacitas
+ * \param cap_y int az uj magassagi kapacitas
+ * \param age_planes int a haldoklas bitsikjainak uj szama (a tobbletet nem masolja at)
+ * \return int 1, ha sikerult; 0 hiba eseten
+ *
+ */
+static int grid_reserve(Grid *grid, int cap_x, int cap_y, int age_planes) {
+    // A sorok hosszat egesz csempeszelessegre kerekitjuk
+    int tile_cols = (grid_words(cap_x) + GRID_TILE_WORDS - 1) / GRID_TILE_WORDS;
+    int stride = tile_cols*GRID_TILE_WORDS + 2*GRID_HALO_WORDS;
+    size_t plane_words = (size_t)(cap_y+2)*stride;
+    int planes = 3 + age_planes;
+    uint64_t *buffer = malloc(sizeof(uint64_t)*plane_words*planes);
+    if (buffer == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a grid atmeretezesenel.\n");
+#endif // NDEBUG
+        return 0;
+    }
+    memset(buffer, 0, sizeof(uint64_t)*plane_words*planes);
+
+    // Csempenkent harom valtozasjelzo es egy hely a leptetendo csempek listajaban
+    int tile_rows = (cap_y + GRID_TILE_ROWS - 1) / GRID_TILE_ROWS;
+    size_t tiles = (size_t)tile_cols*tile_rows;
+    uint8_t *tile_changed = malloc(tiles);
+    uint8_t *tile_next_changed = malloc(tiles);
+    uint8_t *tile_dirty = malloc(tiles);
+    int *tile_list = malloc(sizeof(int)*tiles);
+    GridTileDelta *tile_delta = malloc(sizeof(GridTileDelta)*tiles);
+    GridTileStats *tile_stats = malloc(sizeof(GridTileStats)*tiles);
+    if (tile_changed == NULL || tile_next_changed == NULL || tile_dirty == NULL || tile_list == NULL || tile_delta == NULL || tile_stats == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a grid atmeretezesenel.\n");
+#endif // NDEBUG
+        free(tile_changed);
+        free(tile_next_changed);
+        free(tile_dirty);
+        free(tile_list);
+        free(tile_delta);
+        free(tile_stats);
+        free(buffer);
+        return 0;
+    }
+
+    if (grid->buffer != NULL) {
+        size_t old_plane_words = grid_plane_words(grid);
+        int copied = 3 + (age_planes < grid->age_planes ? age_planes : grid->age_planes);
+        // Kisebb kapacitasra (egy pillanatkep ujrafoglalasakor) csak az atfedo resz masolodik
+        int copy_rows = (cap_y < grid->cap_y ? cap_y : grid->cap_y) + 2;
+        int copy_words = stride < grid->stride ? stride : grid->stride;
+        int p, y;
+        for (p=0; p<copied; p++) {
+            const uint64_t *old_plane = p == 0 ? grid->cells : p == 1 ? grid->next_cells : p == 2 ? grid->was_alive
+                                        : grid->ages + (p-3)*old_plane_words;
+            if (stride == grid->stride && cap_y >= grid->cap_y) {
+                // Azonos sorhossz mellett a teljes bitsik egyben masolhato
+                memcpy(buffer + p*plane_words, old_plane, sizeof(uint64_t)*old_plane_words);
+            } else {
+                for (y=0; y<copy_rows; y++) {
+                    memcpy(buffer + p*plane_words + (size_t)y*stride, old_plane + (size_t)y*grid->stride, sizeof(uint64_t)*copy_words);
+                }
+            }
+        }
+        free(grid->buffer);
+        free(grid->tile_changed);
+        free(grid->tile_next_changed);
+        free(grid->tile_dirty);
+        free(grid->tile_list);
+        free(grid->tile_delta);
+        free(grid->tile_stats);
+    }
+
+    grid->buffer = buffer;
+    grid->cells = buffer;
+    grid->next_cells = buffer + plane_words;
+    grid->was_alive = buffer + 2*plane_words;
+    grid->ages = age_planes > 0 ? buffer + 3*plane_words : NULL;
+    grid->age_planes = age_planes;
+    grid->stride = stride;
+    grid->cap_x = (stride - 2*GRID_HALO_WORDS)*GRID_WORD_BITS;
+    grid->cap_y = cap_y;
+    grid->tile_stride = tile_cols;
+    grid->tile_changed = tile_changed;
+    grid->tile_next_changed = tile_next_changed;
+    grid->tile_dirty = tile_dirty;
+    grid->tile_list = tile_list;
+    grid->tile_delta = tile_delta;
+    grid->tile_stats = tile_stats;
+    // Az atmasolt csempek hatso puffere nem feltetlenul egyezik az elsovel, ezert mindent felebresztunk
+    grid_wake_all(grid);
+    // A csempek elrendezese megvaltozott, a csempenkenti adatokat ujra kell szamolni
+    grid->stats_valid = 0;
+    return 1;
+}
+
+/** \brief Kiszamolja az uj kapacitast ugy, hogy a novelesek koltsege amortizaltan allando legyen
+ *
+ * \param cap int a jelenlegi kapacitas
+ * \param size int a szukseges meret
+ * \return int az uj kapacitas
+ *
+ */
+static int grid_grow_cap(int cap, int size) {
+    int new_cap = cap + cap/2;
+    if (new_cap < size + GRID_CAP_OVERHEAD) {
+        new_cap = size + GRID_CAP_OVERHEAD;
+    }
+    return new_cap;
+}
+
 Grid *grid_new(const int size_startx, const int size_starty) {
     // Lefoglaljuk a grid valtozot
     Grid *grid = malloc(sizeof(Grid));
@@ -26,42 +233,59 @@ Grid *grid_new(const int size_startx, const int size_starty) {
 
     // Ha valamelyik meret parameter erteke kisebb mint nulla, akkor alapertelmezett mereture allitjuk a gridet
     if (size_startx < 0) {
-        grid->cap_x = GRID_SIZE_DEFAULT + GRID_CAP_OVERHEAD;
         grid->size_x = GRID_SIZE_DEFAULT;
 #ifdef NDEBUG
         fprintf(stderr, "Figyelmeztetes: Ervenytelen x meretet adtal meg a grid letrehozasanal! Alapertelmezes hasznalata...\n");
 #endif // NDEBUG
     } else {
-        grid->cap_x = size_startx + GRID_CAP_OVERHEAD;
         grid->size_x = size_startx;
     }
     if (size_starty < 0) {
-        grid->cap_y = GRID_SIZE_DEFAULT + GRID_CAP_OVERHEAD;
         grid->size_y = GRID_SIZE_DEFAULT;
 #ifdef NDEBUG
         fprintf(stderr, "Figyelmeztetes: Ervenytelen y meretet adtal meg a grid letrehozasanal! Alapertelmezes hasznalata...\n");
 #endif // NDEBUG
     } else {
-        grid->cap_y = size_starty + GRID_CAP_OVERHEAD;
         grid->size_y = size_starty;
     }
 
-    grid->cells = malloc(sizeof(Cell *)*grid->cap_x);
-    int i;
-    for (i=0; i<grid->cap_x; i++) {
-        grid->cells[i] = malloc(sizeof(Cell)*grid->cap_y);
+    grid->pool = NULL;
+    grid->buffer = NULL;
+    grid->tile_changed = NULL;
+    grid->tile_next_changed = NULL;
+    grid->tile_dirty = NULL;
+    grid->tile_list = NULL;
+    grid->tile_delta = NULL;
+    grid->tile_stats = NULL;
+    grid->stats_valid = 0;
+    grid->tile_active = 0;
+    grid->hash_enabled = 0;
+    grid->hash_valid = 0;
+    grid->hash = 0;
+    grid->topology = TOPOLOGY_PLANE;
+    grid->dying_states = 0;
+    grid->age_planes = 0;
+    grid->ages = NULL;
+    grid->stride = 0;
+    grid->cap_x = 0;
+    grid->cap_y = 0;
+    if (!grid_reserve(grid, grid->size_x + GRID_CAP_OVERHEAD, grid->size_y + GRID_CAP_OVERHEAD, 0)) {
+        free(grid);
+        return NULL;
     }
 
     return grid;
 }
 
 void grid_free(Grid *grid) {
-    // Fel kell szabaditani minden oszlopot, utana pedig a sort
-    int i;
-    for (i=0; i<grid->cap_x; i++) {
-        free(grid->cells[i]);
-    }
-    free(grid->cells);
+    // Az osszes bitsik egyetlen pufferben van
+    free(grid->buffer);
+    free(grid->tile_changed);
+    free(grid->tile_next_changed);
+    free(grid->tile_dirty);
+    free(grid->tile_list);
+    free(grid->tile_delta);
+    free(grid->tile_stats);
 
     // Felszabaditjuk a valtozot is
     free(grid);
@@ -69,70 +293,103 @@ void grid_free(Grid *grid) {
 
 void grid_init(Grid *grid) {
     // Grid kitoltese halott cellakkal
-    int i,j;
-    Cell new_cell = {dead, dead, dead};
-    for (i=0; i<grid->size_x; i++) {
-        for (j=0; j<grid->size_y; j++) {
-            grid->cells[i][j] = new_cell;
+    memset(grid->buffer, 0, sizeof(uint64_t)*grid_plane_words(grid)*(3 + grid->age_planes));
+    grid_wake_all(grid);
+    grid->hash_valid = 0;
+    grid->stats_valid = 0;
+}
+
+void grid_clear_cells(Grid *grid) {
+    // Csak az elso puffer torlodik, a hatso puffer tartalmat az osszes csempe felebresztese ervenyteleniti
+    memset(grid->cells, 0, sizeof(uint64_t)*grid_plane_words(grid));
+    if (grid->ages != NULL) {
+        memset(grid->ages, 0, sizeof(uint64_t)*grid_plane_words(grid)*grid->age_planes);
+    }
+    grid_wake_all(grid);
+    grid->hash_valid = 0;
+    grid->stats_valid = 0;
+}
+
+int grid_set_dying_states(Grid *grid, int dying_states) {
+    int age_planes = grid_age_planes_for(dying_states);
+    int p;
+    if (age_planes != grid->age_planes && !grid_reserve(grid, grid->cap_x, grid->cap_y, age_planes)) {
+        return 0;
+    }
+    if (dying_states < grid->dying_states) {
+        // A megmaradt bitsikokon az uj szabalyban nem letezo fokok is lehetnek: a haldoklo cellak meghalnak
+        for (p=0; p<grid->age_planes; p++) {
+            memset(grid->ages + p*grid_plane_words(grid), 0, sizeof(uint64_t)*grid_plane_words(grid));
         }
     }
+    grid->dying_states = dying_states;
+    grid_wake_all(grid);
+    grid->hash_valid = 0;
+    return 1;
 }
 
 void grid_set_sizex(Grid *grid) {
-    int i, old_cap;
-    // A +2 amiatt kell, hogy a grid korben halott cellakbol alljon - elkerulve a tulindexeles vizsgalatat.
-    while (grid->cap_x < grid->size_x+2) {
-        old_cap = grid->cap_x;
-        grid->cap_x += GRID_CAP_OVERHEAD;
-        grid->cells = realloc(grid->cells, sizeof(Cell *)*grid->cap_x);
-        for (i=old_cap; i<grid->cap_x; i++) {
-            grid->cells[i] = malloc(sizeof(Cell)*grid->cap_y);
-        }
+    // A keret a tarolo resze, igy eleg a kapacitast a merethez igazitani
+    if (grid->cap_x < grid->size_x) {
+        grid_reserve(grid, grid_grow_cap(grid->cap_x, grid->size_x), grid->cap_y, grid->age_planes);
     }
+    // A regi szelen levo cellak eddig halott keret mellett alltak, ujra kell oket szamolni
+    grid_wake_all(grid);
+    grid->hash_valid = 0;
+    grid->stats_valid = 0;
 }
 
 void grid_set_sizey(Grid *grid) {
-    int i;
-    // A +2 amiatt kell, hogy a grid korben halott cellakbol alljon - elkerulve a tulindexeles vizsgalatat.
-    while (grid->cap_y < grid->size_y+2) {
-        grid->cap_y += GRID_CAP_OVERHEAD;
-        for (i=0; i<grid->cap_x; i++) {
-            grid->cells[i] = realloc(grid->cells[i], sizeof(Cell)*grid->cap_y);
-        }
+    // A keret a tarolo resze, igy eleg a kapacitast a merethez igazitani
+    if (grid->cap_y < grid->size_y) {
+        grid_reserve(grid, grid->cap_x, grid_grow_cap(grid->cap_y, grid->size_y), grid->age_planes);
     }
+    // A regi szelen levo cellak eddig halott keret mellett alltak, ujra kell oket szamolni
+    grid_wake_all(grid);
+    grid->hash_valid = 0;
+    grid->stats_valid = 0;
 }
 
 void grid_set(Grid *grid, const int x, const int y, const Cell cell) {
-    int i, j, old_size;
-    Cell new_cell = {dead, dead, dead};
-    // Ellenorizzuk le, hogy a tomb szelessege elegendo-e
-    // Bele kell fernie a keretnek is.
-    if (grid->size_x <= x+2) {
-        old_size = grid->size_x;
-        grid->size_x = x+2;
-        grid_set_sizex(grid);
-        // Az uj elemeket allitsuk alapertelmezett ertekure
-        for (i=old_size; i<=grid->size_x; i++) {
-            for (j=0; j<=grid->size_y; j++) {
-                grid->cells[i][j] = new_cell;
-            }
+    int tile;
+    if (grid->topology != TOPOLOGY_PLANE) {
+        // Allando meretu topologiaknal a gridet nem noveljuk, a kivul eso cella elveszik
+        if (x >= grid->size_x || y >= grid->size_y || x<0 || y<0) {
+#ifdef NDEBUG
+            fprintf(stderr, "Figyelmeztetes (grid_set): a cella kivul esik az allando meretu griden!\n");
+#endif // NDEBUG
+            return;
+        }
+    } else {
+        // Ellenorizzuk le, hogy a tomb szelessege elegendo-e
+        // A grid meretet a korabbi viselkedesnek megfeleloen egy cellanyi tartalekkal noveljuk.
+        // A bovitett reszek nullazott szavakbol allnak, igy azokat nem kell kulon halottra allitani.
+        if (grid->size_x <= x+2) {
+            grid->size_x = x+2;
+            grid_set_sizex(grid);
+        }
+        // Ellenorizzuk le, hogy a tomb magassaga elegendo-e
+        if (grid->size_y <= y+2) {
+            grid->size_y = y+2;
+            grid_set_sizey(grid);
         }
     }
-    // Ellenorizzuk le, hogy a tomb magassaga elegendo-e
-    // Bele kell fernie a keretnek is.
-    if (grid->size_y <= y+2) {
-        old_size = grid->size_y;
-        grid->size_y = y+2;
-        grid_set_sizey(grid);
-        // Az uj elemeket allitsuk alapertelmezett ertekure
-        for (i=0; i<grid->cap_x; i++) {
-            for (j=old_size; j<=grid->size_y; j++) {
-                grid->cells[i][j] = new_cell;
-            }
+    grid_bit_set(grid_row(grid, grid->cells, y), x, cell.state == alive);
+    grid_bit_set(grid_row(grid, grid->was_alive, y), x, cell.was_alive == alive);
+    if (grid->ages != NULL) {
+        // A haldoklas foka (a szabalyban nem letezo fok halott cellat jelent)
+        int age = cell.state >= dying && (int)cell.state - 1 <= grid->dying_states ? (int)cell.state - 1 : 0;
+        int p;
+        for (p=0; p<grid->age_planes; p++) {
+            grid_bit_set(grid_row(grid, grid->ages + p*grid_plane_words(grid), y), x, (age >> p) & 1);
         }
     }
-    // A keret miatt kell eltolni egyel a koordinatakat
-    grid->cells[x+1][y+1] = cell;
+    // A modositott csempe es a szomszedai a kovetkezo generacioban biztosan szamolodnak
+    tile = (y / GRID_TILE_ROWS)*grid->tile_stride + x / (GRID_TILE_WORDS*GRID_WORD_BITS);
+    grid->tile_changed[tile] = 1;
+    grid->tile_dirty[tile] = 1;
+    grid->hash_valid = 0;
+    grid->stats_valid = 0;
 }
 
 Cell grid_get(Grid *grid, const int x, const int y) {
@@ -141,54 +398,639 @@ Cell grid_get(Grid *grid, const int x, const int y) {
         fprintf(stderr, "Figyelmeztetes (grid_get): rossz indexet adtal meg! A fuggveny ures cellaval ter vissza!\n");
 #endif // NDEBUG
         return (Cell) {
-            dead, dead, dead
+            dead, dead
         };
     }
-    return grid->cells[x+1][y+1];
+    CellState state = grid_bit_get(grid_row(grid, grid->cells, y), x) ? alive : dead;
+    if (grid->ages != NULL && state == dead) {
+        int age = 0;
+        int p;
+        for (p=0; p<grid->age_planes; p++) {
+            age |= grid_bit_get(grid_row(grid, grid->ages + p*grid_plane_words(grid), y), x) << p;
+        }
+        if (age > 0) {
+            state = (CellState)(age + 1);
+        }
+    }
+    return (Cell) {
+        state,
+        grid_bit_get(grid_row(grid, grid->was_alive, y), x) ? alive : dead
+    };
+}
+
+/** \brief Megforditja egy szo bitjeinek sorrendjet
+ *
+ * \param bits uint64_t a szo
+ * \return uint64_t a tukrozott szo (a 0. bitbol 63. lesz)
+ *
+ */
+static uint64_t grid_reverse_bits(uint64_t bits) {
+    bits = ((bits >> 1) & 0x5555555555555555ULL) | ((bits & 0x5555555555555555ULL) << 1);
+    bits = ((bits >> 2) & 0x3333333333333333ULL) | ((bits & 0x3333333333333333ULL) << 2);
+    bits = ((bits >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((bits & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    bits = ((bits >> 8) & 0x00FF00FF00FF00FFULL) | ((bits & 0x00FF00FF00FF00FFULL) << 8);
+    bits = ((bits >> 16) & 0x0000FFFF0000FFFFULL) | ((bits & 0x0000FFFF0000FFFFULL) << 16);
+    return (bits >> 32) | (bits << 32);
+}
+
+/** \brief Tukrozve atmasol egy sort a [-1, size_x] cellatartomanyban: az x. cellaba a (size_x-1-x). kerul
+ *
+ * A forras sor keret oszlopainak mar a szemkozti szel masolatat kell tartalmazniuk.
+ *
+ * \param grid const Grid* a gridre mutato pointer
+ * \param dst uint64_t* a cel sor elso (keret) szava
+ * \param src const uint64_t* a forras sor elso (keret) szava
+ * \return void
+ *
+ */
+static void grid_row_mirror(const Grid *grid, uint64_t *dst, const uint64_t *src) {
+    const int halo_bits = GRID_HALO_WORDS*GRID_WORD_BITS;
+    const int last = (halo_bits + grid->size_x) / GRID_WORD_BITS;
+    int k;
+    for (k=0; k<grid->stride; k++) {
+        // A cel szo 64 bitje a forras [lo, lo+63] bitjeinek forditottja
+        int lo = 2*halo_bits + grid->size_x - GRID_WORD_BITS*(k+1);
+        int w = lo / GRID_WORD_BITS;
+        int s = lo % GRID_WORD_BITS;
+        uint64_t bits;
+        if (k > last) {
+            dst[k] = 0;
+            continue;
+        }
+        bits = src[w] >> s;
+        if (s) {
+            bits |= src[w+1] << (GRID_WORD_BITS - s);
+        }
+        dst[k] = grid_reverse_bits(bits);
+    }
+    // Csak a [-1, size_x] cellak ervenyesek, a tobbi bit a tukrozes melleke
+    dst[(halo_bits - 1) / GRID_WORD_BITS] &= ~(((uint64_t)1 << ((halo_bits - 1) % GRID_WORD_BITS)) - 1);
+    dst[last] &= ((uint64_t)2 << ((halo_bits + grid->size_x) % GRID_WORD_BITS)) - 1;
+}
+
+/** \brief Kitolti az elso puffer kereteit a topologia szerint (torusz, Klein-palack)
+ *
+ * Generacionkent egyszer fut le, igy a kernelek cellankenti modulo szamolas nelkul,
+ * a keretbol olvassak a szemkozti szel cellait.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \return void
+ *
+ */
+static void grid_halo_exchange(Grid *grid) {
+    uint64_t *row;
+    int y;
+    // Oszlopok: a -1. oszlopba az utolso, a size_x. oszlopba az elso oszlop kerul
+    for (y=0; y<grid->size_y; y++) {
+        row = grid_row(grid, grid->cells, y);
+        grid_bit_set(row, -1, grid_bit_get(row, grid->size_x-1));
+        grid_bit_set(row, grid->size_x, grid_bit_get(row, 0));
+    }
+    // Sorok (a sarkokkal egyutt): toruszon egyszeru masolas, Klein-palackon tukrozes
+    if (grid->topology == TOPOLOGY_KLEIN) {
+        grid_row_mirror(grid, grid_row(grid, grid->cells, -1), grid_row(grid, grid->cells, grid->size_y-1));
+        grid_row_mirror(grid, grid_row(grid, grid->cells, grid->size_y), grid_row(grid, grid->cells, 0));
+    } else {
+        memcpy(grid_row(grid, grid->cells, -1), grid_row(grid, grid->cells, grid->size_y-1), sizeof(uint64_t)*grid->stride);
+        memcpy(grid_row(grid, grid->cells, grid->size_y), grid_row(grid, grid->cells, 0), sizeof(uint64_t)*grid->stride);
+    }
+}
+
+/** \brief Halottra allitja mindket puffer kereteit (a nyilt sik es a zart doboz ezt feltetelezi)
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \return void
+ *
+ */
+static void grid_halo_clear(Grid *grid) {
+    uint64_t *planes[2] = {grid->cells, grid->next_cells};
+    int i, y;
+    for (i=0; i<2; i++) {
+        for (y=0; y<grid->size_y; y++) {
+            grid_bit_set(grid_row(grid, planes[i], y), -1, 0);
+            grid_bit_set(grid_row(grid, planes[i], y), grid->size_x, 0);
+        }
+        memset(grid_row(grid, planes[i], -1), 0, sizeof(uint64_t)*grid->stride);
+        memset(grid_row(grid, planes[i], grid->size_y), 0, sizeof(uint64_t)*grid->stride);
+    }
+}
+
+void grid_set_topology(Grid *grid, Topology topology) {
+    if (grid->topology == topology) {
+        return;
+    }
+    grid->topology = topology;
+    grid_halo_clear(grid);
+    // A szeleken levo cellak szomszedai megvaltoztak
+    grid_wake_all(grid);
+}
+
+/** \brief Visszaadja, hogy a grid hany csempeoszlopbol all
+ *
+ * \param grid const Grid* a gridre mutato pointer
+ * \return int a csempeoszlopok szama
+ *
+ */
+static int grid_tile_cols(const Grid *grid) {
+    return (grid_words(grid->size_x) + GRID_TILE_WORDS - 1) / GRID_TILE_WORDS;
+}
+
+/** \brief Visszaadja, hogy a csempe a szemkozti szelrol is olvas-e (torusz es Klein-palack eseten)
+ *
+ * A szelso csempek mindig ilyenek; nagy sugaru szabalynal a tul keskeny szelso csempe
+ * melletti csempe is a szel kozelebe eshet.
+ *
+ * \param grid const Grid* a gridre mutato pointer
+ * \param tx int a csempe oszlopa
+ * \param ty int a csempe sora
+ * \param reach int a szabaly kornyezetenek sugara
+ * \return int 1, ha a csempe valamelyik cellaja legfeljebb reach tavolsagra van a szeltol
+ *
+ */
+static int grid_tile_on_edge(const Grid *grid, int tx, int ty, int reach) {
+    const int tile_width = GRID_TILE_WORDS*GRID_WORD_BITS;
+    return tx*tile_width < reach || (tx+1)*tile_width > grid->size_x - reach
+           || ty*GRID_TILE_ROWS < reach || (ty+1)*GRID_TILE_ROWS > grid->size_y - reach;
+}
+
+/** \brief Visszaadja, hogy a csempet ebben a generacioban szamolni kell-e
+ *
+ * Egy csempe csak akkor valtozhat, ha o maga vagy valamelyik szomszedja valtozott az elozo generacioban.
+ * Torusz es Klein-palack eseten a szelso csempek a szemkozti szel csempeivel is szomszedosak,
+ * ezt a hivo az edge parameterrel jelzi.
+ *
+ * \param grid const Grid* a gridre mutato pointer
+ * \param tx int a csempe oszlopa
+ * \param ty int a csempe sora
+ * \param tile_cols int a csempeoszlopok szama
+ * \param tile_rows int a csempesorok szama
+ * \param edge int 1, ha a szel menti csempek kozul valamelyik valtozott
+ * \param reach int a szabaly kornyezetenek sugara
+ * \return int 1, ha a csempe ebren van
+ *
+ */
+static int grid_tile_awake(const Grid *grid, int tx, int ty, int tile_cols, int tile_rows, int edge, int reach) {
+    int i, j;
+    if (edge && grid_tile_on_edge(grid, tx, ty, reach)) {
+        return 1;
+    }
+    for (j=ty-1; j<=ty+1; j++) {
+        if (j < 0 || j >= tile_rows) {
+            continue;
+        }
+        for (i=tx-1; i<=tx+1; i++) {
+            if (i >= 0 && i < tile_cols && grid->tile_changed[j*grid->tile_stride + i]) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/** \brief Lepteti a csempe haldoklo cellait (Generations szabalyok)
+ *
+ * A kernel utan fut, szavankent: a haldoklo cellakban nem szulethet elet, a fokuk eggyel no
+ * (az utolso fok utan a cella halott lesz), az eppen meghalt elo cellak az elso fokra kerulnek.
+ * A szomszedokat nem olvassa, ezert a fokok helyben, egyetlen pufferben leptethetok.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param word_begin int a csempe elso szava (a sor elejetol, keret nelkul)
+ * \param word_end int a csempe utani elso szo
+ * \param row_begin int a csempe elso sora
+ * \param row_end int a csempe utani elso sor
+ * \param hash uint64_t* ha nem NULL, ehhez adodik (kizaro vaggyal) a fokok bitsikjainak hash-valtozasa
+ * \return int 1, ha haldoklo cella volt vagy lett a csempeben
+ *
+ */
+static int grid_age_step(Grid *grid, int word_begin, int word_end, int row_begin, int row_end, uint64_t *hash) {
+    const size_t plane_words = grid_plane_words(grid);
+    const int words = grid_words(grid->size_x);
+    const int last_age = grid->dying_states;
+    uint64_t changed = 0;
+    int i, r, p;
+    if (row_end > grid->size_y) {
+        row_end = grid->size_y;
+    }
+    if (word_end > words) {
+        word_end = words;
+    }
+    for (r=row_begin; r<row_end; r++) {
+        const uint64_t *cells = grid_row(grid, grid->cells, r) + GRID_HALO_WORDS;
+        uint64_t *next = grid_row(grid, grid->next_cells, r) + GRID_HALO_WORDS;
+        uint64_t *ages = grid_row(grid, grid->ages, r) + GRID_HALO_WORDS;
+        for (i=word_begin; i<word_end; i++) {
+            uint64_t dying_cells = 0;
+            uint64_t last = ~(uint64_t)0;
+            uint64_t carry, died;
+            for (p=0; p<grid->age_planes; p++) {
+                uint64_t age = ages[p*plane_words + i];
+                dying_cells |= age;
+                last &= (last_age >> p) & 1 ? age : ~age;
+            }
+            next[i] &= ~dying_cells;
+            died = cells[i] & ~next[i];
+            // Az utolso fokon levok nullazodnak, a tobbi haldoklo foka eggyel no
+            last &= dying_cells;
+            carry = dying_cells & ~last;
+            for (p=0; p<grid->age_planes; p++) {
+                uint64_t old = ages[p*plane_words + i];
+                uint64_t age = old & ~last;
+                uint64_t overflow = age & carry;
+                age ^= carry;
+                carry = overflow;
+                if (p == 0) {
+                    age |= died;
+                }
+                ages[p*plane_words + i] = age;
+                if (hash != NULL && age != old) {
+                    uint64_t place = grid_word_place(p + 1, r, i);
+                    uint64_t mask = grid_word_mask(grid, i);
+                    *hash ^= grid_word_hash(place, old & mask) ^ grid_word_hash(place, age & mask);
+                }
+            }
+            changed |= dying_cells | died;
+        }
+    }
+    return changed != 0;
+}
+
+/** \brief Visszaadja egy nem nulla szo legalacsonyabb beallitott bitjenek sorszamat
+ *
+ * \param bits uint64_t a szo
+ * \return int a bit sorszama
+ *
+ */
+static inline int grid_lowest_bit(uint64_t bits) {
+    return grid_popcount((bits & (~bits + 1)) - 1);
+}
+
+/** \brief Visszaadja egy nem nulla szo legmagasabb beallitott bitjenek sorszamat
+ *
+ * \param bits uint64_t a szo
+ * \return int a bit sorszama
+ *
+ */
+static inline int grid_highest_bit(uint64_t bits) {
+    bits |= bits >> 1;
+    bits |= bits >> 2;
+    bits |= bits >> 4;
+    bits |= bits >> 8;
+    bits |= bits >> 16;
+    bits |= bits >> 32;
+    return grid_popcount(bits) - 1;
+}
+
+/** \brief Megszamolja egy csempe elo cellait es kiszamolja a befoglalo teglalapjat, valamint a regi allapothoz kepesti valtozast
+ *
+ * A leptetes utan a kernel altal eppen megirt (a gyorsitotarban levo) szavakon fut. A szamlalas
+ * a kernel_count_tile fuggvennyel (a processzor SIMD utasitasaival) tortenik, a halalozasok
+ * a szuletesekbol es a csempe regi es uj cellaszamabol adodnak.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param tile int a csempe sorszama
+ * \param old_plane uint64_t* a regi allapot bitsikja
+ * \param new_plane uint64_t* az uj allapot bitsikja (ennek az adatai kerulnek a csempe adatai koze)
+ * \param delta GridTileDelta* ide adodnak a szuletesek, a halalozasok es (bekapcsolt hash eseten) a hash valtozasa;
+ * NULL eseten a csempe adatai elolrol szamolodnak
+ * \return void
+ *
+ */
+static void grid_tile_scan(Grid *grid, int tile, uint64_t *old_plane, uint64_t *new_plane, GridTileDelta *delta) {
+    const int words = grid_words(grid->size_x);
+    const int word_begin = (tile % grid->tile_stride)*GRID_TILE_WORDS;
+    const int row_begin = (tile / grid->tile_stride)*GRID_TILE_ROWS;
+    int row_end = row_begin + GRID_TILE_ROWS;
+    uint64_t masks[GRID_TILE_WORDS];
+    KernelTileCount count;
+    GridTileStats stats = {0, 0, 0, 0, 0};
+    int i, r;
+    if (row_end > grid->size_y) {
+        row_end = grid->size_y;
+    }
+    // A sorok hossza egesz csempeszelesseg, igy a csempe minden szava olvashato; a grid utani
+    // szavakat es bitjeket (torusz es Klein-palack eseten a keret masolatait) a maszk kiszuri
+    for (i=0; i<GRID_TILE_WORDS; i++) {
+        masks[i] = word_begin + i < words ? grid_word_mask(grid, word_begin + i) : 0;
+    }
+    kernel_count_tile(grid_row(grid, old_plane, row_begin) + GRID_HALO_WORDS + word_begin,
+                      grid_row(grid, new_plane, row_begin) + GRID_HALO_WORDS + word_begin,
+                      grid->stride, row_end - row_begin, masks, &count);
+    if (delta != NULL) {
+        // Szuletesek - halalozasok = az elo cellak szamanak valtozasa
+        delta->births += count.born;
+        delta->deaths += count.born + (int)grid->tile_stats[tile].population - count.alive;
+        if (grid->hash_enabled) {
+            for (r=row_begin; r<row_end; r++) {
+                const uint64_t *old_row = grid_row(grid, old_plane, r) + GRID_HALO_WORDS + word_begin;
+                const uint64_t *new_row = grid_row(grid, new_plane, r) + GRID_HALO_WORDS + word_begin;
+                for (i=0; i<GRID_TILE_WORDS; i++) {
+                    uint64_t old_word = old_row[i] & masks[i];
+                    uint64_t new_word = new_row[i] & masks[i];
+                    if (old_word != new_word) {
+                        uint64_t place = grid_word_place(0, r, word_begin + i);
+                        delta->hash ^= grid_word_hash(place, old_word) ^ grid_word_hash(place, new_word);
+                    }
+                }
+            }
+        }
+    }
+    stats.population = count.alive;
+    if (count.alive > 0) {
+        // Az elso es az utolso nem ures sor, illetve az oszlopok szerinti vagy elso es utolso nem nulla szava
+        stats.y_min = grid_lowest_bit(count.rows);
+        stats.y_max = grid_highest_bit(count.rows);
+        for (i=0; count.columns[i] == 0; i++) {
+        }
+        stats.x_min = i*GRID_WORD_BITS + grid_lowest_bit(count.columns[i]);
+        for (i=GRID_TILE_WORDS-1; count.columns[i] == 0; i--) {
+        }
+        stats.x_max = i*GRID_WORD_BITS + grid_highest_bit(count.columns[i]);
+    }
+    grid->tile_stats[tile] = stats;
+}
+
+/** \brief Osszegzi a csempek adataibol a grid elo cellainak szamat es befoglalo teglalapjat
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \return void
+ *
+ */
+static void grid_stats_reduce(Grid *grid) {
+    const int tile_width = GRID_TILE_WORDS*GRID_WORD_BITS;
+    int tile_cols = grid_tile_cols(grid);
+    int tile_rows = (grid->size_y + GRID_TILE_ROWS - 1) / GRID_TILE_ROWS;
+    GridStats *stats = &grid->stats;
+    int tx, ty;
+    stats->population = 0;
+    stats->x_min = grid->size_x;
+    stats->y_min = grid->size_y;
+    stats->x_max = -1;
+    stats->y_max = -1;
+    for (ty=0; ty<tile_rows; ty++) {
+        for (tx=0; tx<tile_cols; tx++) {
+            const GridTileStats *tile = &grid->tile_stats[ty*grid->tile_stride + tx];
+            if (tile->population == 0) {
+                continue;
+            }
+            stats->population += tile->population;
+            if (tx*tile_width + tile->x_min < stats->x_min) {
+                stats->x_min = tx*tile_width + tile->x_min;
+            }
+            if (tx*tile_width + tile->x_max > stats->x_max) {
+                stats->x_max = tx*tile_width + tile->x_max;
+            }
+            if (ty*GRID_TILE_ROWS + tile->y_min < stats->y_min) {
+                stats->y_min = ty*GRID_TILE_ROWS + tile->y_min;
+            }
+            if (ty*GRID_TILE_ROWS + tile->y_max > stats->y_max) {
+                stats->y_max = ty*GRID_TILE_ROWS + tile->y_max;
+            }
+        }
+    }
+}
+
+/** \brief Elolrol kiszamolja a csempek es a grid osszesitett adatait (szerkesztes utan)
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \return void
+ *
+ */
+static void grid_stats_full(Grid *grid) {
+    int tile_cols = grid_tile_cols(grid);
+    int tile_rows = (grid->size_y + GRID_TILE_ROWS - 1) / GRID_TILE_ROWS;
+    int tx, ty;
+    for (ty=0; ty<tile_rows; ty++) {
+        for (tx=0; tx<tile_cols; tx++) {
+            grid_tile_scan(grid, ty*grid->tile_stride + tx, grid->cells, grid->cells, NULL);
+        }
+    }
+    grid_stats_reduce(grid);
+    grid->stats.births = 0;
+    grid->stats.deaths = 0;
+    grid->stats_valid = 1;
+}
+
+GridStats grid_stats(Grid *grid) {
+    if (!grid->stats_valid) {
+        grid_stats_full(grid);
+    }
+    return grid->stats;
+}
+
+/** \brief Elolrol kiszamolja a grid hash erteket
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \return void
+ *
+ */
+static void grid_hash_full(Grid *grid) {
+    const size_t plane_words = grid_plane_words(grid);
+    const int words = grid_words(grid->size_x);
+    uint64_t hash = 0;
+    int i, r, p;
+    for (p=0; p<=grid->age_planes; p++) {
+        for (r=0; r<grid->size_y; r++) {
+            const uint64_t *row = p == 0 ? grid_row(grid, grid->cells, r) : grid_row(grid, grid->ages + (p - 1)*plane_words, r);
+            for (i=0; i<words; i++) {
+                hash ^= grid_word_hash(grid_word_place(p, r, i), row[GRID_HALO_WORDS + i] & grid_word_mask(grid, i));
+            }
+        }
+    }
+    grid->hash = hash;
+    grid->hash_valid = 1;
+}
+
+void grid_set_hashing(Grid *grid, int enabled) {
+    grid->hash_enabled = enabled;
+    grid->hash_valid = 0;
+}
+
+uint64_t grid_hash(Grid *grid) {
+    if (!grid->hash_valid) {
+        grid_hash_full(grid);
+    }
+    return grid->hash;
+}
+
+/** \brief A szalkeszlet altal vegrehajtott feladat: egy csempe leptetese
+ *
+ * \param data void* a gridre mutato pointer
+ * \param task int a feladat sorszama a leptetendo csempek listajaban
+ * \param worker int a vegrehajto szal sorszama
+ * \return void
+ *
+ */
+static void grid_logic_task(void *data, int task, int worker) {
+    Grid *grid = data;
+    int tile = grid->tile_list[task];
+    int tx = tile % grid->tile_stride;
+    int ty = tile / grid->tile_stride;
+    int changed;
+    GridTileDelta delta = {0, 0, 0};
+    (void)worker;
+    changed = kernel_step(grid, tx*GRID_TILE_WORDS, (tx+1)*GRID_TILE_WORDS, ty*GRID_TILE_ROWS, (ty+1)*GRID_TILE_ROWS);
+    if (grid->dying_states > 0) {
+        // A haldoklo cellak minden generacioban valtoznak, a csempe ebren marad
+        changed |= grid_age_step(grid, tx*GRID_TILE_WORDS, (tx+1)*GRID_TILE_WORDS, ty*GRID_TILE_ROWS, (ty+1)*GRID_TILE_ROWS,
+                                 grid->hash_enabled ? &delta.hash : NULL);
+    }
+    if (changed) {
+        // Csak a valtozott csempeket kell ujra szamolni es hash-elni, a tobbi adatai ervenyesek maradnak
+        grid_tile_scan(grid, tile, grid->cells, grid->next_cells, &delta);
+        grid->tile_dirty[tile] = 1;
+    }
+    grid->tile_delta[task] = delta;
+    grid->tile_next_changed[tile] = changed;
 }
 
 void grid_logic(Grid *grid) {
-    int i,j;
-    for (i=1; i<=grid->size_x; i++) {
-        for (j=1; j<=grid->size_y; j++) {
-            int count = 0;
-            // A szomszedvizsgalat egy "kibontott ciklus"
-            // Sormintanak tunik, de a sok cella miatt sokkal hatekonyabban fut le mint ket egymasba agyazott ciklus.
-            count+=grid->cells[i-1][j-1].state;
-            count+=grid->cells[i-1][j].state;
-            count+=grid->cells[i-1][j+1].state;
-            count+=grid->cells[i][j-1].state;
-            count+=grid->cells[i][j+1].state;
-            count+=grid->cells[i+1][j-1].state;
-            count+=grid->cells[i+1][j].state;
-            count+=grid->cells[i+1][j+1].state;
-
-            // Az eletjatek logikai feltetele a cellakra
-            if (count < 2 || count > 3) {
-                grid->cells[i][j].next_state = dead;
-            } else if (grid->cells[i][j].state == alive || count == 3) {
-                grid->cells[i][j].next_state = alive;
-                grid->cells[i][j].was_alive = alive;
+    // A gridet csempekre bontjuk, ezeket a szalkeszlet szalai dolgozzak fel.
+    // Minden csempe csak a sajat szavait irja a hatso pufferben, igy az eredmeny
+    // bitre megegyezik az egyszalu futaseval.
+    int tile_cols = grid_tile_cols(grid);
+    int tile_rows = (grid->size_y + GRID_TILE_ROWS - 1) / GRID_TILE_ROWS;
+    int tx, ty;
+    int edge = 0;
+    int reach = kernel_reach();
+    int i;
+    uint8_t *tmp_flags;
+    uint64_t *tmp;
+
+    // A hash-t es az osszesitett adatokat szerkesztes utan a leptetes elott kell elolrol szamolni,
+    // utana mar csak a valtozasok szamitanak
+    if (grid->hash_enabled && !grid->hash_valid) {
+        grid_hash_full(grid);
+    }
+    if (!grid->stats_valid) {
+        grid_stats_full(grid);
+    }
+
+    // Torusz es Klein-palack: a keretbe a szemkozti szel masolata kerul
+    if (grid->topology == TOPOLOGY_TORUS || grid->topology == TOPOLOGY_KLEIN) {
+        grid_halo_exchange(grid);
+        for (ty=0; ty<tile_rows && !edge; ty++) {
+            for (tx=0; tx<tile_cols; tx++) {
+                if (grid_tile_on_edge(grid, tx, ty, reach) && grid->tile_changed[ty*grid->tile_stride + tx]) {
+                    edge = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Az alvo csempek kimaradnak: ezekben a ket puffer tartalma megegyezik,
+    // igy a csere utan is a helyes (valtozatlan) allapot lesz lathato
+    grid->tile_active = 0;
+    for (ty=0; ty<tile_rows; ty++) {
+        for (tx=0; tx<tile_cols; tx++) {
+            if (grid_tile_awake(grid, tx, ty, tile_cols, tile_rows, edge, reach)) {
+                grid->tile_list[grid->tile_active++] = ty*grid->tile_stride + tx;
             }
         }
     }
-    for (i=1; i<=grid->size_x; i++) {
-        for (j=1; j<=grid->size_y; j++) {
-            grid->cells[i][j].state = grid->cells[i][j].next_state;
+    memset(grid->tile_next_changed, 0, grid_tile_count(grid));
+    thread_pool_run(grid->pool, grid_logic_task, grid, grid->tile_active);
+    grid->stats.births = 0;
+    grid->stats.deaths = 0;
+    for (i=0; i<grid->tile_active; i++) {
+        grid->hash ^= grid->tile_delta[i].hash;
+        grid->stats.births += grid->tile_delta[i].births;
+        grid->stats.deaths += grid->tile_delta[i].deaths;
+    }
+    if (!grid->hash_enabled) {
+        grid->hash_valid = 0;
+    }
+    grid_stats_reduce(grid);
+
+    // Az uj generacio a hatso pufferben van, eleg a ket pointert megcserelni
+    // (a keret bitjeit a kernelek nem irjak: nyilt sikon es dobozban mindig halottak maradnak,
+    // a tobbi topologianal a kovetkezo generacio elejen ujra kitoltodnek)
+    tmp = grid->cells;
+    grid->cells = grid->next_cells;
+    grid->next_cells = tmp;
+    tmp_flags = grid->tile_changed;
+    grid->tile_changed = grid->tile_next_changed;
+    grid->tile_next_changed = tmp_flags;
+}
+
+GridStepStats grid_step_n(Grid *grid, int generations) {
+    GridStepStats stats = {0, 0, 0};
+    // A generaciok kozott nincs rajzolas es esemenykezeles, a csempek adatai a gyorsitotarban maradnak
+    for (stats.generations=0; stats.generations<generations; stats.generations++) {
+        grid_logic(grid);
+        if (grid->tile_active == 0) {
+            // Egyetlen csempe sem ebredt fel: a grid elaludt, a hatralevo generaciok mar nem valtoztatnak rajta
+            stats.generations = generations;
+            break;
         }
+        stats.computed++;
+        stats.tiles += grid->tile_active;
     }
+    return stats;
 }
 
 void grid_set_alive(Grid *grid, int x, int y) {
     Cell tmpcell = (Cell) {
-        alive, dead, alive
+        alive, alive
     };
     grid_set(grid, x, y, tmpcell);
 }
 
 void grid_set_dead(Grid *grid, int x, int y) {
     Cell tmpcell = (Cell) {
-        dead, dead, alive
+        dead, alive
     };
     grid_set(grid, x, y, tmpcell);
 }
+
+int grid_copy_tiles(Grid *dst, Grid *src, const uint8_t *tiles) {
+    const int tile_cols = grid_tile_cols(src);
+    const int tile_rows = (src->size_y + GRID_TILE_ROWS - 1) / GRID_TILE_ROWS;
+    size_t plane_words;
+    int tx, ty, y, p;
+    if (dst->stride != src->stride || dst->cap_y != src->cap_y || dst->age_planes != src->age_planes) {
+        // Mas elrendezesben a csempek sorszama sem egyezik: a cel a forras kapacitasaval ujrafoglalodik
+        if (!grid_reserve(dst, src->cap_x, src->cap_y, src->age_planes)) {
+            return 0;
+        }
+        tiles = NULL;
+    }
+    plane_words = grid_plane_words(src);
+    if (tiles == NULL) {
+        // A teljes masolatba a meret utani (a forrasban mindig halott) teruletek is belekerulnek
+        memcpy(dst->cells, src->cells, sizeof(uint64_t)*plane_words);
+        memcpy(dst->was_alive, src->was_alive, sizeof(uint64_t)*plane_words);
+        if (src->ages != NULL) {
+            memcpy(dst->ages, src->ages, sizeof(uint64_t)*plane_words*src->age_planes);
+        }
+        memset(dst->tile_dirty, 1, grid_tile_count(dst));
+    } else {
+        for (ty=0; ty<tile_rows; ty++) {
+            const int y_end = (ty + 1)*GRID_TILE_ROWS < src->size_y ? (ty + 1)*GRID_TILE_ROWS : src->size_y;
+            for (tx=0; tx<tile_cols; tx++) {
+                const int tile = ty*src->tile_stride + tx;
+                const int word = GRID_HALO_WORDS + tx*GRID_TILE_WORDS;
+                if (!tiles[tile]) {
+                    continue;
+                }
+                for (y=ty*GRID_TILE_ROWS; y<y_end; y++) {
+                    memcpy(grid_row(dst, dst->cells, y) + word, grid_row(src, src->cells, y) + word, sizeof(uint64_t)*GRID_TILE_WORDS);
+                    memcpy(grid_row(dst, dst->was_alive, y) + word, grid_row(src, src->was_alive, y) + word, sizeof(uint64_t)*GRID_TILE_WORDS);
+                    for (p=0; p<src->age_planes; p++) {
+                        memcpy(grid_row(dst, dst->ages + p*plane_words, y) + word, grid_row(src, src->ages + p*plane_words, y) + word,
+                               sizeof(uint64_t)*GRID_TILE_WORDS);
+                    }
+                }
+                dst->tile_dirty[tile] = 1;
+            }
+        }
+    }
+    dst->size_x = src->size_x;
+    dst->size_y = src->size_y;
+    dst->dying_states = src->dying_states;
+    dst->topology = src->topology;
+    dst->stats = grid_stats(src);
+    dst->stats_valid = 1;
+    dst->hash_valid = 0;
+    return 1;
+}
@@ -11,6 +11,87 @@
 
 const int GRID_SIZE_DEFAULT;  /**< A grid alapertelmezett merete */
 
+#define GRID_WORD_BITS 64       /**< Egy tarolo szo bitjeinek szama */
+#define GRID_HALO_WORDS 1       /**< A sorok elejen es vegen levo halott keret szavak szama */
+#define GRID_TILE_WORDS 8       /**< Egy csempe szelessege szavakban */
+#define GRID_TILE_ROWS 32       /**< Egy csempe magassaga sorokban */
+#define GRID_COORD_LIMIT 16384  /**< A mas motorokbol (HashLife, vilag) a gridbe irhato legnagyobb koordinata */
+
+/** \brief Visszaadja, hogy a megadott szamu cella hany 64 bites szoban fer el
+ *
+ * \param cells int a cellak szama
+ * \return int a szavak szama
+ *
+ */
+static inline int grid_words(int cells) {
+    return (cells + GRID_WORD_BITS - 1) / GRID_WORD_BITS;
+}
+
+/** \brief Megszamolja egy szo beallitott bitjeit (elo cellait)
+ *
+ * \param bits uint64_t a szo
+ * \return int az 1-es bitek szama
+ *
+ */
+static inline int grid_popcount(uint64_t bits) {
+    bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+    bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((bits * 0x0101010101010101ULL) >> 56);
+}
+
+/** \brief Visszaadja egy bitsik meretet
+ *
+ * \param grid const Grid* a gridre mutato pointer
+ * \return size_t a bitsik szavainak szama (a keret sorokkal egyutt)
+ *
+ */
+static inline size_t grid_plane_words(const Grid *grid) {
+    return (size_t)(grid->cap_y+2)*grid->stride;
+}
+
+/** \brief Visszaadja egy bitsik adott soranak elso (keret) szavat
+ *
+ * \param grid const Grid* a gridre mutato pointer
+ * \param plane uint64_t* a bitsik
+ * \param y int a sor koordinataja (-1 es size_y a keret sorai)
+ * \return uint64_t* a sor elso szava
+ *
+ */
+static inline uint64_t *grid_row(const Grid *grid, uint64_t *plane, int y) {
+    return plane + (size_t)(y+1)*grid->stride;
+}
+
+/** \brief Visszaadja egy sor x. cellajanak bitjet
+ *
+ * \param row const uint64_t* a sor elso (keret) szava
+ * \param x int a cella koordinataja (-1 a bal oldali keret)
+ * \return int a bit erteke
+ *
+ */
+static inline int grid_bit_get(const uint64_t *row, int x) {
+    int pos = x + GRID_HALO_WORDS*GRID_WORD_BITS;
+    return (row[pos / GRID_WORD_BITS] >> (pos % GRID_WORD_BITS)) & 1;
+}
+
+/** \brief Beallitja egy sor x. cellajanak bitjet
+ *
+ * \param row uint64_t* a sor elso (keret) szava
+ * \param x int a cella koordinataja
+ * \param value int a bit uj erteke
+ * \return void
+ *
+ */
+static inline void grid_bit_set(uint64_t *row, int x, int value) {
+    int pos = x + GRID_HALO_WORDS*GRID_WORD_BITS;
+    uint64_t mask = (uint64_t)1 << (pos % GRID_WORD_BITS);
+    if (value) {
+        row[pos / GRID_WORD_BITS] |= mask;
+    } else {
+        row[pos / GRID_WORD_BITS] &= ~mask;
+    }
+}
+
 /** \brief Letrehoz egy uj gridet es visszaadja a ra mutato pointert
  *
  * \param size_startx const int a grid szelessege
@@ -36,6 +117,14 @@ void grid_free(Grid *grid);
  */
 void grid_init(Grid *grid);
 
+/** \brief Minden cellat halottra allit, a mar elt cellak nyilvantartasa megmarad
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \return void
+ *
+ */
+void grid_clear_cells(Grid *grid);
+
 /** \brief Leellenorzi, hogy a grid eleg szeles-e. Szukseg eseten noveli a szelesseget
  *
  * \param grid Grid* a gridre mutato pointer
@@ -52,7 +141,33 @@ void grid_set_sizex(Grid *grid);
  */
 void grid_set_sizey(Grid *grid);
 
+/** \brief Beallitja a grid topologiajat
+ *
+ * Nyilt sik eseten a grid_set a grid szelen tul elhelyezett cellakhoz megnoveli a gridet,
+ * a tobbi topologianal a grid merete allando, a rajta kivul eso cellak elhelyezese hatastalan.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param topology Topology az uj topologia
+ * \return void
+ *
+ */
+void grid_set_topology(Grid *grid, Topology topology);
+
+/** \brief Beallitja a haldoklo allapotok szamat (Generations szabalyok)
+ *
+ * A haldoklas fokai log2(dying_states+1) bitsikon tarolodnak, ezek szama szukseg szerint
+ * valtozik. Kevesebb allapotra valtva a haldoklo cellak halottak lesznek.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param dying_states int a haldoklo allapotok szama (0: ketallapotu grid)
+ * \return int 1, ha sikerult; 0 hiba eseten (ekkor a grid valtozatlan)
+ *
+ */
+int grid_set_dying_states(Grid *grid, int dying_states);
+
 /** \brief Beallitja a grid parameterkent megadott koordinatajan levo elemet a parameterben megadott ertekre
+ *
+ * Nyilt sik eseten a grid szukseg szerint megno.
  *
  * \param grid Grid* a gridre mutato pointer
  * \param x const int az elem x koordinataja
@@ -74,6 +189,8 @@ void grid_set(Grid *grid, const int x, const int y, const Cell cell);
 Cell grid_get(Grid *grid, const int x, const int y);
 
 /** \brief Vegigmegy a grid elemein es elvegzi a kovetkezo allapotok kiszamolasat
+ *
+ * A gridet csempekre bontja, es a grid szalkeszletevel parhuzamosan lepteti oket.
  *
  * \param grid Grid* a gridre mutato pointer
  * \return void
@@ -81,6 +198,50 @@ Cell grid_get(Grid *grid, const int x, const int y);
  */
 void grid_logic(Grid *grid);
 
+/** \brief Lepteti a gridet tobb generacioval
+ *
+ * A generaciok kozvetlenul egymas utan szamolodnak; ha a grid elalszik (egyik csempeje sem valtozik),
+ * a hatralevo generaciok szamolas nelkul telnek el.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param generations int a generaciok szama
+ * \return GridStepStats a leptetes osszesitett adatai
+ *
+ */
+GridStepStats grid_step_n(Grid *grid, int generations);
+
+/** \brief Be- vagy kikapcsolja a hash ertek leptetes kozbeni frissiteset
+ *
+ * Bekapcsolva a leptetes csak a valtozott csempek szavait hash-eli ujra.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param enabled int 1 eseten bekapcsolja
+ * \return void
+ *
+ */
+void grid_set_hashing(Grid *grid, int enabled);
+
+/** \brief Visszaadja a grid allapotanak (a cellak es a haldoklas fokainak) hash erteket
+ *
+ * Ha az ertek nem ervenyes (szerkesztes utan vagy kikapcsolt hash eseten), elolrol szamolja.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \return uint64_t a hash ertek
+ *
+ */
+uint64_t grid_hash(Grid *grid);
+
+/** \brief Visszaadja a grid elo cellainak szamat, az utolso generacio szuleteseit es halalozasait, valamint a befoglalo teglalapot
+ *
+ * Az adatok a leptetes mellekhatasakent, a valtozott csempekbol frissulnek; szerkesztes utan elolrol szamolodnak
+ * (ekkor a szuletesek es a halalozasok szama 0).
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \return GridStats az osszesitett adatok
+ *
+ */
+GridStats grid_stats(Grid *grid);
+
 /** \brief Beallitja a parameterkent megadott koordinatakon talalhato elem erteket elore
  *
  * \param grid Grid* a gridre mutato pointer
@@ -101,4 +262,18 @@ void grid_set_alive(Grid *grid, int x, int y);
  */
 void grid_set_dead(Grid *grid, int x, int y);
 
+/** \brief Atmasolja a grid megjelolt csempeit egy masik gridbe (a szimulacios szal pillanatkepeihez)
+ *
+ * A cel megkapja a forras meretet, haldoklo allapotait es osszesitett adatait. Ha a ket grid
+ * elrendezese (kapacitasa vagy a haldoklas bitsikjainak szama) elter, a cel ujrafoglalodik es minden
+ * csempe atmasolodik. Az atmasolt csempek a celban valtozottnak (tile_dirty) szamitanak.
+ *
+ * \param dst Grid* a cel grid
+ * \param src Grid* a forras grid
+ * \param tiles const uint8_t* csempenkent: masolando-e (a forras csempeinek sorszamaval; NULL eseten a teljes grid)
+ * \return int 1, ha sikerult; 0 hiba eseten
+ *
+ */
+int grid_copy_tiles(Grid *dst, Grid *src, const uint8_t *tiles);
+
 #endif // __GOL_GRID_H_INCLUDED__
@@ -0,0 +1,846 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_hashlife.c
+ * Description:     HashLife motor: hash-elt negyesfa, megjegyzett eredmenyekkel
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#include <stdlib.h>
+#include <string.h>
+#include "gol_main.h"
+#include "gol_grid.h"
+#include "gol_world.h"
+#include "gol_hashlife.h"
+
+#define HL_LEAF_LEVEL 3         /**< A levelek szintje: 8x8 cella egy 64 bites szoban */
+#define HL_MAX_LEVEL 60         /**< A legmagasabb szint (a koordinatak 64 bitesek) */
+#define HL_BLOCK_NODES 4096     /**< Egyszerre lefoglalt csomopontok szama */
+
+static const size_t HL_TABLE_INIT = 1 << 16;
+static const size_t HL_NODES_MIN = 1 << 14;
+
+/** \brief A negyesfa egy csomopontja
+ *
+ * A 3. szintu levelek 8x8 cellat tarolnak, az y. sor az y. bajt, az x. cella a bajt x. bitje.
+ * A magasabb szintu csomopontok negy, eggyel alacsonyabb szintu gyereket tartalmaznak.
+ * Az L szintu csomopont eredmenye a kozepso 2^(L-1) x 2^(L-1) resz 2^min(step_log2, L-2) generacio utan.
+ */
+typedef struct t_hl_node {
+    struct t_hl_node *nw;       /**< Bal felso negyed */
+    struct t_hl_node *ne;       /**< Jobb felso negyed */
+    struct t_hl_node *sw;       /**< Bal also negyed */
+    struct t_hl_node *se;       /**< Jobb also negyed */
+    struct t_hl_node *result;   /**< A megjegyzett eredmeny (NULL, ha meg nincs kiszamolva) */
+    struct t_hl_node *next;     /**< A kovetkezo csomopont a hash lancban vagy a szabad listaban */
+    uint64_t bits;              /**< A level cellai */
+    uint64_t population;        /**< Az elo cellak szama */
+    int level;                  /**< A csomopont szintje (oldalhossza 2^level) */
+    int mark;                   /**< Jelzo a szemetgyujteshez */
+} HlNode;
+
+/** \brief Csomopontok egyutt lefoglalt blokkja
+ */
+typedef struct t_hl_block {
+    struct t_hl_block *next;            /**< A kovetkezo blokk */
+    HlNode nodes[HL_BLOCK_NODES];       /**< A blokk csomopontjai */
+} HlBlock;
+
+struct t_hashlife {
+    HlNode **table;                     /**< A csomopontok hash tablaja */
+    size_t table_size;                  /**< A tabla merete (2 hatvanya) */
+    size_t node_count;                  /**< Az elo csomopontok szama */
+    size_t max_nodes;                   /**< A gyorsitotar merete csomopontokban */
+    HlBlock *blocks;                    /**< A lefoglalt blokkok */
+    HlNode *free_list;                  /**< A szabad csomopontok */
+    HlNode *empty[HL_MAX_LEVEL+1];      /**< Szintenkent az ures csomopont */
+    HlNode *root;                       /**< A minta gyokere */
+    int64_t origin_x;                   /**< A gyoker bal felso sarkanak x koordinataja */
+    int64_t origin_y;                   /**< A gyoker bal felso sarkanak y koordinataja */
+    int step_log2;                      /**< A megjegyzett eredmenyek ugrasanak kitevoje (-1: nincs) */
+    uint64_t generation;                /**< A betoltes ota eltelt generaciok */
+    int failed;                         /**< Foglalasi hiba tortent a lepes kozben */
+};
+
+/** \brief Hash ertek egy levelhez vagy negy gyerekhez
+ *
+ * \param bits uint64_t a level cellai (belso csomopontnal 0)
+ * \param nw const HlNode* a gyerekek (levelnel NULL)
+ * \param ne const HlNode*
+ * \param sw const HlNode*
+ * \param se const HlNode*
+ * \return uint64_t a hash ertek
+ *
+ */
+static uint64_t hl_hash(uint64_t bits, const HlNode *nw, const HlNode *ne, const HlNode *sw, const HlNode *se) {
+    uint64_t h = bits;
+    h = h*0x9E3779B97F4A7C15ULL + (uintptr_t)nw;
+    h = h*0x9E3779B97F4A7C15ULL + (uintptr_t)ne;
+    h = h*0x9E3779B97F4A7C15ULL + (uintptr_t)sw;
+    h = h*0x9E3779B97F4A7C15ULL + (uintptr_t)se;
+    return h ^ (h >> 29);
+}
+
+/** \brief Visszaadja egy meglevo csomopont hash erteket
+ *
+ * \param node const HlNode* a csomopont
+ * \return uint64_t a hash ertek
+ *
+ */
+static uint64_t hl_node_hash(const HlNode *node) {
+    return hl_hash(node->bits, node->nw, node->ne, node->sw, node->se);
+}
+
+/** \brief Ketszeresere noveli a hash tablat
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \return void
+ *
+ */
+static void hl_table_grow(HashLife *hl) {
+    size_t new_size = hl->table_size*2;
+    HlNode **table = malloc(sizeof(HlNode*)*new_size);
+    size_t i;
+    if (table == NULL) {
+        // Hosszabb lancokkal is mukodik tovabb
+        return;
+    }
+    memset(table, 0, sizeof(HlNode*)*new_size);
+    for (i=0; i<hl->table_size; i++) {
+        HlNode *node = hl->table[i];
+        while (node != NULL) {
+            HlNode *next = node->next;
+            size_t slot = hl_node_hash(node) & (new_size-1);
+            node->next = table[slot];
+            table[slot] = node;
+            node = next;
+        }
+    }
+    free(hl->table);
+    hl->table = table;
+    hl->table_size = new_size;
+}
+
+/** \brief Lefoglal egy uj csomopontot
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \return HlNode* a csomopont (Hiba eseten NULL)
+ *
+ */
+static HlNode *hl_alloc(HashLife *hl) {
+    HlNode *node;
+    if (hl->free_list == NULL) {
+        int i;
+        HlBlock *block = malloc(sizeof(HlBlock));
+        if (block == NULL) {
+#ifdef NDEBUG
+            fprintf(stderr, "Malloc hiba a HashLife csomopontok foglalasanal.\n");
+#endif // NDEBUG
+            return NULL;
+        }
+        block->next = hl->blocks;
+        hl->blocks = block;
+        for (i=0; i<HL_BLOCK_NODES; i++) {
+            block->nodes[i].next = hl->free_list;
+            hl->free_list = &block->nodes[i];
+        }
+    }
+    node = hl->free_list;
+    hl->free_list = node->next;
+    return node;
+}
+
+/** \brief Megkeresi vagy letrehozza a csomopontot
+ *
+ * Foglalasi hiba eseten az azonos szintu ures csomoponttal ter vissza, es jelzi a hibat.
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param level int a szint
+ * \param bits uint64_t a level cellai (belso csomopontnal 0)
+ * \param nw HlNode* a gyerekek (levelnel NULL)
+ * \param ne HlNode*
+ * \param sw HlNode*
+ * \param se HlNode*
+ * \return HlNode* a csomopont
+ *
+ */
+static HlNode *hl_find(HashLife *hl, int level, uint64_t bits, HlNode *nw, HlNode *ne, HlNode *sw, HlNode *se) {
+    size_t slot = hl_hash(bits, nw, ne, sw, se) & (hl->table_size-1);
+    HlNode *node;
+    for (node=hl->table[slot]; node!=NULL; node=node->next) {
+        if (node->level == level && node->bits == bits && node->nw == nw && node->ne == ne && node->sw == sw && node->se == se) {
+            return node;
+        }
+    }
+
+    node = hl_alloc(hl);
+    if (node == NULL) {
+        hl->failed = 1;
+        return hl->empty[level];
+    }
+    node->nw = nw;
+    node->ne = ne;
+    node->sw = sw;
+    node->se = se;
+    node->result = NULL;
+    node->bits = bits;
+    node->level = level;
+    node->mark = 0;
+    if (level == HL_LEAF_LEVEL) {
+        node->population = grid_popcount(bits);
+    } else {
+        node->population = nw->population + ne->population + sw->population + se->population;
+    }
+    node->next = hl->table[slot];
+    hl->table[slot] = node;
+    hl->node_count++;
+    if (hl->node_count > hl->table_size) {
+        hl_table_grow(hl);
+    }
+    return node;
+}
+
+/** \brief Visszaadja a megadott cellakat tartalmazo levelet
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param bits uint64_t a 8x8 cella
+ * \return HlNode* a level
+ *
+ */
+static HlNode *hl_leaf(HashLife *hl, uint64_t bits) {
+    return hl_find(hl, HL_LEAF_LEVEL, bits, NULL, NULL, NULL, NULL);
+}
+
+/** \brief Visszaadja a negy gyerekbol allo csomopontot
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param nw HlNode* a negyedek
+ * \param ne HlNode*
+ * \param sw HlNode*
+ * \param se HlNode*
+ * \return HlNode* a csomopont
+ *
+ */
+static HlNode *hl_node(HashLife *hl, HlNode *nw, HlNode *ne, HlNode *sw, HlNode *se) {
+    return hl_find(hl, nw->level+1, 0, nw, ne, sw, se);
+}
+
+/** \brief Egy 4. szintu csomopont cellait 16 darab 16 bites sorba rakja
+ *
+ * \param node const HlNode* a 4. szintu csomopont
+ * \param rows uint32_t* a 16 sor
+ * \return void
+ *
+ */
+static void hl_rows16(const HlNode *node, uint32_t *rows) {
+    int y;
+    for (y=0; y<8; y++) {
+        rows[y] = ((node->nw->bits >> (8*y)) & 0xFF) | ((node->ne->bits >> (8*y)) & 0xFF) << 8;
+        rows[y+8] = ((node->sw->bits >> (8*y)) & 0xFF) | ((node->se->bits >> (8*y)) & 0xFF) << 8;
+    }
+}
+
+/** \brief A 16 sorbol kivag egy 8x8-as levelet
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param rows const uint32_t* a 16 sor
+ * \param x0 int a kivagas bal szele
+ * \param y0 int a kivagas felso sora
+ * \return HlNode* a level
+ *
+ */
+static HlNode *hl_leaf_from_rows(HashLife *hl, const uint32_t *rows, int x0, int y0) {
+    uint64_t bits = 0;
+    int y;
+    for (y=0; y<8; y++) {
+        bits |= (uint64_t)((rows[y0+y] >> x0) & 0xFF) << (8*y);
+    }
+    return hl_leaf(hl, bits);
+}
+
+/** \brief Lepteti a 16x16-os teruletet egy generacioval (a teruleten kivul minden halott)
+ *
+ * Ugyanaz a bitszeletelt osszeadas, mint a grid kerneleiben: a kilenc cella osszege negy bitsikon.
+ *
+ * \param rows uint32_t* a 16 sor
+ * \return void
+ *
+ */
+static void hl_life_rows16(uint32_t *rows) {
+    uint32_t sum0[18], sum1[18];
+    uint32_t out[16];
+    int y;
+    sum0[0] = sum1[0] = sum0[17] = sum1[17] = 0;
+    for (y=0; y<16; y++) {
+        uint32_t left = rows[y] << 1, mid = rows[y], right = rows[y] >> 1;
+        sum0[y+1] = left ^ mid ^ right;
+        sum1[y+1] = (left & mid) | (right & (left ^ mid));
+    }
+    for (y=0; y<16; y++) {
+        uint32_t up0 = sum0[y], mid0 = sum0[y+1], down0 = sum0[y+2];
+        uint32_t up1 = sum1[y], mid1 = sum1[y+1], down1 = sum1[y+2];
+        uint32_t s0 = up0 ^ mid0 ^ down0;
+        uint32_t carry = (up0 & mid0) | (down0 & (up0 ^ mid0));
+        uint32_t half0 = up1 ^ mid1;
+        uint32_t half1 = down1 ^ carry;
+        uint32_t s1 = half0 ^ half1;
+        uint32_t s2 = (up1 & mid1) ^ (down1 & carry) ^ (half0 & half1);
+        uint32_t s3 = up1 & mid1 & down1 & carry;
+        uint32_t three = s0 & s1 & ~s2;
+        uint32_t four = ~s0 & ~s1 & s2 & rows[y];
+        out[y] = (three | four) & ~s3 & 0xFFFF;
+    }
+    memcpy(rows, out, sizeof(out));
+}
+
+/** \brief Visszaadja a csomopont kozepso, egy szinttel kisebb reszet (idolepes nelkul)
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param node HlNode* legalabb 4. szintu csomopont
+ * \return HlNode* a kozepso resz
+ *
+ */
+static HlNode *hl_center(HashLife *hl, HlNode *node) {
+    if (node->level == HL_LEAF_LEVEL+1) {
+        uint32_t rows[16];
+        hl_rows16(node, rows);
+        return hl_leaf_from_rows(hl, rows, 4, 4);
+    }
+    return hl_node(hl, node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+}
+
+/** \brief Kiszamolja (vagy a gyorsitotarbol visszaadja) a csomopont eredmenyet
+ *
+ * Az L szintu csomopontbol kilenc atfedo, L-1 szintu reszt keszit. Teljes sebessegnel ezeket,
+ * majd az eredmenyeikbol osszerakott negy reszt is lepteti; kisebb ugrasnal az elso lepes helyett
+ * csak a reszek kozepet veszi.
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param node HlNode* legalabb 4. szintu csomopont
+ * \return HlNode* a kozepso resz 2^min(step_log2, L-2) generacio mulva
+ *
+ */
+static HlNode *hl_result(HashLife *hl, HlNode *node) {
+    HlNode *result;
+    if (node->result != NULL) {
+        return node->result;
+    }
+
+    if (node->population == 0) {
+        result = hl->empty[node->level-1];
+    } else if (node->level == HL_LEAF_LEVEL+1) {
+        // Alapeset: a 16x16-os teruleten legfeljebb 4 generacio utan a kozepso 8x8 meg pontos
+        uint32_t rows[16];
+        int gens = 1 << (hl->step_log2 < 2 ? hl->step_log2 : 2);
+        int i;
+        hl_rows16(node, rows);
+        for (i=0; i<gens; i++) {
+            hl_life_rows16(rows);
+        }
+        result = hl_leaf_from_rows(hl, rows, 4, 4);
+    } else {
+        HlNode *nw = node->nw, *ne = node->ne, *sw = node->sw, *se = node->se;
+        HlNode *parts[9];
+        HlNode *r[9];
+        int i;
+        parts[0] = nw;
+        parts[1] = hl_node(hl, nw->ne, ne->nw, nw->se, ne->sw);
+        parts[2] = ne;
+        parts[3] = hl_node(hl, nw->sw, nw->se, sw->nw, sw->ne);
+        parts[4] = hl_node(hl, nw->se, ne->sw, sw->ne, se->nw);
+        parts[5] = hl_node(hl, ne->sw, ne->se, se->nw, se->ne);
+        parts[6] = sw;
+        parts[7] = hl_node(hl, sw->ne, se->nw, sw->se, se->sw);
+        parts[8] = se;
+        for (i=0; i<9; i++) {
+            r[i] = hl->step_log2 >= node->level-2 ? hl_result(hl, parts[i]) : hl_center(hl, parts[i]);
+        }
+        result = hl_node(hl,
+                         hl_result(hl, hl_node(hl, r[0], r[1], r[3], r[4])),
+                         hl_result(hl, hl_node(hl, r[1], r[2], r[4], r[5])),
+                         hl_result(hl, hl_node(hl, r[3], r[4], r[6], r[7])),
+                         hl_result(hl, hl_node(hl, r[4], r[5], r[7], r[8])));
+    }
+    node->result = result;
+    return result;
+}
+
+/** \brief Torli az osszes megjegyzett eredmenyt
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \return void
+ *
+ */
+static void hl_clear_results(HashLife *hl) {
+    size_t i;
+    HlNode *node;
+    for (i=0; i<hl->table_size; i++) {
+        for (node=hl->table[i]; node!=NULL; node=node->next) {
+            node->result = NULL;
+        }
+    }
+}
+
+/** \brief Megjeloli a csomopontot es mindent, amire hivatkozik
+ *
+ * \param node HlNode* a csomopont
+ * \return void
+ *
+ */
+static void hl_mark(HlNode *node) {
+    if (node == NULL || node->mark) {
+        return;
+    }
+    node->mark = 1;
+    if (node->level > HL_LEAF_LEVEL) {
+        hl_mark(node->nw);
+        hl_mark(node->ne);
+        hl_mark(node->sw);
+        hl_mark(node->se);
+    }
+    hl_mark(node->result);
+}
+
+/** \brief Szemetgyujtes: felszabaditja a gyokerbol es az ures csomopontokbol nem elerheto csomopontokat
+ *
+ * A megjegyzett eredmenyek is elerhetonek szamitanak. Ha igy sem szabadul fel eleg hely,
+ * az eredmenyeket eldobja es ujra gyujt.
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \return void
+ *
+ */
+static void hl_gc(HashLife *hl) {
+    int pass, level;
+    size_t i;
+    for (pass=0; pass<2; pass++) {
+        if (pass == 1) {
+            if (hl->node_count <= hl->max_nodes/2) {
+                break;
+            }
+            hl_clear_results(hl);
+        }
+        hl_mark(hl->root);
+        for (level=HL_LEAF_LEVEL; level<=HL_MAX_LEVEL; level++) {
+            hl_mark(hl->empty[level]);
+        }
+        for (i=0; i<hl->table_size; i++) {
+            HlNode **link = &hl->table[i];
+            while (*link != NULL) {
+                HlNode *node = *link;
+                if (node->mark) {
+                    node->mark = 0;
+                    link = &node->next;
+                } else {
+                    *link = node->next;
+                    node->next = hl->free_list;
+                    hl->free_list = node;
+                    hl->node_count--;
+                }
+            }
+        }
+    }
+}
+
+/** \brief Az ures gyoker letrehozasa utan a peldany alaphelyzetbe allitasa
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param root HlNode* az uj gyoker
+ * \return void
+ *
+ */
+static void hl_set_root(HashLife *hl, HlNode *root) {
+    hl->root = root;
+    hl->origin_x = 0;
+    hl->origin_y = 0;
+    hl->generation = 0;
+}
+
+HashLife *hashlife_new(size_t cache_size) {
+    HashLife *hl = malloc(sizeof(HashLife));
+    int level;
+    if (hl == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a HashLife letrehozasanal.\n");
+#endif // NDEBUG
+        return NULL;
+    }
+    hl->table_size = HL_TABLE_INIT;
+    hl->table = malloc(sizeof(HlNode*)*hl->table_size);
+    if (hl->table == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a HashLife letrehozasanal.\n");
+#endif // NDEBUG
+        free(hl);
+        return NULL;
+    }
+    memset(hl->table, 0, sizeof(HlNode*)*hl->table_size);
+    hl->node_count = 0;
+    hl->blocks = NULL;
+    hl->free_list = NULL;
+    hl->step_log2 = -1;
+    hl->failed = 0;
+    hashlife_set_cache_size(hl, cache_size);
+
+    // Az ures csomopontok minden szinten elore elkeszulnek, hiba eseten ezekkel lehet tovabbmenni
+    for (level=0; level<=HL_MAX_LEVEL; level++) {
+        hl->empty[level] = NULL;
+    }
+    for (level=HL_LEAF_LEVEL; level<=HL_MAX_LEVEL; level++) {
+        HlNode *empty = level == HL_LEAF_LEVEL ? hl_leaf(hl, 0) : hl_node(hl, hl->empty[level-1], hl->empty[level-1], hl->empty[level-1], hl->empty[level-1]);
+        if (hl->failed || empty == NULL) {
+            hashlife_free(hl);
+            return NULL;
+        }
+        hl->empty[level] = empty;
+    }
+    hl_set_root(hl, hl->empty[HL_LEAF_LEVEL+2]);
+    return hl;
+}
+
+void hashlife_free(HashLife *hl) {
+    while (hl->blocks != NULL) {
+        HlBlock *next = hl->blocks->next;
+        free(hl->blocks);
+        hl->blocks = next;
+    }
+    free(hl->table);
+    free(hl);
+}
+
+void hashlife_set_cache_size(HashLife *hl, size_t cache_size) {
+    hl->max_nodes = cache_size / sizeof(HlNode);
+    if (hl->max_nodes < HL_NODES_MIN) {
+        hl->max_nodes = HL_NODES_MIN;
+    }
+}
+
+/** \brief Egy negyzetes csomoponttombot szintenkent paronkent egyetlen csomopontta von ossze
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param nodes HlNode** side x side azonos szintu csomopont, soronkent (a tomb felulirodik)
+ * \param side int a tomb oldalhossza (2 hatvanya)
+ * \return HlNode* az osszevont csomopont
+ *
+ */
+static HlNode *hl_merge(HashLife *hl, HlNode **nodes, int side) {
+    int x, y;
+    for (; side>1; side/=2) {
+        for (y=0; y<side/2; y++) {
+            for (x=0; x<side/2; x++) {
+                nodes[y*(side/2)+x] = hl_node(hl, nodes[2*y*side+2*x], nodes[2*y*side+2*x+1], nodes[(2*y+1)*side+2*x], nodes[(2*y+1)*side+2*x+1]);
+            }
+        }
+    }
+    return nodes[0];
+}
+
+int hashlife_from_grid(HashLife *hl, const Grid *grid) {
+    // A levelek negyzetes tombje, amit szintenkent paronkent osszevonunk
+    int leaves_x = (grid->size_x + 7) / 8;
+    int leaves_y = (grid->size_y + 7) / 8;
+    int side = 2;
+    int x, y, i;
+    HlNode **nodes;
+
+    while (side < leaves_x || side < leaves_y) {
+        side *= 2;
+    }
+    nodes = malloc(sizeof(HlNode*)*side*side);
+    if (nodes == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a grid HashLife-ba toltesenel.\n");
+#endif // NDEBUG
+        return 0;
+    }
+    if (hl->node_count > hl->max_nodes) {
+        hl_gc(hl);
+    }
+
+    for (y=0; y<side; y++) {
+        for (x=0; x<side; x++) {
+            uint64_t bits = 0;
+            if (x < leaves_x && y < leaves_y) {
+                for (i=0; i<8 && y*8+i<grid->size_y; i++) {
+                    const uint64_t *row = grid_row(grid, grid->cells, y*8+i) + GRID_HALO_WORDS;
+                    bits |= ((row[x/8] >> (x%8*8)) & 0xFF) << (8*i);
+                }
+            }
+            nodes[y*side+x] = hl_leaf(hl, bits);
+        }
+    }
+
+    hl_set_root(hl, hl_merge(hl, nodes, side));
+    free(nodes);
+    if (hl->failed) {
+        hl->failed = 0;
+        hl_set_root(hl, hl->empty[HL_LEAF_LEVEL+2]);
+        return 0;
+    }
+    return 1;
+}
+
+/** \brief A csomopont elo cellait a gridbe irja
+ *
+ * \param node const HlNode* a csomopont
+ * \param x0 int64_t a csomopont bal felso sarkanak x koordinataja
+ * \param y0 int64_t a csomopont bal felso sarkanak y koordinataja
+ * \param grid Grid* a gridre mutato pointer
+ * \return uint64_t a gridbol kilogo elo cellak szama
+ *
+ */
+static uint64_t hl_write_grid(const HlNode *node, int64_t x0, int64_t y0, Grid *grid) {
+    int64_t side = (int64_t)1 << node->level;
+    uint64_t lost = 0;
+    if (node->population == 0) {
+        return 0;
+    }
+    if (x0 + side <= 0 || y0 + side <= 0 || x0 >= GRID_COORD_LIMIT || y0 >= GRID_COORD_LIMIT) {
+        return node->population;
+    }
+    if (node->level == HL_LEAF_LEVEL) {
+        int bit;
+        for (bit=0; bit<64; bit++) {
+            if ((node->bits >> bit) & 1) {
+                int64_t x = x0 + bit%8;
+                int64_t y = y0 + bit/8;
+                if (x < 0 || y < 0 || x >= GRID_COORD_LIMIT || y >= GRID_COORD_LIMIT) {
+                    lost++;
+                } else {
+                    grid_set(grid, (int)x, (int)y, (Cell) {
+                        alive, alive
+                    });
+                }
+            }
+        }
+        return lost;
+    }
+    side /= 2;
+    lost += hl_write_grid(node->nw, x0, y0, grid);
+    lost += hl_write_grid(node->ne, x0 + side, y0, grid);
+    lost += hl_write_grid(node->sw, x0, y0 + side, grid);
+    lost += hl_write_grid(node->se, x0 + side, y0 + side, grid);
+    return lost;
+}
+
+uint64_t hashlife_to_grid(HashLife *hl, Grid *grid) {
+    grid_clear_cells(grid);
+    return hl_write_grid(hl->root, hl->origin_x, hl->origin_y, grid);
+}
+
+/** \brief Beilleszt egy reszfat a csomopont megadott helyere
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param node HlNode* a csomopont
+ * \param px int64_t a hely x koordinataja a reszfa meretenek egysegeiben
+ * \param py int64_t a hely y koordinataja a reszfa meretenek egysegeiben
+ * \param part HlNode* a beillesztendo reszfa
+ * \return HlNode* az uj csomopont
+ *
+ */
+static HlNode *hl_insert(HashLife *hl, HlNode *node, int64_t px, int64_t py, HlNode *part) {
+    int64_t half;
+    if (node->level == part->level) {
+        return part;
+    }
+    half = (int64_t)1 << (node->level - part->level - 1);
+    if (py < half) {
+        if (px < half) {
+            return hl_node(hl, hl_insert(hl, node->nw, px, py, part), node->ne, node->sw, node->se);
+        }
+        return hl_node(hl, node->nw, hl_insert(hl, node->ne, px-half, py, part), node->sw, node->se);
+    }
+    if (px < half) {
+        return hl_node(hl, node->nw, node->ne, hl_insert(hl, node->sw, px, py-half, part), node->se);
+    }
+    return hl_node(hl, node->nw, node->ne, node->sw, hl_insert(hl, node->se, px-half, py-half, part));
+}
+
+int hashlife_from_world(HashLife *hl, const World *world) {
+    // Minden darabbol egy 6. szintu csomopont lesz, ezeket a befoglalo negyzet megfelelo helyere illesztjuk
+    const int chunk_leaves = WORLD_CHUNK_SIZE/8;
+    HlNode *leaves[(WORLD_CHUNK_SIZE/8)*(WORLD_CHUNK_SIZE/8)];
+    int64_t min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+    int64_t side = 1;
+    int level = HL_LEAF_LEVEL + WORLD_CHUNK_SHIFT - 3;
+    int first = 1;
+    size_t i;
+    const WorldChunk *chunk;
+    HlNode *root;
+
+    for (i=0; i<world->table_size; i++) {
+        for (chunk=world->table[i]; chunk!=NULL; chunk=chunk->next) {
+            if (first) {
+                min_x = max_x = chunk->cx;
+                min_y = max_y = chunk->cy;
+                first = 0;
+            }
+            min_x = chunk->cx < min_x ? chunk->cx : min_x;
+            min_y = chunk->cy < min_y ? chunk->cy : min_y;
+            max_x = chunk->cx > max_x ? chunk->cx : max_x;
+            max_y = chunk->cy > max_y ? chunk->cy : max_y;
+        }
+    }
+    while (side <= max_x - min_x || side <= max_y - min_y) {
+        side *= 2;
+        level++;
+        if (level > HL_MAX_LEVEL-4) {
+            return 0;
+        }
+    }
+    if (hl->node_count > hl->max_nodes) {
+        hl_gc(hl);
+    }
+
+    root = hl->empty[level];
+    for (i=0; i<world->table_size; i++) {
+        for (chunk=world->table[i]; chunk!=NULL; chunk=chunk->next) {
+            int lx, ly, r;
+            for (ly=0; ly<chunk_leaves; ly++) {
+                for (lx=0; lx<chunk_leaves; lx++) {
+                    uint64_t bits = 0;
+                    for (r=0; r<8; r++) {
+                        bits |= ((chunk->cells[ly*8+r] >> (lx*8)) & 0xFF) << (8*r);
+                    }
+                    leaves[ly*chunk_leaves+lx] = hl_leaf(hl, bits);
+                }
+            }
+            root = hl_insert(hl, root, chunk->cx - min_x, chunk->cy - min_y, hl_merge(hl, leaves, chunk_leaves));
+        }
+    }
+
+    hl_set_root(hl, root);
+    hl->origin_x = min_x*WORLD_CHUNK_SIZE;
+    hl->origin_y = min_y*WORLD_CHUNK_SIZE;
+    if (hl->failed) {
+        hl->failed = 0;
+        hl_set_root(hl, hl->empty[HL_LEAF_LEVEL+2]);
+        return 0;
+    }
+    return 1;
+}
+
+/** \brief A csomopont elo cellait a vilagba irja
+ *
+ * \param node const HlNode* a csomopont
+ * \param x0 int64_t a csomopont bal felso sarkanak x koordinataja
+ * \param y0 int64_t a csomopont bal felso sarkanak y koordinataja
+ * \param world World* a vilagra mutato pointer
+ * \return void
+ *
+ */
+static void hl_write_world(const HlNode *node, int64_t x0, int64_t y0, World *world) {
+    int64_t half = (int64_t)1 << (node->level-1);
+    if (node->population == 0) {
+        return;
+    }
+    if (node->level == HL_LEAF_LEVEL) {
+        int bit;
+        for (bit=0; bit<64; bit++) {
+            if ((node->bits >> bit) & 1) {
+                world_set(world, x0 + bit%8, y0 + bit/8, (Cell) {
+                    alive, alive
+                });
+            }
+        }
+        return;
+    }
+    hl_write_world(node->nw, x0, y0, world);
+    hl_write_world(node->ne, x0 + half, y0, world);
+    hl_write_world(node->sw, x0, y0 + half, world);
+    hl_write_world(node->se, x0 + half, y0 + half, world);
+}
+
+void hashlife_to_world(HashLife *hl, World *world) {
+    world_clear_cells(world);
+    hl_write_world(hl->root, hl->origin_x, hl->origin_y, world);
+}
+
+/** \brief Kibovit egy csomopontot ugy, hogy az eredeti a kozepere keruljon
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param node HlNode* a csomopont
+ * \return HlNode* az eggyel magasabb szintu csomopont
+ *
+ */
+static HlNode *hl_expand(HashLife *hl, HlNode *node) {
+    HlNode *e = hl->empty[node->level-1];
+    return hl_node(hl,
+                   hl_node(hl, e, e, e, node->nw),
+                   hl_node(hl, e, e, node->ne, e),
+                   hl_node(hl, e, node->sw, e, e),
+                   hl_node(hl, node->se, e, e, e));
+}
+
+/** \brief Visszaadja, hogy a minta a gyoker kozepso negyedeben van-e
+ *
+ * \param node const HlNode* legalabb 5. szintu csomopont
+ * \return int 1, ha a szelso unokak uresek
+ *
+ */
+static int hl_border_empty(const HlNode *node) {
+    return node->population == node->nw->se->population + node->ne->sw->population + node->sw->ne->population + node->se->nw->population;
+}
+
+int hashlife_step(HashLife *hl, int step_log2) {
+    HlNode *root = hl->root;
+    int64_t origin_x = hl->origin_x;
+    int64_t origin_y = hl->origin_y;
+    int64_t half;
+
+    if (step_log2 < 0 || step_log2 > HASHLIFE_STEP_MAX) {
+        return 0;
+    }
+    // Az eredmenyek csak egy ugrasmeretre ervenyesek
+    if (hl->step_log2 != step_log2) {
+        hl_clear_results(hl);
+        hl->step_log2 = step_log2;
+    }
+    if (hl->node_count > hl->max_nodes) {
+        hl_gc(hl);
+    }
+
+    // A gyokeret addig bovitjuk, amig a minta a kozepso negyedbe kerul es a szint elegendo,
+    // majd meg egyszer, hogy a minta 2^step_log2 generacio alatt se erjen ki az eredmenybol
+    while (root->level < step_log2+2 || root->level < HL_LEAF_LEVEL+2 || !hl_border_empty(root)) {
+        if (root->level >= HL_MAX_LEVEL-1) {
+            return 0;
+        }
+        half = (int64_t)1 << (root->level-1);
+        origin_x -= half;
+        origin_y -= half;
+        root = hl_expand(hl, root);
+    }
+    half = (int64_t)1 << (root->level-1);
+    origin_x -= half;
+    origin_y -= half;
+    root = hl_expand(hl, root);
+
+    // Az eredmeny a gyoker kozepso fele
+    root = hl_result(hl, root);
+    origin_x += (int64_t)1 << (root->level-1);
+    origin_y += (int64_t)1 << (root->level-1);
+    if (hl->failed) {
+        // A hiba kozben kapott ures csomopontok hibas eredmenyeket hagyhattak hatra
+        hl->failed = 0;
+        hl_clear_results(hl);
+        return 0;
+    }
+    hl->root = root;
+    hl->origin_x = origin_x;
+    hl->origin_y = origin_y;
+    hl->generation += (uint64_t)1 << step_log2;
+    return 1;
+}
+
+uint64_t hashlife_population(const HashLife *hl) {
+    return hl->root->population;
+}
+
+uint64_t hashlife_generation(const HashLife *hl) {
+    return hl->generation;
+}
+
+size_t hashlife_node_count(const HashLife *hl) {
+    return hl->node_count;
+}
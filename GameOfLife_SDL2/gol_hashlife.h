@@ -0,0 +1,119 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_hashlife.h
+ * Description:     HashLife motor a nagy ugrasokhoz
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#ifndef __GOL_HASHLIFE_H_INCLUDED__
+#define __GOL_HASHLIFE_H_INCLUDED__
+
+#define HASHLIFE_STEP_MAX 48            /**< A legnagyobb ugras kitevoje (2^48 generacio) */
+
+/** \brief Letrehoz egy uj, ures HashLife peldanyt
+ *
+ * A minta egy hash-elt negyesfaban tarolodik: az azonos reszletek egyetlen csomopontot
+ * hasznalnak, es minden csomopont megjegyzi a kozepenek jovobeli allapotat.
+ *
+ * \param cache_size size_t a csomopontok gyorsitotaranak merete bajtban
+ * \return HashLife* a peldanyra mutato pointer (Hiba eseten NULL)
+ *
+ */
+HashLife *hashlife_new(size_t cache_size);
+
+/** \brief Felszabaditja a HashLife peldanyt
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \return void
+ *
+ */
+void hashlife_free(HashLife *hl);
+
+/** \brief Beallitja a csomopontok gyorsitotaranak meretet
+ *
+ * A korlatot a szemetgyujtes lepesek kozott ervenyesiti, egy lepes kozben atmenetileg tullepheto.
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param cache_size size_t a gyorsitotar merete bajtban
+ * \return void
+ *
+ */
+void hashlife_set_cache_size(HashLife *hl, size_t cache_size);
+
+/** \brief Betolti a grid allapotat (a generacioszamlalot nullazza)
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param grid const Grid* a gridre mutato pointer
+ * \return int 1, ha sikerult; 0 hiba eseten
+ *
+ */
+int hashlife_from_grid(HashLife *hl, const Grid *grid);
+
+/** \brief Visszairja az allapotot a gridbe
+ *
+ * A grid szukseg eseten megno, a was_alive bitsik megmarad es az elo cellakkal bovul.
+ * A grid a vegtelen sikbol csak a [0, GRID_COORD_LIMIT) tartomanyt tudja tarolni,
+ * az ezen kivul eso cellak elvesznek.
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param grid Grid* a gridre mutato pointer
+ * \return uint64_t a grid tartomanyan kivul eso (elvesztett) elo cellak szama
+ *
+ */
+uint64_t hashlife_to_grid(HashLife *hl, Grid *grid);
+
+/** \brief Betolti a vegtelen vilag allapotat (a generacioszamlalot nullazza)
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param world const World* a vilagra mutato pointer
+ * \return int 1, ha sikerult; 0 hiba eseten (peldaul ha a minta tul szeles)
+ *
+ */
+int hashlife_from_world(HashLife *hl, const World *world);
+
+/** \brief Visszairja az allapotot a vegtelen vilagba, veszteseg nelkul
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param world World* a vilagra mutato pointer
+ * \return void
+ *
+ */
+void hashlife_to_world(HashLife *hl, World *world);
+
+/** \brief Lepteti a mintat 2^step_log2 generacioval
+ *
+ * A HashLife vegtelen, halott cellakkal korulvett sikon dolgozik, a grid szelen levo halott keretet nem ismeri.
+ *
+ * \param hl HashLife* a peldanyra mutato pointer
+ * \param step_log2 int az ugras kitevoje (0..HASHLIFE_STEP_MAX)
+ * \return int 1, ha sikerult; 0 hiba eseten (ekkor az allapot valtozatlan)
+ *
+ */
+int hashlife_step(HashLife *hl, int step_log2);
+
+/** \brief Visszaadja az elo cellak szamat
+ *
+ * \param hl const HashLife* a peldanyra mutato pointer
+ * \return uint64_t az elo cellak szama
+ *
+ */
+uint64_t hashlife_population(const HashLife *hl);
+
+/** \brief Visszaadja, hany generacioval lepett a minta a betoltes ota
+ *
+ * \param hl const HashLife* a peldanyra mutato pointer
+ * \return uint64_t a generaciok szama
+ *
+ */
+uint64_t hashlife_generation(const HashLife *hl);
+
+/** \brief Visszaadja a gyorsitotarban levo csomopontok szamat
+ *
+ * \param hl const HashLife* a peldanyra mutato pointer
+ * \return size_t a csomopontok szama
+ *
+ */
+size_t hashlife_node_count(const HashLife *hl);
+
+#endif // __GOL_HASHLIFE_H_INCLUDED__
@@ -0,0 +1,666 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_kernel.c
+ * Description:     A grid leptetesenek kernelei es a kernel kivalasztasa
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#include <stdlib.h>
+#include <string.h>
+#include "gol_main.h"
+#include "gol_grid.h"
+#include "gol_kernel.h"
+#include "gol_rule.h"
+
+static KernelType kernel_type = KERNEL_AUTO;
+static KernelType kernel_request = KERNEL_AUTO;
+static GridKernel kernel_func = NULL;
+static KernelCounter kernel_counter = NULL;
+static KernelExpander kernel_expander = NULL;
+
+// A leptetes szabalya (alapertelmezes: B3/S23), es a sorszama a KERNEL_RULES listaban (-1, ha nincs benne)
+#define KERNEL_RULE_VALUE(name, birth, survive) {birth, survive, 0, 0, 0, {0}},
+static const Rule kernel_rules[] = {
+    KERNEL_RULES(KERNEL_RULE_VALUE)
+};
+#undef KERNEL_RULE_VALUE
+static Rule kernel_rule_current = {0x008, 0x00C, 0, 0, 0, {0}};
+static int kernel_rule_index = 0;
+
+// A KERNEL_RULES-ban nem szereplo szabaly aramkore (kernel_circuit_ready: sikerult-e leforditani)
+RuleCircuit kernel_circuit;
+static int kernel_circuit_ready = 0;
+
+// Az altalanos kernel tablaja: 3x3-as kornyezet (rule_table) -> kovetkezo allapot
+static uint8_t kernel_rule_table[RULE_TABLE_SIZE];
+static int kernel_rule_ready = 0;
+
+// A tablazatos kernel tablaja: a 4x4-es kornyezet 16 bitjebol a kozepso 2x2 cella kovetkezo allapota
+static uint8_t kernel_lut[1 << 16];
+static int kernel_lut_ready = 0;
+
+// Az utolso meres eredmenye kernelenkent (millio cella masodpercenkent, 0: nem volt meres)
+static double kernel_bench_result[KERNEL_COUNT];
+
+/** \brief Visszaadja egy oszlop harom cellajat (felso, kozepso, also) a tabla indexenek alakjaban
+ *
+ * \param up const uint64_t* a felso sor
+ * \param mid const uint64_t* a kozepso sor
+ * \param down const uint64_t* az also sor
+ * \param x int az oszlop (-1 es size_x a keret)
+ * \return int az oszlop harom bitje
+ *
+ */
+static inline int kernel_column(const uint64_t *up, const uint64_t *mid, const uint64_t *down, int x) {
+    return grid_bit_get(up, x) | grid_bit_get(mid, x) << 1 | grid_bit_get(down, x) << 2;
+}
+
+/** \brief Cellankenti referencia kernel
+ *
+ * A csempek egesz szavakat fednek le, igy a kulonbozo csempek irasai sosem erintik ugyanazt a szot.
+ * A bitszeletelt kernelek eredmenyet ezzel lehet osszevetni. Barmely szabalyt kezel (az 512 elemu
+ * kornyezettablabol), ezert a Hensel-jelolesu es az aramkorre nem forditott szabalyok is ezzel futnak.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param word_begin int a csempe elso szava (a sor elejetol, keret nelkul)
+ * \param word_end int a csempe utani elso szo
+ * \param row_begin int a csempe elso sora
+ * \param row_end int a csempe utani elso sor
+ * \return int 1, ha valtozott cella a csempeben
+ *
+ */
+static int kernel_life_scalar(Grid *grid, int word_begin, int word_end, int row_begin, int row_end) {
+    int i,j;
+    int changed = 0;
+    int x_begin = word_begin*GRID_WORD_BITS;
+    int x_end = word_end*GRID_WORD_BITS;
+    if (x_end > grid->size_x) {
+        x_end = grid->size_x;
+    }
+    if (row_end > grid->size_y) {
+        row_end = grid->size_y;
+    }
+    for (j=row_begin; j<row_end; j++) {
+        // A harom szomszedos sor egymas utan kovetkezik a pufferben
+        const uint64_t *up = grid_row(grid, grid->cells, j-1);
+        const uint64_t *mid = grid_row(grid, grid->cells, j);
+        const uint64_t *down = grid_row(grid, grid->cells, j+1);
+        uint64_t *next = grid_row(grid, grid->next_cells, j);
+        uint64_t *was_alive = grid_row(grid, grid->was_alive, j);
+        // A kornyezet indexe csuszik a sor menten: a ket atfedo oszlop megmarad, csak a jobb oldali uj
+        int index = kernel_column(up, mid, down, x_begin-1) << 3 | kernel_column(up, mid, down, x_begin) << 6;
+        for (i=x_begin; i<x_end; i++) {
+            index = index >> 3 | kernel_column(up, mid, down, i+1) << 6;
+
+            // A szabaly a tablazatbol: a 3x3-as kornyezet adja a kovetkezo allapotot
+            int state = (index >> 4) & 1;
+            int next_state = kernel_rule_table[index];
+            if (next_state) {
+                grid_bit_set(was_alive, i, 1);
+            }
+            grid_bit_set(next, i, next_state);
+            changed |= next_state != state;
+        }
+    }
+    return changed;
+}
+
+/** \brief Feltolti a tablazatos kernel tablajat az aktualis szabaly szerint
+ *
+ * Az index 4*y+x. bitje a kornyezet (x, y) cellaja; a bejegyzes 0. es 1. bitje a felso,
+ * 2. es 3. bitje az also sor kozepso ket cellajanak kovetkezo allapota.
+ * Szabalyvaltaskor a tabla ujraepul.
+ *
+ * \return void
+ *
+ */
+static void kernel_lut_init(void) {
+    int index, out, dx, dy;
+    if (kernel_lut_ready) {
+        return;
+    }
+    for (index=0; index<(1 << 16); index++) {
+        uint8_t entry = 0;
+        for (out=0; out<4; out++) {
+            int cx = 1 + out%2;
+            int cy = 1 + out/2;
+            int neighbourhood = 0;
+            for (dy=-1; dy<=1; dy++) {
+                for (dx=-1; dx<=1; dx++) {
+                    neighbourhood |= ((index >> (4*(cy + dy) + cx + dx)) & 1) << (3*(dx + 1) + dy + 1);
+                }
+            }
+            if (kernel_rule_table[neighbourhood]) {
+                entry |= 1 << out;
+            }
+        }
+        kernel_lut[index] = entry;
+    }
+    kernel_lut_ready = 1;
+}
+
+/** \brief Visszaadja egy sor negy cellajat a [x-1, x+2] tartomanybol
+ *
+ * \param row const uint64_t* a sor aktualis szava
+ * \param shifted uint64_t a sor egy cellaval jobbra tolt szava (a k. bit az (k-1). cella)
+ * \param bit int a paros kezdo cella a szoban
+ * \return int a negy cella, alulrol felfele
+ *
+ */
+static inline int kernel_lut_nibble(const uint64_t *row, uint64_t shifted, int bit) {
+    if (bit < GRID_WORD_BITS-2) {
+        return (int)(shifted >> bit) & 0xF;
+    }
+    // A szo utolso cellaparjahoz a kovetkezo szo elso cellaja is kell
+    return (int)(shifted >> bit) | (int)((row[0] >> 63) << 2) | (int)((row[1] & 1) << 3);
+}
+
+/** \brief Tablazatos kernel: soronkent ket sort, egy tablazatolvasassal 2x2 cellat lep
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param word_begin int a csempe elso szava (a sor elejetol, keret nelkul)
+ * \param word_end int a csempe utani elso szo
+ * \param row_begin int a csempe elso sora (paros)
+ * \param row_end int a csempe utani elso sor
+ * \return int 1, ha valtozott cella a csempeben
+ *
+ */
+static int kernel_life_lut(Grid *grid, int word_begin, int word_end, int row_begin, int row_end) {
+    const int words = grid_words(grid->size_x);
+    uint64_t diff = 0;
+    int i, r, k, bit;
+    if (row_end > grid->size_y) {
+        row_end = grid->size_y;
+    }
+    if (word_end > words) {
+        word_end = words;
+    }
+    for (r=row_begin; r<row_end; r+=2) {
+        // A paratlan magassagu grid utolso sorpar also sora mar a gridon kivul van
+        int pair = r+1 < row_end;
+        for (i=word_begin; i<word_end; i++) {
+            const uint64_t *rows[4];
+            uint64_t shifted[4];
+            uint64_t top = 0, bottom = 0;
+            int bits = grid->size_x - i*GRID_WORD_BITS;
+            uint64_t mask = bits >= GRID_WORD_BITS ? ~(uint64_t)0 : ((uint64_t)1 << bits) - 1;
+            for (k=0; k<4; k++) {
+                // Par nelkuli sornal a negyedik sor mar a kereten tul lehet; csak az eldobott also sort befolyasolja
+                rows[k] = grid_row(grid, grid->cells, (pair || k < 3) ? r-1+k : r+1) + GRID_HALO_WORDS + i;
+                shifted[k] = rows[k][0] << 1 | rows[k][-1] >> 63;
+            }
+            for (bit=0; bit<GRID_WORD_BITS; bit+=2) {
+                int index = kernel_lut_nibble(rows[0], shifted[0], bit)
+                            | kernel_lut_nibble(rows[1], shifted[1], bit) << 4
+                            | kernel_lut_nibble(rows[2], shifted[2], bit) << 8
+                            | kernel_lut_nibble(rows[3], shifted[3], bit) << 12;
+                uint64_t entry = kernel_lut[index];
+                top |= (entry & 3) << bit;
+                bottom |= (entry >> 2) << bit;
+            }
+            top &= mask;
+            bottom &= mask;
+
+            uint64_t *next = grid_row(grid, grid->next_cells, r) + GRID_HALO_WORDS + i;
+            uint64_t *was_alive = grid_row(grid, grid->was_alive, r) + GRID_HALO_WORDS + i;
+            next[0] = top;
+            was_alive[0] |= top;
+            diff |= (top ^ rows[1][0]) & mask;
+            if (pair) {
+                next[grid->stride] = bottom;
+                was_alive[grid->stride] |= bottom;
+                diff |= (bottom ^ rows[2][0]) & mask;
+            }
+        }
+    }
+    return diff != 0;
+}
+
+// A Larger than Life kernel egy soranak leghosszabb szakasza: a csempe es ket oldalt a kornyezet sugara
+#define KERNEL_LTL_SPAN (GRID_TILE_WORDS*GRID_WORD_BITS + 2*RULE_LTL_RANGE_MAX)
+
+/** \brief Kibontja egy sor [x_begin, x_end) szakaszat cellankent egy bajtba
+ *
+ * A gridon kivuli cellak a topologia szerint halottak, vagy a szemkozti szelrol szarmaznak
+ * (Klein-palacknal a felso es also szelen at tukrozve).
+ *
+ * \param grid const Grid* a gridre mutato pointer
+ * \param y int a sor (a gridon kivul is lehet)
+ * \param x_begin int a szakasz elso cellaja (negativ is lehet)
+ * \param x_end int a szakasz utani elso cella
+ * \param out uint8_t* ide kerulnek a cellak (0 vagy 1)
+ * \return void
+ *
+ */
+static void kernel_ltl_row(const Grid *grid, int y, int x_begin, int x_end, uint8_t *out) {
+    const int wraps = grid->topology == TOPOLOGY_TORUS || grid->topology == TOPOLOGY_KLEIN;
+    const uint64_t *row;
+    int mirror = 0;
+    int x;
+    if (y < 0 || y >= grid->size_y) {
+        if (!wraps) {
+            memset(out, 0, x_end - x_begin);
+            return;
+        }
+        // Kis gridnel a kornyezet tobbszor is korbeerhet
+        while (y < 0) {
+            y += grid->size_y;
+            mirror ^= 1;
+        }
+        while (y >= grid->size_y) {
+            y -= grid->size_y;
+            mirror ^= 1;
+        }
+        mirror &= grid->topology == TOPOLOGY_KLEIN;
+    }
+    row = grid_row(grid, grid->cells, y);
+    if (!mirror && x_begin >= 0 && x_end <= grid->size_x) {
+        // A gyakori eset: a szakasz a gridon belul van, szavankent bonthato ki
+        const uint64_t *src = row + GRID_HALO_WORDS;
+        for (x=x_begin; x<x_end; x++) {
+            out[x - x_begin] = (src[x / GRID_WORD_BITS] >> (x % GRID_WORD_BITS)) & 1;
+        }
+        return;
+    }
+    for (x=x_begin; x<x_end; x++) {
+        int cx = x;
+        if (cx < 0 || cx >= grid->size_x) {
+            if (!wraps) {
+                out[x - x_begin] = 0;
+                continue;
+            }
+            cx = ((cx % grid->size_x) + grid->size_x) % grid->size_x;
+        }
+        out[x - x_begin] = grid_bit_get(row, mirror ? grid->size_x - 1 - cx : cx);
+    }
+}
+
+/** \brief Larger than Life kernel: az r sugaru negyzetes kornyezet osszege futo dobozosszegekkel
+ *
+ * Oszloponkent a (2r+1) magas ablak osszege soronkent egy uj sor hozzaadasaval es a legregebbi
+ * kivonasaval frissul, a sor menten pedig a (2r+1) szeles ablak ugyanigy csuszik, igy cellankent
+ * allando szamu muvelet kell, a sugartol fuggetlenul. A csempe a kornyezet miatt a szomszedos
+ * csempek soraibol is olvas, de csak a sajat szavait irja.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param word_begin int a csempe elso szava (a sor elejetol, keret nelkul)
+ * \param word_end int a csempe utani elso szo
+ * \param row_begin int a csempe elso sora
+ * \param row_end int a csempe utani elso sor
+ * \return int 1, ha valtozott cella a csempeben
+ *
+ */
+static int kernel_ltl(Grid *grid, int word_begin, int word_end, int row_begin, int row_end) {
+    const LtlRule *ltl = &kernel_rule_current.ltl;
+    const int r = ltl->range;
+    const unsigned survive_span = ltl->survive_max - ltl->survive_min;
+    const unsigned birth_span = ltl->birth_max - ltl->birth_min;
+    uint16_t columns[KERNEL_LTL_SPAN];
+    uint8_t added[KERNEL_LTL_SPAN];
+    uint8_t removed[KERNEL_LTL_SPAN];
+    uint64_t diff = 0;
+    int i, j, x, dy, span;
+    int x_begin = word_begin*GRID_WORD_BITS;
+    int x_end = word_end*GRID_WORD_BITS;
+    if (x_end > grid->size_x) {
+        x_end = grid->size_x;
+    }
+    if (row_end > grid->size_y) {
+        row_end = grid->size_y;
+    }
+    span = x_end - x_begin + 2*r;
+
+    // Az elso sor ablaka
+    memset(columns, 0, sizeof(columns));
+    for (dy=-r; dy<=r; dy++) {
+        kernel_ltl_row(grid, row_begin + dy, x_begin - r, x_end + r, added);
+        for (i=0; i<span; i++) {
+            columns[i] += added[i];
+        }
+    }
+    for (j=row_begin; j<row_end; j++) {
+        const uint64_t *src = grid_row(grid, grid->cells, j) + GRID_HALO_WORDS;
+        uint64_t *next = grid_row(grid, grid->next_cells, j) + GRID_HALO_WORDS;
+        uint64_t *was_alive = grid_row(grid, grid->was_alive, j) + GRID_HALO_WORDS;
+        uint64_t word = 0;
+        int sum = 0;
+        if (j > row_begin) {
+            kernel_ltl_row(grid, j + r, x_begin - r, x_end + r, added);
+            kernel_ltl_row(grid, j - r - 1, x_begin - r, x_end + r, removed);
+            for (i=0; i<span; i++) {
+                columns[i] += added[i] - removed[i];
+            }
+        }
+        for (i=0; i<2*r; i++) {
+            sum += columns[i];
+        }
+        for (x=x_begin; x<x_end; x++) {
+            const int bit = x % GRID_WORD_BITS;
+            const int state = (src[x / GRID_WORD_BITS] >> bit) & 1;
+            int count, alive;
+            sum += columns[x - x_begin + 2*r];
+            count = ltl->middle ? sum : sum - state;
+            // Elagazas nelkul: a veletlenszeru mintakon a feltetel nem josolhato
+            alive = (state & ((unsigned)(count - ltl->survive_min) <= survive_span))
+                    | (!state & ((unsigned)(count - ltl->birth_min) <= birth_span));
+            word |= (uint64_t)alive << bit;
+            sum -= columns[x - x_begin];
+            if (bit == GRID_WORD_BITS-1 || x == x_end-1) {
+                // A szo kesz: a gridon kivuli bitek nullak maradnak
+                next[x / GRID_WORD_BITS] = word;
+                was_alive[x / GRID_WORD_BITS] |= word;
+                diff |= word ^ src[x / GRID_WORD_BITS];
+                word = 0;
+            }
+        }
+    }
+    return diff != 0;
+}
+
+// A hordozhato bitszeletelt kernel: minden uint64_t 64 cellat tarol, a sorok
+// kozotti atvitelt a szomszedos szavak eltolasa adja. Intrinsic nelkul fordul.
+#define KERNEL_NAME kernel_swar
+#define VEC uint64_t
+#define VWORDS 1
+#define VLOAD(p) (*(p))
+#define VSTORE(p, v) (*(p) = (v))
+#define VAND(a, b) ((a) & (b))
+#define VOR(a, b) ((a) | (b))
+#define VXOR(a, b) ((a) ^ (b))
+#define VANDNOT(a, b) (~(a) & (b))
+#define VSHL(v, n) ((v) << (n))
+#define VSHR(v, n) ((v) >> (n))
+#include "gol_kernel_bitslice.h"
+
+/** \brief Bajtonkent megszamolja egy szo beallitott bitjeit (bajtonkent 0..8)
+ *
+ * \param bits uint64_t a szo
+ * \return uint64_t a bajtonkenti bitszamok
+ *
+ */
+static inline uint64_t kernel_byte_counts(uint64_t bits) {
+    bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+    bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+    return (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+}
+
+/** \brief Osszeadja a bajtonkenti szamlalokat (legfeljebb 31 kernel_byte_counts eredmeny osszeget)
+ *
+ * \param counts uint64_t a bajtonkenti szamlalok
+ * \return int az osszeg
+ *
+ */
+static inline int kernel_byte_sum(uint64_t counts) {
+    counts = (counts & 0x00FF00FF00FF00FFULL) + ((counts >> 8) & 0x00FF00FF00FF00FFULL);
+    return (int)((counts * 0x0001000100010001ULL) >> 48);
+}
+
+/** \brief A csempe szamlalasa hordozhato 64 bites muveletekkel (lasd kernel_count_tile)
+ */
+static void kernel_count_swar(const uint64_t *old_row, const uint64_t *new_row, size_t stride, int rows,
+                              const uint64_t *masks, KernelTileCount *count) {
+    int r, i;
+    memset(count, 0, sizeof(*count));
+    for (r=0; r<rows; r++) {
+        uint64_t alive_counts = 0;
+        uint64_t born_counts = 0;
+        uint64_t any = 0;
+        for (i=0; i<GRID_TILE_WORDS; i++) {
+            uint64_t old_word = old_row[i] & masks[i];
+            uint64_t new_word = new_row[i] & masks[i];
+            count->columns[i] |= new_word;
+            any |= new_word;
+            alive_counts += kernel_byte_counts(new_word);
+            born_counts += kernel_byte_counts(new_word & ~old_word);
+        }
+        count->alive += kernel_byte_sum(alive_counts);
+        count->born += kernel_byte_sum(born_counts);
+        count->rows |= (uint32_t)(any != 0) << r;
+        old_row += stride;
+        new_row += stride;
+    }
+}
+
+/** \brief Egy szo bitjeinek pixelekke bontasa hordozhato modon (lasd kernel_expand_bits)
+ */
+static void kernel_expand_scalar(uint64_t alive, uint64_t seen, int count, const uint32_t *colors, uint32_t *pixels) {
+    int i;
+    for (i=0; i<count; i++) {
+        pixels[i] = (alive >> i) & 1 ? colors[2] : colors[(seen >> i) & 1];
+    }
+}
+
+/** \brief Kivalasztja egy bitszeletelt kernelcsalad szabalynak megfelelo tagjat
+ *
+ * \param rules const GridKernel* a beepitett szabalyu kernelek (KERNEL_RULES sorrendben)
+ * \param circuit GridKernel az aramkort kiertekelo kernel
+ * \return GridKernel a kernel (ha az aramkor sem hasznalhato, az altalanos kernel)
+ *
+ */
+static GridKernel kernel_bitslice(const GridKernel *rules, GridKernel circuit) {
+    if (kernel_rule_index >= 0) {
+        return rules[kernel_rule_index];
+    }
+    return kernel_circuit_ready ? circuit : kernel_life_scalar;
+}
+
+KernelType kernel_select(KernelType type) {
+    if (!kernel_rule_ready) {
+        // Az alapertelmezett szabaly tablaja az elso valasztaskor keszul el
+        kernel_set_rule(kernel_rule_current);
+    }
+    kernel_request = type;
+    // A csempek szamlalasa es a pixelekke bontas a szabalytol fuggetlenul a leggyorsabb elerheto utasitaskeszlettel tortenik
+    kernel_counter = kernel_count_swar;
+    kernel_expander = kernel_expand_scalar;
+#ifdef GOL_KERNEL_SIMD
+    if (SDL_HasSSE2()) {
+        kernel_expander = kernel_expand_sse2;
+    }
+    if (kernel_cpu_has_avx2()) {
+        kernel_counter = kernel_count_avx2;
+        kernel_expander = kernel_expand_avx2;
+    }
+#endif // GOL_KERNEL_SIMD
+    if (kernel_rule_current.ltl.range > 0) {
+        // A Larger than Life szabalyokat csak a dobozosszeges (cellankenti) kernel ismeri
+        kernel_func = kernel_ltl;
+        kernel_type = KERNEL_SCALAR;
+        return kernel_type;
+    }
+    if ((type == KERNEL_AUTO || !kernel_available(type)) && kernel_rule_index < 0 && !kernel_circuit_ready) {
+        // Bitszeletelt kernel nelkuli szabalynal a tablazatos kernel a leggyorsabb
+        type = KERNEL_LUT;
+    } else if (type == KERNEL_AUTO || !kernel_available(type)) {
+        // A leggyorsabb elerheto kernel
+        for (type=KERNEL_COUNT-1; type>KERNEL_SCALAR; type--) {
+            if (kernel_available(type)) {
+                break;
+            }
+        }
+    }
+    switch (type) {
+    case KERNEL_LUT:
+        kernel_lut_init();
+        kernel_func = kernel_life_lut;
+        break;
+    case KERNEL_SWAR:
+        kernel_func = kernel_bitslice(kernel_swar_rules, kernel_swar_circuit);
+        break;
+#ifdef GOL_KERNEL_SIMD
+    case KERNEL_SSE2:
+        kernel_func = kernel_bitslice(kernel_sse2_rules, kernel_sse2_circuit);
+        break;
+    case KERNEL_AVX2:
+        kernel_func = kernel_bitslice(kernel_avx2_rules, kernel_avx2_circuit);
+        break;
+    case KERNEL_AVX512:
+        kernel_func = kernel_bitslice(kernel_avx512_rules, kernel_avx512_circuit);
+        break;
+#endif // GOL_KERNEL_SIMD
+    default:
+        type = KERNEL_SCALAR;
+        kernel_func = kernel_life_scalar;
+        break;
+    }
+    kernel_type = type;
+    return type;
+}
+
+KernelType kernel_current(void) {
+    if (kernel_func == NULL) {
+        kernel_select(KERNEL_AUTO);
+    }
+    return kernel_type;
+}
+
+int kernel_available(KernelType type) {
+    switch (type) {
+    case KERNEL_AUTO:
+    case KERNEL_SCALAR:
+    case KERNEL_LUT:
+    case KERNEL_SWAR:
+        return 1;
+#ifdef GOL_KERNEL_SIMD
+    case KERNEL_SSE2:
+        return SDL_HasSSE2();
+    case KERNEL_AVX2:
+        return kernel_cpu_has_avx2();
+    case KERNEL_AVX512:
+        return kernel_cpu_has_avx512();
+#endif // GOL_KERNEL_SIMD
+    default:
+        return 0;
+    }
+}
+
+const char *kernel_name(KernelType type) {
+    switch (type) {
+    case KERNEL_AUTO:
+        return "automatikus";
+    case KERNEL_SCALAR:
+        return "cellankenti";
+    case KERNEL_LUT:
+        return "tablazatos (2x2)";
+    case KERNEL_SWAR:
+        return "64 bites (SWAR)";
+    case KERNEL_SSE2:
+        return "SSE2";
+    case KERNEL_AVX2:
+        return "AVX2";
+    case KERNEL_AVX512:
+        return "AVX-512";
+    default:
+        return "ismeretlen";
+    }
+}
+
+void kernel_set_rule(const Rule rule) {
+    // A haldoklo allapotokat a grid lepteti, a kernelek csak az elo cellakat szamoljak
+    Rule binary = rule;
+    int i;
+    binary.dying = 0;
+    kernel_rule_current = rule;
+    rule_table(binary, kernel_rule_table);
+    kernel_rule_ready = 1;
+    kernel_rule_index = -1;
+    for (i=0; i<(int)(sizeof(kernel_rules) / sizeof(kernel_rules[0])); i++) {
+        if (rule_equal(kernel_rules[i], binary)) {
+            kernel_rule_index = i;
+        }
+    }
+    kernel_circuit_ready = kernel_rule_index < 0 && rule_compile(binary, &kernel_circuit);
+#ifdef NDEBUG
+    if (kernel_rule_index < 0) {
+        fprintf(stderr, "Szabaly aramkor: %d kapu%s\n", kernel_circuit.gate_count, kernel_circuit_ready ? "" : " (sikertelen)");
+    }
+#endif // NDEBUG
+    // A tablazatos kernel tablaja es a kernel valasztas a szabalytol fugg
+    kernel_lut_ready = 0;
+    if (kernel_func != NULL) {
+        kernel_select(kernel_request);
+    }
+}
+
+Rule kernel_rule(void) {
+    return kernel_rule_current;
+}
+
+int kernel_specialized(void) {
+    KernelType type = kernel_current();
+    return type == KERNEL_SCALAR || type == KERNEL_LUT || kernel_rule_index >= 0;
+}
+
+int kernel_circuit_gates(void) {
+    return kernel_rule_index < 0 && kernel_circuit_ready ? kernel_circuit.gate_count : -1;
+}
+
+int kernel_reach(void) {
+    return kernel_rule_current.ltl.range > 0 ? kernel_rule_current.ltl.range : 1;
+}
+
+int kernel_step(Grid *grid, int word_begin, int word_end, int row_begin, int row_end) {
+    if (kernel_func == NULL) {
+        kernel_select(KERNEL_AUTO);
+    }
+    return kernel_func(grid, word_begin, word_end, row_begin, row_end);
+}
+
+void kernel_count_tile(const uint64_t *old_row, const uint64_t *new_row, size_t stride, int rows,
+                       const uint64_t *masks, KernelTileCount *count) {
+    if (kernel_counter == NULL) {
+        kernel_select(KERNEL_AUTO);
+    }
+    kernel_counter(old_row, new_row, stride, rows, masks, count);
+}
+
+void kernel_expand_bits(uint64_t alive, uint64_t seen, int count, const uint32_t *colors, uint32_t *pixels) {
+    if (kernel_expander == NULL) {
+        kernel_select(KERNEL_AUTO);
+    }
+    kernel_expander(alive, seen, count, colors, pixels);
+}
+
+double kernel_benchmark(KernelType type, int size, int generations) {
+    KernelType previous = kernel_request;
+    Grid *grid;
+    Uint64 start, end;
+    int i, j;
+    if (type <= KERNEL_AUTO || type >= KERNEL_COUNT || !kernel_available(type)) {
+        return 0;
+    }
+    grid = grid_new(size, size);
+    if (grid == NULL) {
+        return 0;
+    }
+    // Felig kitoltott, veletlen kezdoallapot; az azonos mag miatt minden kernel ugyanazt kapja
+    grid_init(grid);
+    srand(size);
+    for (j=0; j<size-2; j++) {
+        for (i=0; i<size-2; i++) {
+            if (rand() % 2) {
+                grid_set_alive(grid, i, j);
+            }
+        }
+    }
+
+    kernel_select(type);
+    start = SDL_GetPerformanceCounter();
+    for (i=0; i<generations; i++) {
+        grid_logic(grid);
+    }
+    end = SDL_GetPerformanceCounter();
+    kernel_select(previous);
+
+    kernel_bench_result[type] = (double)grid->size_x*grid->size_y*generations / ((double)(end - start) / SDL_GetPerformanceFrequency()) / 1e6;
+    grid_free(grid);
+    return kernel_bench_result[type];
+}
+
+double kernel_benchmark_result(KernelType type) {
+    if (type < 0 || type >= KERNEL_COUNT) {
+        return 0;
+    }
+    return kernel_bench_result[type];
+}
@@ -0,0 +1,226 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_kernel.h
+ * Description:     A grid leptetesenek kernelei es a kernel kivalasztasa
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#ifndef __GOL_KERNEL_H_INCLUDED__
+#define __GOL_KERNEL_H_INCLUDED__
+
+// A SIMD kernelek csak GCC-vel, x86 processzorokra fordulnak.
+// A GOL_NO_SIMD makroval intrinsic-mentes forditas kerheto, ilyenkor a hordozhato
+// 64 bites (SWAR) kernel a leggyorsabb.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(GOL_NO_SIMD)
+#define GOL_KERNEL_SIMD
+#endif
+
+/** \brief Egy csempet lepteto kernel
+ *
+ * A kernel a grid elso pufferebol olvas, es a hatso puffer, valamint a was_alive bitsik
+ * [word_begin, word_end) x [row_begin, row_end) tartomanyat irja.
+ * A visszateresi ertek jelzi, hogy a tartomanyban valtozott-e valamelyik cella;
+ * ez alapjan alszanak el a stabil csempek.
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param word_begin int a csempe elso szava (a sor elejetol, keret nelkul)
+ * \param word_end int a csempe utani elso szo
+ * \param row_begin int a csempe elso sora
+ * \param row_end int a csempe utani elso sor
+ * \return int 1, ha valtozott cella a tartomanyban; 0 egyebkent
+ *
+ */
+typedef int (*GridKernel)(Grid *grid, int word_begin, int word_end, int row_begin, int row_end);
+
+/** \brief Egy csempe szamlalasanak eredmenye (kernel_count_tile)
+ */
+typedef struct t_kernel_tile_count {
+    uint64_t columns[GRID_TILE_WORDS];  /**< Szavankent a csempe sorainak vagy kapcsolata (az elo cellak oszlopai) */
+    uint32_t rows;                      /**< A nem ures sorok bitmaszkja */
+    int alive;                          /**< Az elo cellak szama */
+    int born;                           /**< A regi allapotban halott, az ujban elo cellak szama */
+} KernelTileCount;
+
+/** \brief Egy csempe cellait szamlalo fuggveny (lasd kernel_count_tile) */
+typedef void (*KernelCounter)(const uint64_t *old_row, const uint64_t *new_row, size_t stride, int rows,
+                              const uint64_t *masks, KernelTileCount *count);
+
+/** \brief Egy szo bitjeit pixelekke bonto fuggveny (lasd kernel_expand_bits) */
+typedef void (*KernelExpander)(uint64_t alive, uint64_t seen, int count, const uint32_t *colors, uint32_t *pixels);
+
+/** \brief A gyakori szabalyok, amelyekhez a bitszeletelt kernelek kulon, beepitett szabalyu valtozatot kapnak
+ *
+ * X(nev, szuletes maszk, tuleles maszk). A tobbi szabaly az altalanos, tablazatos kernelre esik vissza.
+ */
+#define KERNEL_RULES(X) \
+    X(life, 0x008, 0x00C)       /* B3/S23 */ \
+    X(highlife, 0x048, 0x00C)   /* B36/S23 */ \
+    X(daynight, 0x1C8, 0x1D8)   /* B3678/S34678 */ \
+    X(seeds, 0x004, 0x000)      /* B2/S */ \
+    X(nodeath, 0x008, 0x1FF)    /* B3/S012345678 */
+
+/** \brief Kivalasztja a leptetes kerneljet
+ *
+ * KERNEL_AUTO eseten, vagy ha a kert kernelt a processzor nem tamogatja,
+ * a leggyorsabb elerheto kernelt valasztja (kulon kernel nelkuli szabalynal a tablazatosat).
+ *
+ * \param type KernelType a kert kernel
+ * \return KernelType a tenylegesen kivalasztott kernel
+ *
+ */
+KernelType kernel_select(KernelType type);
+
+/** \brief Visszaadja az aktualisan hasznalt kernelt
+ *
+ * \return KernelType az aktualis kernel
+ *
+ */
+KernelType kernel_current(void);
+
+/** \brief Visszaadja, hogy a kernel futtathato-e ezen a gepen
+ *
+ * \param type KernelType a kernel
+ * \return int 1, ha futtathato
+ *
+ */
+int kernel_available(KernelType type);
+
+/** \brief Visszaadja a kernel megjelenitheto nevet
+ *
+ * \param type KernelType a kernel
+ * \return const char* a kernel neve
+ *
+ */
+const char *kernel_name(KernelType type);
+
+/** \brief Megmeri a kernel sebesseget egy veletlen kezdoallapotu gridon, egy szalon
+ *
+ * A meres idejere a kert kernelt valasztja ki, utana visszaallitja az elozot.
+ *
+ * \param type KernelType a mert kernel
+ * \param size int a grid oldalhossza
+ * \param generations int a mert generaciok szama
+ * \return double a sebesseg millio cella/masodpercben (0, ha a kernel nem futtathato)
+ *
+ */
+double kernel_benchmark(KernelType type, int size, int generations);
+
+/** \brief Visszaadja a kernel utolso meresenek eredmenyet
+ *
+ * \param type KernelType a kernel
+ * \return double a sebesseg millio cella/masodpercben (0, ha meg nem volt meres)
+ *
+ */
+double kernel_benchmark_result(KernelType type);
+
+/** \brief Lepteti a grid egy csempejet az aktualis kernellel
+ *
+ * \param grid Grid* a gridre mutato pointer
+ * \param word_begin int a csempe elso szava
+ * \param word_end int a csempe utani elso szo
+ * \param row_begin int a csempe elso sora
+ * \param row_end int a csempe utani elso sor
+ * \return int 1, ha valtozott cella a csempeben
+ *
+ */
+int kernel_step(Grid *grid, int word_begin, int word_end, int row_begin, int row_end);
+
+/** \brief Megszamolja egy csempe elo es szuletett cellait, es kigyujti a nem ures sorait es oszlopait
+ *
+ * A csempe GRID_TILE_WORDS szo szeles, a szamlalast a kivalasztott kernelhez illo
+ * utasitaskeszlet vegzi (AVX2 eseten bajtonkenti tablazatos bitszamlalas).
+ *
+ * \param old_row const uint64_t* a regi allapot csempejenek elso szava
+ * \param new_row const uint64_t* az uj allapot csempejenek elso szava
+ * \param stride size_t a sorok tavolsaga szavakban
+ * \param rows int a sorok szama (legfeljebb GRID_TILE_ROWS)
+ * \param masks const uint64_t* szavankent a szamlalt bitek maszkja
+ * \param count KernelTileCount* ide kerul az eredmeny
+ * \return void
+ *
+ */
+void kernel_count_tile(const uint64_t *old_row, const uint64_t *new_row, size_t stride, int rows,
+                       const uint64_t *masks, KernelTileCount *count);
+
+/** \brief Egy sor (legfeljebb 64) cellajat ARGB pixelekke alakitja
+ *
+ * Az i. pixel az elo cellaknal colors[2], a valaha elt cellaknal colors[1], a tobbinel colors[0].
+ * A bontast a processzor leggyorsabb tamogatott utasitaskeszlete vegzi (SSE2: 4, AVX2: 8 pixel egyszerre).
+ *
+ * \param alive uint64_t az elo cellak bitjei (a 0. bit az elso pixel)
+ * \param seen uint64_t a valaha elt cellak bitjei
+ * \param count int a pixelek szama (0..64)
+ * \param colors const uint32_t* a harom szin (hatter, valaha elt, elo)
+ * \param pixels uint32_t* ide kerulnek a pixelek
+ * \return void
+ *
+ */
+void kernel_expand_bits(uint64_t alive, uint64_t seen, int count, const uint32_t *colors, uint32_t *pixels);
+
+/** \brief Beallitja a leptetes szabalyat, es ujravalasztja a kernelt
+ *
+ * A KERNEL_RULES szabalyaihoz a bitszeletelt kernelek beepitett szabalyu valtozata,
+ * a tobbihez a szabalybol forditott logikai aramkort kiertekelo valtozatuk fut.
+ * A Hensel-jelolesu szabalyokat csak a cellankenti es a tablazatos kernel ismeri,
+ * ezek a szabalyt egyszer, a beallitaskor forditjak 512 elemu kornyezettablava.
+ * A Larger than Life szabalyokat egy kulon, futo dobozosszegeket hasznalo cellankenti kernel lepteti.
+ *
+ * \param rule const Rule az uj szabaly
+ * \return void
+ *
+ */
+void kernel_set_rule(const Rule rule);
+
+/** \brief Visszaadja a leptetes szabalyat
+ *
+ * \return Rule az aktualis szabaly
+ *
+ */
+Rule kernel_rule(void);
+
+/** \brief Visszaadja, hogy a szabaly beepitett (forditasi ideju) kernellel fut-e
+ *
+ * \return int 0, ha a bitszeletelt kernel a futasidoben forditott aramkort ertekeli ki
+ *
+ */
+int kernel_specialized(void);
+
+/** \brief Visszaadja a szabalybol forditott aramkor kapuinak szamat
+ *
+ * \return int a kapuk szama (-1, ha a szabaly nem aramkorrel fut)
+ *
+ */
+int kernel_circuit_gates(void);
+
+/** \brief Visszaadja, milyen messzirol hat egy cella a szomszedaira az aktualis szabalyban
+ *
+ * \return int a kornyezet sugara (1, vagy a Larger than Life szabaly sugara)
+ *
+ */
+int kernel_reach(void);
+
+/* Az aktualis szabaly aramkore, ezt a *_circuit kernelek olvassak (a kernel_set_rule irja) */
+extern RuleCircuit kernel_circuit;
+
+/* A hordozhato bitszeletelt kernelek (gol_kernel.c), a KERNEL_RULES sorrendjeben, es az aramkoros valtozat */
+extern const GridKernel kernel_swar_rules[];
+int kernel_swar_circuit(Grid *grid, int word_begin, int word_end, int row_begin, int row_end);
+
+#ifdef GOL_KERNEL_SIMD
+/* A gol_kernel_simd.c kernelei es processzor tesztjei */
+extern const GridKernel kernel_sse2_rules[];
+extern const GridKernel kernel_avx2_rules[];
+extern const GridKernel kernel_avx512_rules[];
+int kernel_sse2_circuit(Grid *grid, int word_begin, int word_end, int row_begin, int row_end);
+int kernel_avx2_circuit(Grid *grid, int word_begin, int word_end, int row_begin, int row_end);
+int kernel_avx512_circuit(Grid *grid, int word_begin, int word_end, int row_begin, int row_end);
+void kernel_count_avx2(const uint64_t *old_row, const uint64_t *new_row, size_t stride, int rows,
+                       const uint64_t *masks, KernelTileCount *count);
+void kernel_expand_sse2(uint64_t alive, uint64_t seen, int count, const uint32_t *colors, uint32_t *pixels);
+void kernel_expand_avx2(uint64_t alive, uint64_t seen, int count, const uint32_t *colors, uint32_t *pixels);
+int kernel_cpu_has_avx2(void);
+int kernel_cpu_has_avx512(void);
+#endif // GOL_KERNEL_SIMD
+
+#endif // __GOL_KERNEL_H_INCLUDED__
@@ -0,0 +1,241 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_kernel_bitslice.h
+ * Description:     A bitszeletelt kernel torzse, utasitaskeszlettol fuggetlenul
+ *
+ * Copyright Telek Istvan 2015
+ *
+ * Ez a fajl szandekosan nem tartalmaz include vedelmet: minden utasitaskeszletre
+ * egyszer kell beszerkeszteni, elotte a kovetkezo makrokat definialva:
+ *  - KERNEL_NAME        a letrehozott fuggvenyek nevenek eleje; a KERNEL_RULES
+ *                       minden szabalyahoz egy KERNEL_NAME_<szabaly> kernel keszul,
+ *                       es ezek a KERNEL_NAME_rules tombbe kerulnek; a tobbi szabalyt
+ *                       a KERNEL_NAME_circuit kernel a kernel_circuit aramkorevel szamolja
+ *  - VEC                a vektor tipusa
+ *  - VWORDS             a vektorban levo 64 bites szavak szama
+ *  - VLOAD(p)           VWORDS szo betoltese (igazitatlan cimrol is)
+ *  - VSTORE(p, v)       VWORDS szo tarolasa (igazitatlan cimre is)
+ *  - VAND, VOR, VXOR    bitenkenti muveletek
+ *  - VANDNOT(a, b)      (~a) & b
+ *  - VSHL(v, n), VSHR(v, n)  szavankenti eltolas
+ * Opcionalisan felulirhato: VXOR3(a, b, c) es VMAJ(a, b, c) (teljes osszeado).
+ * A beszerkesztes vegen a makrok torlodnek.
+ **********************************/
+
+#ifndef VXOR3
+#define VXOR3(a, b, c) VXOR(VXOR(a, b), c)
+#endif
+#ifndef VMAJ
+#define VMAJ(a, b, c) VOR(VAND(a, b), VAND(c, VXOR(a, b)))
+#endif
+
+#define KERNEL_PASTE_(a, b) a ## _ ## b
+#define KERNEL_PASTE(a, b) KERNEL_PASTE_(a, b)
+
+/* Azok a cellak, ahol a kilenc cella osszege (sum = s0 + 2*s1 + 4*s2 + 8*s3) eppen n (0..9):
+ * a n-ben 0 erteku bitek VAGY-a tagadva, es az 1 erteku bitek ES-e. A hianyzo tagok helyen
+ * zero, illetve ones all, ezeket a fordito kiejti. */
+#define KERNEL_SUM_IS(n) VANDNOT( \
+        VOR(VOR((n) & 1 ? zero : s0, (n) & 2 ? zero : s1), VOR((n) & 4 ? zero : s2, (n) & 8 ? zero : s3)), \
+        VAND(VAND((n) & 1 ? s0 : ones, (n) & 2 ? s1 : ones), VAND((n) & 4 ? s2 : ones, (n) & 8 ? s3 : ones)))
+
+/* A szabaly egy osszeg-erteke: a halott cella n szomszednal szuletik, az elo cella n-1 szomszednal marad.
+ * A birth es survive forditasi ideju allandok, igy a felteteleket es a felesleges muveleteket a fordito elhagyja. */
+#define KERNEL_RULE_TERM(n) do { \
+        int born_ = (n) <= 8 && ((birth >> (n)) & 1); \
+        int kept_ = (n) >= 1 && ((survive >> ((n) - 1)) & 1); \
+        if (born_ && kept_) { \
+            next = VOR(next, KERNEL_SUM_IS(n)); \
+        } else if (born_) { \
+            next = VOR(next, VANDNOT(center, KERNEL_SUM_IS(n))); \
+        } else if (kept_) { \
+            next = VOR(next, VAND(center, KERNEL_SUM_IS(n))); \
+        } \
+    } while (0)
+
+/** \brief Kiertekeli a futasidoben forditott szabaly aramkoret
+ *
+ * \param circuit const RuleCircuit* az aramkor
+ * \param regs VEC* a bemenetek (0..6) es a kapuk eredmenyeinek helye
+ * \return VEC a kovetkezo allapot
+ */
+static inline VEC KERNEL_PASTE(KERNEL_NAME, eval)(const RuleCircuit *circuit, VEC *regs) {
+    int g;
+    for (g=0; g<circuit->gate_count; g++) {
+        const RuleGate gate = circuit->gates[g];
+        VEC a = regs[gate.a];
+        VEC b = regs[gate.b];
+        switch (gate.op) {
+        case RULE_GATE_AND:
+            regs[RULE_CIRCUIT_INPUTS + g] = VAND(a, b);
+            break;
+        case RULE_GATE_OR:
+            regs[RULE_CIRCUIT_INPUTS + g] = VOR(a, b);
+            break;
+        case RULE_GATE_XOR:
+            regs[RULE_CIRCUIT_INPUTS + g] = VXOR(a, b);
+            break;
+        default:
+            regs[RULE_CIRCUIT_INPUTS + g] = VANDNOT(a, b);
+            break;
+        }
+    }
+    return regs[circuit->output];
+}
+
+/* Egy sor harom szomszedos cellajanak (bal, kozep, jobb) osszege ketbites szamkent */
+#define KERNEL_ROW_SUM(p, s0, s1) do { \
+        VEC mid_ = VLOAD(p); \
+        VEC left_ = VOR(VSHL(mid_, 1), VSHR(VLOAD((p)-1), 63)); \
+        VEC right_ = VOR(VSHR(mid_, 1), VSHL(VLOAD((p)+1), 63)); \
+        s0 = VXOR3(left_, mid_, right_); \
+        s1 = VMAJ(left_, mid_, right_); \
+    } while (0)
+
+/** \brief Bitszeletelt kernel: VWORDS*64 cellat lep egyszerre
+ *
+ * A csempet vektornyi oszlopokban, fentrol lefele jarja be. Minden sor vizszintes
+ * harmas osszege csak egyszer keszul el, es a kovetkezo ket kimeneti sor is felhasznalja.
+ * A harom sor osszegebol (a kozepso cellaval egyutt 0..9) teljes osszeadokkal
+ * negybites szamlalo lesz, ebbol adodik a kovetkezo allapot.
+ * A regi es az uj allapot kulonbseget osszegyujti, ebbol derul ki, valtozott-e a csempe.
+ * Mindig beepul a szabalyonkenti kernelekbe, igy a birth es survive forditasi ideju allando.
+ * Ha a circuit nem NULL, a szabalyt a birth es survive helyett az aramkor adja.
+ */
+static inline __attribute__((always_inline)) int KERNEL_PASTE(KERNEL_NAME, body)(Grid *grid, int word_begin, int word_end, int row_begin, int row_end, const unsigned birth, const unsigned survive, const RuleCircuit *circuit) {
+    const int stride = grid->stride;
+    const int words = grid_words(grid->size_x);
+    int i, r, k;
+    uint64_t diff_words[VWORDS] = {0};
+    uint64_t ones_words[VWORDS];
+    VEC diff = VLOAD(diff_words);
+    const VEC zero = VLOAD(diff_words);
+    for (k=0; k<VWORDS; k++) {
+        ones_words[k] = ~(uint64_t)0;
+    }
+    const VEC ones = VLOAD(ones_words);
+    VEC regs[RULE_CIRCUIT_INPUTS + RULE_CIRCUIT_MAX_GATES];
+    regs[5] = zero;
+    regs[6] = ones;
+    if (row_end > grid->size_y) {
+        row_end = grid->size_y;
+    }
+    // A grid szelen tuli szavak mindig halottak, azokat nem kell szamolni
+    if (word_end > words) {
+        word_end = word_begin + (words - word_begin + VWORDS - 1) / VWORDS * VWORDS;
+    }
+    for (i=word_begin; i<word_end; i+=VWORDS) {
+        // Az utolso, reszben ervenyes szavakat maszkolni kell
+        int masked = (i+VWORDS)*GRID_WORD_BITS > grid->size_x;
+        uint64_t mask_words[VWORDS];
+        for (k=0; k<VWORDS; k++) {
+            int bits = grid->size_x - (i+k)*GRID_WORD_BITS;
+            mask_words[k] = bits >= GRID_WORD_BITS ? ~(uint64_t)0 : bits <= 0 ? 0 : ((uint64_t)1 << bits) - 1;
+        }
+        const VEC mask = VLOAD(mask_words);
+
+        const uint64_t *src = grid_row(grid, grid->cells, row_begin-1) + GRID_HALO_WORDS + i;
+        uint64_t *dst = grid_row(grid, grid->next_cells, row_begin) + GRID_HALO_WORDS + i;
+        uint64_t *was_alive = grid_row(grid, grid->was_alive, row_begin) + GRID_HALO_WORDS + i;
+        VEC up0, up1, mid0, mid1, down0, down1;
+        KERNEL_ROW_SUM(src, up0, up1);
+        src += stride;
+        KERNEL_ROW_SUM(src, mid0, mid1);
+        for (r=row_begin; r<row_end; r++) {
+            KERNEL_ROW_SUM(src+stride, down0, down1);
+
+            // A harom ketbites osszeg osszeadasa: sum = s0 + 2*s1 + 4*s2 + 8*s3
+            VEC s0 = VXOR3(up0, mid0, down0);
+            VEC carry = VMAJ(up0, mid0, down0);
+            VEC half0 = VXOR(up1, mid1);
+            VEC half1 = VXOR(down1, carry);
+            VEC both0 = VAND(up1, mid1);
+            VEC both1 = VAND(down1, carry);
+            VEC s1 = VXOR(half0, half1);
+            VEC s2 = VXOR3(both0, both1, VAND(half0, half1));
+            VEC s3 = VAND(both0, both1);
+
+            // A szabaly: az osszeg lehetseges ertekei kozul csak a szabalyban szereplok maradnak meg
+            VEC center = VLOAD(src);
+            VEC next = zero;
+            if (circuit != NULL) {
+                regs[0] = s0;
+                regs[1] = s1;
+                regs[2] = s2;
+                regs[3] = s3;
+                regs[4] = center;
+                next = KERNEL_PASTE(KERNEL_NAME, eval)(circuit, regs);
+            } else {
+                KERNEL_RULE_TERM(0);
+                KERNEL_RULE_TERM(1);
+                KERNEL_RULE_TERM(2);
+                KERNEL_RULE_TERM(3);
+                KERNEL_RULE_TERM(4);
+                KERNEL_RULE_TERM(5);
+                KERNEL_RULE_TERM(6);
+                KERNEL_RULE_TERM(7);
+                KERNEL_RULE_TERM(8);
+                KERNEL_RULE_TERM(9);
+            }
+            if (masked) {
+                // A szel utani cella (zart topologiaknal a keret masolata) nem szamit valtozasnak
+                next = VAND(next, mask);
+                center = VAND(center, mask);
+            }
+            VSTORE(dst, next);
+            VSTORE(was_alive, VOR(VLOAD(was_alive), next));
+            diff = VOR(diff, VXOR(next, center));
+
+            up0 = mid0;
+            up1 = mid1;
+            mid0 = down0;
+            mid1 = down1;
+            src += stride;
+            dst += stride;
+            was_alive += stride;
+        }
+    }
+
+    VSTORE(diff_words, diff);
+    for (k=1; k<VWORDS; k++) {
+        diff_words[0] |= diff_words[k];
+    }
+    return diff_words[0] != 0;
+}
+
+/* A KERNEL_RULES minden szabalyara egy kernel, es a kerneleket a szabalyok sorrendjeben tartalmazo tomb */
+#define KERNEL_RULE_FUNC(name, birth, survive) \
+    static int KERNEL_PASTE(KERNEL_NAME, name)(Grid *grid, int word_begin, int word_end, int row_begin, int row_end) { \
+        return KERNEL_PASTE(KERNEL_NAME, body)(grid, word_begin, word_end, row_begin, row_end, birth, survive, NULL); \
+    }
+#define KERNEL_RULE_ENTRY(name, birth, survive) KERNEL_PASTE(KERNEL_NAME, name),
+KERNEL_RULES(KERNEL_RULE_FUNC)
+const GridKernel KERNEL_PASTE(KERNEL_NAME, rules)[] = {
+    KERNEL_RULES(KERNEL_RULE_ENTRY)
+};
+
+/* Barmely szabaly, a kernel_circuit aramkorebol */
+int KERNEL_PASTE(KERNEL_NAME, circuit)(Grid *grid, int word_begin, int word_end, int row_begin, int row_end) {
+    return KERNEL_PASTE(KERNEL_NAME, body)(grid, word_begin, word_end, row_begin, row_end, 0, 0, &kernel_circuit);
+}
+
+#undef KERNEL_RULE_FUNC
+#undef KERNEL_RULE_ENTRY
+#undef KERNEL_RULE_TERM
+#undef KERNEL_SUM_IS
+#undef KERNEL_PASTE
+#undef KERNEL_PASTE_
+#undef KERNEL_ROW_SUM
+#undef KERNEL_NAME
+#undef VEC
+#undef VWORDS
+#undef VLOAD
+#undef VSTORE
+#undef VAND
+#undef VOR
+#undef VXOR
+#undef VANDNOT
+#undef VSHL
+#undef VSHR
+#undef VXOR3
+#undef VMAJ
@@ -0,0 +1,204 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_kernel_simd.c
+ * Description:     A bitszeletelt kernelek SSE2, AVX2 es AVX-512 valtozatai
+ *
+ * Copyright Telek Istvan 2015
+ *
+ * A fuggvenyek a GCC target pragmaival fordulnak, igy a program tobbi resze
+ * kulon forditasi kapcsolok nelkul is futtathato marad a regebbi processzorokon.
+ * A kernel kivalasztasa futasidoben, a gol_kernel.c-ben tortenik.
+ **********************************/
+#include "gol_main.h"
+#include "gol_grid.h"
+#include "gol_kernel.h"
+
+#ifdef GOL_KERNEL_SIMD
+#include <cpuid.h>
+#include <immintrin.h>
+
+/** \brief Lekerdezi az operacios rendszer altal mentett regiszterallapotokat (XCR0)
+ *
+ * \return uint64_t az XCR0 regiszter erteke
+ *
+ */
+static uint64_t kernel_xgetbv(void) {
+    uint32_t eax, edx;
+    __asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+}
+
+/** \brief Lekerdezi a CPUID 7. levelenek EBX regiszteret (bovitett utasitaskeszletek)
+ *
+ * \return uint32_t az EBX regiszter (0, ha a level nem letezik)
+ *
+ */
+static uint32_t kernel_cpuid7_ebx(void) {
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, NULL) < 7) {
+        return 0;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return ebx;
+}
+
+int kernel_cpu_has_avx2(void) {
+#if SDL_VERSION_ATLEAST(2, 0, 4)
+    return SDL_HasAVX2();
+#else
+    // Az SDL 2.0.4 elott nincs SDL_HasAVX2, az SDL_HasAVX az operacios rendszer tamogatasat is ellenorzi
+    return SDL_HasAVX() && (kernel_cpuid7_ebx() & (1 << 5));
+#endif
+}
+
+int kernel_cpu_has_avx512(void) {
+    // AVX-512F, es az operacios rendszer menti az opmask es zmm regisztereket
+    return SDL_HasAVX() && (kernel_cpuid7_ebx() & (1 << 16)) && (kernel_xgetbv() & 0xE6) == 0xE6;
+}
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#define KERNEL_NAME kernel_sse2
+#define VEC __m128i
+#define VWORDS 2
+#define VLOAD(p) _mm_loadu_si128((const __m128i *)(p))
+#define VSTORE(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define VAND(a, b) _mm_and_si128(a, b)
+#define VOR(a, b) _mm_or_si128(a, b)
+#define VXOR(a, b) _mm_xor_si128(a, b)
+#define VANDNOT(a, b) _mm_andnot_si128(a, b)
+#define VSHL(v, n) _mm_slli_epi64(v, n)
+#define VSHR(v, n) _mm_srli_epi64(v, n)
+#include "gol_kernel_bitslice.h"
+
+void kernel_expand_sse2(uint64_t alive, uint64_t seen, int count, const uint32_t *colors, uint32_t *pixels) {
+    // A negy pixel bitjei a savokban: a bit helyen all maszk utan osszehasonlitas adja a pixel maszkjat
+    const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+    const __m128i background = _mm_set1_epi32((int)colors[0]);
+    const __m128i dead_color = _mm_set1_epi32((int)colors[1]);
+    const __m128i alive_color = _mm_set1_epi32((int)colors[2]);
+    int i;
+    for (i=0; i+4<=count; i+=4) {
+        __m128i a = _mm_and_si128(_mm_set1_epi32((int)((alive >> i) & 0xF)), bits);
+        __m128i s = _mm_and_si128(_mm_set1_epi32((int)((seen >> i) & 0xF)), bits);
+        __m128i a_mask = _mm_cmpeq_epi32(a, bits);
+        __m128i s_mask = _mm_cmpeq_epi32(s, bits);
+        __m128i color = _mm_or_si128(_mm_and_si128(s_mask, dead_color), _mm_andnot_si128(s_mask, background));
+        color = _mm_or_si128(_mm_and_si128(a_mask, alive_color), _mm_andnot_si128(a_mask, color));
+        _mm_storeu_si128((__m128i *)(pixels + i), color);
+    }
+    for (; i<count; i++) {
+        pixels[i] = (alive >> i) & 1 ? colors[2] : colors[(seen >> i) & 1];
+    }
+}
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define KERNEL_NAME kernel_avx2
+#define VEC __m256i
+#define VWORDS 4
+#define VLOAD(p) _mm256_loadu_si256((const __m256i *)(p))
+#define VSTORE(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define VAND(a, b) _mm256_and_si256(a, b)
+#define VOR(a, b) _mm256_or_si256(a, b)
+#define VXOR(a, b) _mm256_xor_si256(a, b)
+#define VANDNOT(a, b) _mm256_andnot_si256(a, b)
+#define VSHL(v, n) _mm256_slli_epi64(v, n)
+#define VSHR(v, n) _mm256_srli_epi64(v, n)
+#include "gol_kernel_bitslice.h"
+
+/** \brief Bajtonkent megszamolja egy vektor beallitott bitjeit (felbajtonkenti tablazattal)
+ *
+ * \param v __m256i a vektor
+ * \return __m256i a bajtonkenti bitszamok (0..8)
+ *
+ */
+static inline __m256i kernel_avx2_byte_counts(__m256i v) {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(v, low)),
+                           _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+}
+
+void kernel_count_avx2(const uint64_t *old_row, const uint64_t *new_row, size_t stride, int rows,
+                       const uint64_t *masks, KernelTileCount *count) {
+    const __m256i mask_lo = _mm256_loadu_si256((const __m256i *)masks);
+    const __m256i mask_hi = _mm256_loadu_si256((const __m256i *)(masks + 4));
+    __m256i columns_lo = _mm256_setzero_si256();
+    __m256i columns_hi = _mm256_setzero_si256();
+    __m256i alive = _mm256_setzero_si256();
+    __m256i born = _mm256_setzero_si256();
+    uint64_t sums[4];
+    uint32_t row_bits = 0;
+    int r;
+    // A csempe egy sora (GRID_TILE_WORDS = 8 szo) ket AVX2 vektor
+    for (r=0; r<rows; r++) {
+        __m256i new_lo = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)new_row), mask_lo);
+        __m256i new_hi = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(new_row + 4)), mask_hi);
+        __m256i old_lo = _mm256_loadu_si256((const __m256i *)old_row);
+        __m256i old_hi = _mm256_loadu_si256((const __m256i *)(old_row + 4));
+        __m256i any = _mm256_or_si256(new_lo, new_hi);
+        columns_lo = _mm256_or_si256(columns_lo, new_lo);
+        columns_hi = _mm256_or_si256(columns_hi, new_hi);
+        // Bajtonkent legfeljebb 16, a sad_epu8 64 bites savonkent osszegzi oket
+        alive = _mm256_add_epi64(alive, _mm256_sad_epu8(_mm256_add_epi8(kernel_avx2_byte_counts(new_lo),
+                                                                        kernel_avx2_byte_counts(new_hi)),
+                                                        _mm256_setzero_si256()));
+        born = _mm256_add_epi64(born, _mm256_sad_epu8(_mm256_add_epi8(kernel_avx2_byte_counts(_mm256_andnot_si256(old_lo, new_lo)),
+                                                                      kernel_avx2_byte_counts(_mm256_andnot_si256(old_hi, new_hi))),
+                                                      _mm256_setzero_si256()));
+        row_bits |= (uint32_t)!_mm256_testz_si256(any, any) << r;
+        old_row += stride;
+        new_row += stride;
+    }
+    _mm256_storeu_si256((__m256i *)count->columns, columns_lo);
+    _mm256_storeu_si256((__m256i *)(count->columns + 4), columns_hi);
+    count->rows = row_bits;
+    _mm256_storeu_si256((__m256i *)sums, alive);
+    count->alive = (int)(sums[0] + sums[1] + sums[2] + sums[3]);
+    _mm256_storeu_si256((__m256i *)sums, born);
+    count->born = (int)(sums[0] + sums[1] + sums[2] + sums[3]);
+}
+
+void kernel_expand_avx2(uint64_t alive, uint64_t seen, int count, const uint32_t *colors, uint32_t *pixels) {
+    // Nyolc pixel egyszerre, a szinek bajtonkenti kevereset a vpblendvb vegzi
+    const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i background = _mm256_set1_epi32((int)colors[0]);
+    const __m256i dead_color = _mm256_set1_epi32((int)colors[1]);
+    const __m256i alive_color = _mm256_set1_epi32((int)colors[2]);
+    int i;
+    for (i=0; i+8<=count; i+=8) {
+        __m256i a = _mm256_and_si256(_mm256_set1_epi32((int)((alive >> i) & 0xFF)), bits);
+        __m256i s = _mm256_and_si256(_mm256_set1_epi32((int)((seen >> i) & 0xFF)), bits);
+        __m256i color = _mm256_blendv_epi8(background, dead_color, _mm256_cmpeq_epi32(s, bits));
+        color = _mm256_blendv_epi8(color, alive_color, _mm256_cmpeq_epi32(a, bits));
+        _mm256_storeu_si256((__m256i *)(pixels + i), color);
+    }
+    for (; i<count; i++) {
+        pixels[i] = (alive >> i) & 1 ? colors[2] : colors[(seen >> i) & 1];
+    }
+}
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define KERNEL_NAME kernel_avx512
+#define VEC __m512i
+#define VWORDS 8
+#define VLOAD(p) _mm512_loadu_si512((const void *)(p))
+#define VSTORE(p, v) _mm512_storeu_si512((void *)(p), v)
+#define VAND(a, b) _mm512_and_si512(a, b)
+#define VOR(a, b) _mm512_or_si512(a, b)
+#define VXOR(a, b) _mm512_xor_si512(a, b)
+#define VANDNOT(a, b) _mm512_andnot_si512(a, b)
+#define VSHL(v, n) _mm512_slli_epi64(v, n)
+#define VSHR(v, n) _mm512_srli_epi64(v, n)
+// A harmas XOR es a tobbsegi fuggveny egyetlen vpternlog utasitas
+#define VXOR3(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0x96)
+#define VMAJ(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0xE8)
+#include "gol_kernel_bitslice.h"
+#pragma GCC pop_options
+
+#endif // GOL_KERNEL_SIMD
@@ -0,0 +1,472 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_lenia.c
+ * Description:     A folytonos (Lenia) mezovel kapcsolatos fuggvenyek es definiciok
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "gol_main.h"
+#include "gol_grid.h"
+#include "gol_thread.h"
+#include "gol_lenia.h"
+
+// Egy oszlopfeladat ennyi szomszedos oszlopot dolgoz fel, igy a sorok olvasasa folytonosabb
+#define LENIA_COLUMN_BLOCK 8
+
+static const double LENIA_PI = 3.14159265358979323846;
+
+/** \brief Visszaadja a meret feletti legkisebb 2 hatvanyt a megengedett tartomanyban
+ *
+ * \param size int a kivant meret
+ * \return int a mezo oldalhossza
+ *
+ */
+static int lenia_round_size(int size) {
+    int n = LENIA_SIZE_MIN;
+    while (n < size && n < LENIA_SIZE_MAX) {
+        n *= 2;
+    }
+    return n;
+}
+
+/** \brief Lefoglalja es kitolti egy n pontos FFT tablazatait
+ *
+ * \param n int a pontok szama (2 hatvanya)
+ * \param twiddle float** ide kerulnek az exp(-2*pi*i*k/n) egyseggyokok (n/2 komplex szam)
+ * \param bitrev int** ide kerul a bitfordito permutacio
+ * \return int 1, ha sikerult; 0 hiba eseten
+ *
+ */
+static int lenia_fft_tables(int n, float **twiddle, int **bitrev) {
+    int bits = 0;
+    int i, b;
+    while ((1 << bits) < n) {
+        bits++;
+    }
+    *twiddle = malloc(sizeof(float)*n);
+    *bitrev = malloc(sizeof(int)*n);
+    if (*twiddle == NULL || *bitrev == NULL) {
+        return 0;
+    }
+    for (i=0; i<n/2; i++) {
+        (*twiddle)[2*i] = (float)cos(2*LENIA_PI*i/n);
+        (*twiddle)[2*i+1] = (float)-sin(2*LENIA_PI*i/n);
+    }
+    for (i=0; i<n; i++) {
+        int reversed = 0;
+        for (b=0; b<bits; b++) {
+            reversed |= ((i >> b) & 1) << (bits-1-b);
+        }
+        (*bitrev)[i] = reversed;
+    }
+    return 1;
+}
+
+/** \brief Helyben vegzett, ketto alapu komplex FFT (skalazas nelkul)
+ *
+ * \param data float* n komplex szam (valos, kepzetes) egymas utan
+ * \param n int a pontok szama (2 hatvanya)
+ * \param twiddle const float* az egyseggyokok tablazata
+ * \param bitrev const int* a bitfordito permutacio
+ * \param inverse int 1 eseten inverz transzformacio
+ * \return void
+ *
+ */
+static void lenia_fft(float *data, int n, const float *twiddle, const int *bitrev, int inverse) {
+    const float sign = inverse ? -1.0f : 1.0f;
+    int i, k, len;
+    for (i=0; i<n; i++) {
+        int j = bitrev[i];
+        if (i < j) {
+            float re = data[2*i], im = data[2*i+1];
+            data[2*i] = data[2*j];
+            data[2*i+1] = data[2*j+1];
+            data[2*j] = re;
+            data[2*j+1] = im;
+        }
+    }
+    for (len=2; len<=n; len*=2) {
+        const int half = len/2;
+        const int step = n/len;
+        for (i=0; i<n; i+=len) {
+            float *a = data + 2*i;
+            float *b = a + 2*half;
+            for (k=0; k<half; k++) {
+                const float wr = twiddle[2*k*step];
+                const float wi = sign*twiddle[2*k*step+1];
+                const float tr = b[2*k]*wr - b[2*k+1]*wi;
+                const float ti = b[2*k]*wi + b[2*k+1]*wr;
+                b[2*k] = a[2*k] - tr;
+                b[2*k+1] = a[2*k+1] - ti;
+                a[2*k] += tr;
+                a[2*k+1] += ti;
+            }
+        }
+    }
+}
+
+/** \brief Oszlopok FFT-je egy LENIA_COLUMN_BLOCK szeles savban
+ *
+ * Az oszlopokat a munkateruletre gyujti, transzformalja, konvolucio eseten a kernel spektrumaval
+ * szorozva vissza is transzformalja, majd visszairja.
+ *
+ * \param lenia Lenia* a mezore mutato pointer
+ * \param x_begin int a sav elso oszlopa
+ * \param scratch float* a munkaterulet (LENIA_COLUMN_BLOCK*size_y komplex szam)
+ * \param convolve int 0 eseten csak az elore iranyu transzformacio tortenik
+ * \return void
+ *
+ */
+static void lenia_column_block(Lenia *lenia, int x_begin, float *scratch, int convolve) {
+    const int n = lenia->size_y;
+    int c, y;
+    for (y=0; y<n; y++) {
+        const float *src = lenia->spectrum + 2*((size_t)y*lenia->size_x + x_begin);
+        for (c=0; c<LENIA_COLUMN_BLOCK; c++) {
+            scratch[2*(c*n + y)] = src[2*c];
+            scratch[2*(c*n + y)+1] = src[2*c+1];
+        }
+    }
+    for (c=0; c<LENIA_COLUMN_BLOCK; c++) {
+        float *column = scratch + 2*c*n;
+        lenia_fft(column, n, lenia->twiddle_y, lenia->bitrev_y, 0);
+        if (convolve) {
+            const float *kernel = lenia->kernel_spectrum + (size_t)(x_begin + c)*n;
+            for (y=0; y<n; y++) {
+                column[2*y] *= kernel[y];
+                column[2*y+1] *= kernel[y];
+            }
+            lenia_fft(column, n, lenia->twiddle_y, lenia->bitrev_y, 1);
+        }
+    }
+    for (y=0; y<n; y++) {
+        float *dst = lenia->spectrum + 2*((size_t)y*lenia->size_x + x_begin);
+        for (c=0; c<LENIA_COLUMN_BLOCK; c++) {
+            dst[2*c] = scratch[2*(c*n + y)];
+            dst[2*c+1] = scratch[2*(c*n + y)+1];
+        }
+    }
+}
+
+/** \brief Gondoskodik rola, hogy minden szalnak legyen oszlopblokk munkaterulete
+ *
+ * \param lenia Lenia* a mezore mutato pointer
+ * \param workers int a szalak szama
+ * \return int 1, ha sikerult; 0 hiba eseten
+ *
+ */
+static int lenia_reserve_scratch(Lenia *lenia, int workers) {
+    float *scratch;
+    if (workers <= lenia->scratch_workers) {
+        return 1;
+    }
+    scratch = realloc(lenia->scratch, sizeof(float)*2*LENIA_COLUMN_BLOCK*lenia->size_y*workers);
+    if (scratch == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a Lenia munkateruletenek letrehozasanal.\n");
+#endif // NDEBUG
+        return 0;
+    }
+    lenia->scratch = scratch;
+    lenia->scratch_workers = workers;
+    return 1;
+}
+
+/** \brief Kiszamolja a kernel spektrumat
+ *
+ * A kernel egy R sugaru gyuru: a kozepponttol d*R tavolsagban exp(4 - 1/(d*(1-d))) sulyu,
+ * az osszege 1. A (0, 0) kozeppontu kernel a torusz koordinatai szerint korbeer,
+ * igy a konvolucio eredmenye nem tolodik el.
+ *
+ * \param lenia Lenia* a mezore mutato pointer
+ * \param radius int a kernel sugara
+ * \return int 1, ha sikerult; 0 hiba eseten
+ *
+ */
+static int lenia_build_kernel(Lenia *lenia, int radius) {
+    const size_t cells = (size_t)lenia->size_x*lenia->size_y;
+    double sum = 0;
+    int x, y;
+    if (!lenia_reserve_scratch(lenia, 1)) {
+        return 0;
+    }
+    memset(lenia->spectrum, 0, sizeof(float)*2*cells);
+    for (y=-radius; y<=radius; y++) {
+        for (x=-radius; x<=radius; x++) {
+            double d = sqrt((double)(x*x + y*y))/radius;
+            if (d > 0 && d < 1) {
+                double weight = exp(4 - 1/(d*(1 - d)));
+                lenia->spectrum[2*((size_t)(y & (lenia->size_y-1))*lenia->size_x + (x & (lenia->size_x-1)))] = (float)weight;
+                sum += weight;
+            }
+        }
+    }
+    for (y=0; y<lenia->size_y; y++) {
+        lenia_fft(lenia->spectrum + 2*(size_t)y*lenia->size_x, lenia->size_x, lenia->twiddle_x, lenia->bitrev_x, 0);
+    }
+    for (x=0; x<lenia->size_x; x+=LENIA_COLUMN_BLOCK) {
+        lenia_column_block(lenia, x, lenia->scratch, 0);
+    }
+    // A normalizalas es az inverz FFT skalazasa egyszerre; oszloponkent tarolva, ahogy a konvolucio olvassa
+    for (y=0; y<lenia->size_y; y++) {
+        for (x=0; x<lenia->size_x; x++) {
+            lenia->kernel_spectrum[(size_t)x*lenia->size_y + y] = (float)(lenia->spectrum[2*((size_t)y*lenia->size_x + x)]/(sum*cells));
+        }
+    }
+    return 1;
+}
+
+/** \brief Kitolti a novekedesi fuggveny tablazatat (a lepeskozzel szorozva)
+ *
+ * \param lenia Lenia* a mezore mutato pointer
+ * \return void
+ *
+ */
+static void lenia_build_growth(Lenia *lenia) {
+    const LeniaParams *params = &lenia->params;
+    const double dt = 1.0/params->time_steps;
+    int i;
+    for (i=0; i<=LENIA_GROWTH_TABLE_SIZE; i++) {
+        double d = (double)i/LENIA_GROWTH_TABLE_SIZE - params->mu;
+        double q, g;
+        switch (params->growth) {
+        case LENIA_GROWTH_POLYNOMIAL:
+            q = 1 - d*d/(9*params->sigma*params->sigma);
+            g = q > 0 ? 2*q*q*q*q - 1 : -1;
+            break;
+        case LENIA_GROWTH_STEP:
+            g = fabs(d) <= params->sigma ? 1 : -1;
+            break;
+        default:
+            g = 2*exp(-d*d/(2*params->sigma*params->sigma)) - 1;
+            break;
+        }
+        lenia->growth_table[i] = (float)(dt*g);
+    }
+}
+
+/** \brief Kiszamolja egy cella uj erteket a potencialbol
+ *
+ * \param lenia const Lenia* a mezore mutato pointer
+ * \param value float a cella regi erteke
+ * \param potential float a konvolucio eredmenye (0..1)
+ * \return float az uj ertek
+ *
+ */
+static inline float lenia_grow(const Lenia *lenia, float value, float potential) {
+    float pos = potential*LENIA_GROWTH_TABLE_SIZE;
+    int i;
+    if (pos < 0) {
+        pos = 0;
+    } else if (pos > LENIA_GROWTH_TABLE_SIZE - 1) {
+        pos = LENIA_GROWTH_TABLE_SIZE - 1;
+    }
+    i = (int)pos;
+    value += lenia->growth_table[i] + (lenia->growth_table[i+1] - lenia->growth_table[i])*(pos - i);
+    return value < 0 ? 0 : value > 1 ? 1 : value;
+}
+
+/** \brief A szalkeszlet feladata: ket szomszedos sor elore iranyu FFT-je
+ *
+ * A ket valos sor egyetlen komplex FFT-vel transzformalhato (az egyik a valos, a masik a kepzetes resz),
+ * a ket spektrum a Z[k] es a Z[n-k] ertekekbol valaszthato szet.
+ *
+ * \param data void* a mezore mutato pointer
+ * \param task int a sorpar sorszama
+ * \param worker int a vegrehajto szal sorszama
+ * \return void
+ *
+ */
+static void lenia_forward_task(void *data, int task, int worker) {
+    Lenia *lenia = data;
+    const int n = lenia->size_x;
+    const float *a = lenia->field + (size_t)2*task*n;
+    const float *b = a + n;
+    float *za = lenia->spectrum + (size_t)4*task*n;
+    float *zb = za + 2*n;
+    int k;
+    (void)worker;
+    for (k=0; k<n; k++) {
+        za[2*k] = a[k];
+        za[2*k+1] = b[k];
+    }
+    lenia_fft(za, n, lenia->twiddle_x, lenia->bitrev_x, 0);
+    // A[k] = (Z[k] + conj(Z[n-k]))/2, B[k] = (Z[k] - conj(Z[n-k]))/2i, es mindketto konjugalt szimmetrikus
+    for (k=0; k<=n/2; k++) {
+        const int m = (n - k) & (n - 1);
+        const float zr = za[2*k], zi = za[2*k+1];
+        const float mr = za[2*m], mi = za[2*m+1];
+        const float ar = 0.5f*(zr + mr), ai = 0.5f*(zi - mi);
+        const float br = 0.5f*(zi + mi), bi = 0.5f*(mr - zr);
+        za[2*k] = ar;
+        za[2*k+1] = ai;
+        za[2*m] = ar;
+        za[2*m+1] = -ai;
+        zb[2*k] = br;
+        zb[2*k+1] = bi;
+        zb[2*m] = br;
+        zb[2*m+1] = -bi;
+    }
+}
+
+/** \brief A szalkeszlet feladata: egy oszlopsav konvolucioja a frekvenciatartomanyban
+ *
+ * \param data void* a mezore mutato pointer
+ * \param task int az oszlopsav sorszama
+ * \param worker int a vegrehajto szal sorszama (ez valasztja ki a munkateruletet)
+ * \return void
+ *
+ */
+static void lenia_column_task(void *data, int task, int worker) {
+    Lenia *lenia = data;
+    lenia_column_block(lenia, task*LENIA_COLUMN_BLOCK, lenia->scratch + (size_t)2*LENIA_COLUMN_BLOCK*lenia->size_y*worker, 1);
+}
+
+/** \brief A szalkeszlet feladata: ket szomszedos sor inverz FFT-je es a cellak frissitese
+ *
+ * Mivel mindket sor eredmenye valos, a ket spektrum A + iB alakban egyetlen inverz FFT-vel
+ * transzformalhato vissza: a valos resz az elso, a kepzetes resz a masodik sor potencialja.
+ *
+ * \param data void* a mezore mutato pointer
+ * \param task int a sorpar sorszama
+ * \param worker int a vegrehajto szal sorszama
+ * \return void
+ *
+ */
+static void lenia_inverse_task(void *data, int task, int worker) {
+    Lenia *lenia = data;
+    const int n = lenia->size_x;
+    float *a = lenia->field + (size_t)2*task*n;
+    float *b = a + n;
+    float *za = lenia->spectrum + (size_t)4*task*n;
+    const float *zb = za + 2*n;
+    int k;
+    (void)worker;
+    for (k=0; k<n; k++) {
+        za[2*k] -= zb[2*k+1];
+        za[2*k+1] += zb[2*k];
+    }
+    lenia_fft(za, n, lenia->twiddle_x, lenia->bitrev_x, 1);
+    for (k=0; k<n; k++) {
+        a[k] = lenia_grow(lenia, a[k], za[2*k]);
+        b[k] = lenia_grow(lenia, b[k], za[2*k+1]);
+    }
+}
+
+Lenia *lenia_new(int size_x, int size_y, const LeniaParams params) {
+    Lenia *lenia = malloc(sizeof(Lenia));
+    size_t cells;
+    if (lenia == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a Lenia mezo letrehozasanal.\n");
+#endif // NDEBUG
+        return NULL;
+    }
+    memset(lenia, 0, sizeof(Lenia));
+    lenia->size_x = lenia_round_size(size_x);
+    lenia->size_y = lenia_round_size(size_y);
+    cells = (size_t)lenia->size_x*lenia->size_y;
+    lenia->field = malloc(sizeof(float)*cells);
+    lenia->spectrum = malloc(sizeof(float)*2*cells);
+    lenia->kernel_spectrum = malloc(sizeof(float)*cells);
+    if (lenia->field == NULL || lenia->spectrum == NULL || lenia->kernel_spectrum == NULL
+            || !lenia_fft_tables(lenia->size_x, &lenia->twiddle_x, &lenia->bitrev_x)
+            || !lenia_fft_tables(lenia->size_y, &lenia->twiddle_y, &lenia->bitrev_y)
+            || !lenia_set_params(lenia, params)) {
+#ifdef NDEBUG
+        fprintf(stderr, "Hiba a Lenia mezo letrehozasanal.\n");
+#endif // NDEBUG
+        lenia_free(lenia);
+        return NULL;
+    }
+    memset(lenia->field, 0, sizeof(float)*cells);
+    return lenia;
+}
+
+void lenia_free(Lenia *lenia) {
+    free(lenia->field);
+    free(lenia->spectrum);
+    free(lenia->kernel_spectrum);
+    free(lenia->twiddle_x);
+    free(lenia->twiddle_y);
+    free(lenia->bitrev_x);
+    free(lenia->bitrev_y);
+    free(lenia->scratch);
+    free(lenia);
+}
+
+int lenia_set_params(Lenia *lenia, const LeniaParams params) {
+    if (params.radius < 1 || params.radius > LENIA_RADIUS_MAX || params.time_steps < 1 || params.sigma <= 0
+            || params.growth < 0 || params.growth >= LENIA_GROWTH_COUNT) {
+        return 0;
+    }
+    if (params.radius != lenia->params.radius && !lenia_build_kernel(lenia, params.radius)) {
+        return 0;
+    }
+    lenia->params = params;
+    lenia_build_growth(lenia);
+    return 1;
+}
+
+void lenia_step(Lenia *lenia) {
+    // Sorok, oszlopok (a kernellel szorozva oda-vissza), majd ujra a sorok: a kozbulso eredmeny a spectrum pufferben marad
+    if (!lenia_reserve_scratch(lenia, thread_pool_size(lenia->pool))) {
+        return;
+    }
+    thread_pool_run(lenia->pool, lenia_forward_task, lenia, lenia->size_y/2);
+    thread_pool_run(lenia->pool, lenia_column_task, lenia, lenia->size_x/LENIA_COLUMN_BLOCK);
+    thread_pool_run(lenia->pool, lenia_inverse_task, lenia, lenia->size_y/2);
+}
+
+void lenia_from_grid(Lenia *lenia, const Grid *grid) {
+    const int size_x = grid->size_x < lenia->size_x ? grid->size_x : lenia->size_x;
+    const int size_y = grid->size_y < lenia->size_y ? grid->size_y : lenia->size_y;
+    int x, y;
+    memset(lenia->field, 0, sizeof(float)*lenia->size_x*lenia->size_y);
+    for (y=0; y<size_y; y++) {
+        const uint64_t *row = grid_row(grid, grid->cells, y);
+        for (x=0; x<size_x; x++) {
+            lenia->field[(size_t)y*lenia->size_x + x] = (float)grid_bit_get(row, x);
+        }
+    }
+}
+
+void lenia_to_grid(const Lenia *lenia, Grid *grid) {
+    int x, y;
+    grid_clear_cells(grid);
+    for (y=0; y<lenia->size_y; y++) {
+        for (x=0; x<lenia->size_x; x++) {
+            if (lenia->field[(size_t)y*lenia->size_x + x] >= 0.5f) {
+                grid_set(grid, x, y, (Cell) {
+                    alive, alive
+                });
+            }
+        }
+    }
+}
+
+void lenia_paint(Lenia *lenia, int x, int y, int radius, int erase) {
+    int dx, dy;
+    for (dy=-radius; dy<=radius; dy++) {
+        for (dx=-radius; dx<=radius; dx++) {
+            if (dx*dx + dy*dy <= radius*radius) {
+                size_t cell = (size_t)((y + dy) & (lenia->size_y-1))*lenia->size_x + ((x + dx) & (lenia->size_x-1));
+                lenia->field[cell] = erase ? 0 : (float)rand()/RAND_MAX;
+            }
+        }
+    }
+}
+
+double lenia_mass(const Lenia *lenia) {
+    const size_t cells = (size_t)lenia->size_x*lenia->size_y;
+    double mass = 0;
+    size_t i;
+    for (i=0; i<cells; i++) {
+        mass += lenia->field[i];
+    }
+    return mass;
+}
@@ -0,0 +1,97 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_lenia.h
+ * Description:     A folytonos (Lenia) mezovel kapcsolatos fuggvenyek
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#ifndef __GOL_LENIA_H_INCLUDED__
+#define __GOL_LENIA_H_INCLUDED__
+
+#define LENIA_SIZE_MIN 64           /**< A mezo legkisebb oldalhossza */
+#define LENIA_SIZE_MAX 4096         /**< A mezo legnagyobb oldalhossza */
+#define LENIA_RADIUS_MAX 30         /**< A kernel legnagyobb sugara (a mezo fele alatt kell maradnia) */
+
+/** \brief Letrehoz egy uj, ures mezot
+ *
+ * A mezo oldalai a megadott meret feletti legkisebb 2 hatvanyra kerekitodnek
+ * (LENIA_SIZE_MIN..LENIA_SIZE_MAX kozott).
+ *
+ * \param size_x int a kivant szelesseg
+ * \param size_y int a kivant magassag
+ * \param params const LeniaParams a mezo parameterei
+ * \return Lenia* a mezore mutato pointer (Hiba eseten NULL)
+ *
+ */
+Lenia *lenia_new(int size_x, int size_y, const LeniaParams params);
+
+/** \brief Felszabaditja a mezot
+ *
+ * \param lenia Lenia* a mezore mutato pointer
+ * \return void
+ *
+ */
+void lenia_free(Lenia *lenia);
+
+/** \brief Beallitja a mezo parametereit
+ *
+ * A kernel spektruma csak a sugar valtozasakor szamolodik ujra, a novekedesi fuggveny tablazata mindig.
+ *
+ * \param lenia Lenia* a mezore mutato pointer
+ * \param params const LeniaParams az uj parameterek (a sugar 1..LENIA_RADIUS_MAX kozott)
+ * \return int 1, ha sikerult; 0 hibas parameterek eseten (ekkor a regiek maradnak)
+ *
+ */
+int lenia_set_params(Lenia *lenia, const LeniaParams params);
+
+/** \brief Lepteti a mezot egy idolepessel
+ *
+ * A potencial a mezo es a kernel konvolucioja (FFT-vel, O(n log n) ido alatt),
+ * az uj ertek a regi ertek es a potencialhoz tartozo novekedes osszege, 0..1 koze szoritva.
+ *
+ * \param lenia Lenia* a mezore mutato pointer
+ * \return void
+ *
+ */
+void lenia_step(Lenia *lenia);
+
+/** \brief Atmasolja a grid cellait a mezobe: az elo cellak 1, a tobbi 0 erteket kapnak
+ *
+ * \param lenia Lenia* a mezore mutato pointer
+ * \param grid const Grid* a gridre mutato pointer
+ * \return void
+ *
+ */
+void lenia_from_grid(Lenia *lenia, const Grid *grid);
+
+/** \brief Visszairja a mezot a gridbe: a legalabb 0.5 erteku cellak elnek
+ *
+ * \param lenia const Lenia* a mezore mutato pointer
+ * \param grid Grid* a gridre mutato pointer
+ * \return void
+ *
+ */
+void lenia_to_grid(const Lenia *lenia, Grid *grid);
+
+/** \brief Veletlen ertekekkel tolt ki (vagy torol) egy kort a mezoben
+ *
+ * \param lenia Lenia* a mezore mutato pointer
+ * \param x int a kor kozeppontjanak x koordinataja (a mezo torusz, barmilyen ertek lehet)
+ * \param y int a kor kozeppontjanak y koordinataja
+ * \param radius int a kor sugara
+ * \param erase int 1 eseten a kor cellai 0 erteket kapnak
+ * \return void
+ *
+ */
+void lenia_paint(Lenia *lenia, int x, int y, int radius, int erase);
+
+/** \brief Visszaadja a mezo ertekeinek osszeget (a Lenia "tomeget")
+ *
+ * \param lenia const Lenia* a mezore mutato pointer
+ * \return double az ertekek osszege
+ *
+ */
+double lenia_mass(const Lenia *lenia);
+
+#endif // __GOL_LENIA_H_INCLUDED__
@@ -14,6 +14,15 @@
 #include "gol_font.h"
 #include "gol_events.h"
 #include "gol_render.h"
+#include "gol_thread.h"
+#include "gol_kernel.h"
+#include "gol_hashlife.h"
+#include "gol_world.h"
+#include "gol_lenia.h"
+#include "gol_rule.h"
+#include "gol_cycle.h"
+#include "gol_mip.h"
+#include "gol_sim.h"
 
 static const char GAME_FONT_PATH[] = "assets/fonts/opensans.ttf";
 static const int GAME_FONT_SIZE = 20;
@@ -22,8 +31,44 @@ static const int SCREEN_INIT_W = 800;
 static const int SCREEN_INIT_H = 600;
 
 static const int CELL_INIT_SIZE = 16;
+static const int JUMP_INIT_LOG2 = 10;
+static const int SPEED_INIT_LOG2 = 0;
+static const int HASHLIFE_INIT_CACHE_MB = 256;
+// Az Orbium, a legismertebb Lenia "eloleny" parameterei
+static const int LENIA_INIT_RADIUS = 13;
+static const int LENIA_INIT_TIME_STEPS = 10;
+static const double LENIA_INIT_MU = 0.15;
+static const double LENIA_INIT_SIGMA = 0.015;
+static const int CYCLE_INIT_PERIOD_MAX = 30;
 static const char FILENAME_SETTINGS[] = "save/settings.bin";
 
+/** \brief A futo grid szimulacio egy kepkockaja, ha a leptetes a szimulacios szalon tortenik
+ *
+ * A kepkocka a legutobb kozzetett pillanatkepet rajzolja; a futas vegen (a szal leallasa utan)
+ * a rajzolas ujra az elo gridet hasznalja, ezert a mip piramis elolrol epul.
+ *
+ * \param game_vars GameVars* A fo jatekvaltozokra mutato pointer
+ * \return GameState A jatek kovetkezo allapota
+ *
+ */
+static GameState Game_SimFrame(GameVars *game_vars) {
+    GameState next = STATE_SIM_PAUSED;
+    if (!sim_cycle_found(game_vars->sim)) {
+        sim_acquire(game_vars->sim);
+        render_sim_running(game_vars);
+        next = events_sim_running(game_vars);
+        if (next == STATE_SIM_RUNNING) {
+            return next;
+        }
+    }
+    sim_stop(game_vars->sim);
+    mip_invalidate(game_vars->mip);
+    if (sim_cycle_found(game_vars->sim)) {
+        render_sim_paused(game_vars);
+    }
+    return next;
+}
+
 GameState Game_StateMachine(GameVars *game_vars) {
     switch (game_vars->state) {
     case STATE_INIT:
@@ -64,7 +109,15 @@ GameState Game_StateMachine(GameVars *game_vars) {
         render_sim_paused(game_vars);
         return events_sim_paused(game_vars);
     case STATE_SIM_RUNNING:
-        grid_logic(game_vars->grid);
+        // A grid a szimulacios szalon lep, a folytonos mezo es a vegtelen vilag kepkockankent a fo szalon
+        if (game_vars->lenia == NULL && game_vars->world == NULL &&
+                (sim_running(game_vars->sim) || sim_start(game_vars->sim, game_vars))) {
+            return Game_SimFrame(game_vars);
+        }
+        if (Game_Step(game_vars, 1 << game_vars->settings.speed_log2) && game_vars->settings.cycle_action == CYCLE_PAUSE) {
+            render_sim_paused(game_vars);
+            return STATE_SIM_PAUSED;
+        }
         render_sim_running(game_vars);
         return events_sim_running(game_vars);
     default:
@@ -72,15 +125,90 @@ GameState Game_StateMachine(GameVars *game_vars) {
     }
 }
 
+int Game_Step(GameVars *game_vars, int generations) {
+    Settings *settings = &game_vars->settings;
+    GridStepStats stats;
+    int i, found = 0;
+    if (game_vars->lenia != NULL) {
+        for (i=0; i<generations; i++) {
+            lenia_step(game_vars->lenia);
+        }
+        game_vars->generation += generations;
+    } else if (game_vars->world != NULL) {
+        for (i=0; i<generations; i++) {
+            world_step(game_vars->world);
+        }
+        game_vars->generation += generations;
+    } else if (settings->cycle_action == CYCLE_OFF) {
+        game_vars->step_stats = grid_step_n(game_vars->grid, generations);
+        game_vars->generation += generations;
+    } else {
+        // A ciklusfigyelo minden generacio hash erteket megkapja
+        game_vars->step_stats = (GridStepStats) {
+            0, 0, 0
+        };
+        for (i=0; i<generations; i++) {
+            if (game_vars->cycle.period > 0 && settings->cycle_action == CYCLE_SKIP) {
+                // A periodikus minta egy teljes periodus utan ugyanott tart, eleg a szamlalot leptetni
+                game_vars->generation += (uint64_t)(generations - i)*game_vars->cycle.period;
+                break;
+            }
+            stats = grid_step_n(game_vars->grid, 1);
+            game_vars->step_stats.generations += stats.generations;
+            game_vars->step_stats.computed += stats.computed;
+            game_vars->step_stats.tiles += stats.tiles;
+            game_vars->generation++;
+            if (cycle_push(&game_vars->cycle, grid_hash(game_vars->grid), settings->cycle_period_max) > 0) {
+                found = 1;
+                if (settings->cycle_action == CYCLE_PAUSE) {
+                    break;
+                }
+            }
+        }
+    }
+    return found;
+}
+
 int Game_Init_All(GameVars *game_vars, const char *title) {
     game_vars->window = NULL;
     game_vars->screen = NULL;
     game_vars->renderer = NULL;
     game_vars->game_font = NULL;
     game_vars->grid = NULL;
+    game_vars->thread_pool = NULL;
+    game_vars->hashlife = NULL;
+    game_vars->world = NULL;
+    game_vars->lenia = NULL;
+    game_vars->generation = 0;
+    cycle_reset(&game_vars->cycle);
+    game_vars->step_stats = (GridStepStats) {
+        0, 0, 0
+    };
+    game_vars->view_x = 0;
+    game_vars->view_y = 0;
+    game_vars->zoom_log2 = 0;
+    game_vars->mip = NULL;
+    game_vars->sim = NULL;
+    game_vars->settings_item = SETTINGS_THREADS;
     game_vars->state = STATE_INIT;
     if (file_load_settings(FILENAME_SETTINGS, game_vars) != 0) {
         game_vars->settings.cell_size = CELL_INIT_SIZE;
+        game_vars->settings.thread_count = 0;
+        game_vars->settings.kernel = KERNEL_AUTO;
+        game_vars->settings.jump_log2 = JUMP_INIT_LOG2;
+        game_vars->settings.speed_log2 = SPEED_INIT_LOG2;
+        game_vars->settings.hashlife_cache_mb = HASHLIFE_INIT_CACHE_MB;
+        game_vars->settings.unbounded = 0;
+        game_vars->settings.topology = TOPOLOGY_PLANE;
+        game_vars->settings.rule = rule_preset(0);
+        game_vars->settings.continuous = 0;
+        game_vars->settings.lenia.radius = LENIA_INIT_RADIUS;
+        game_vars->settings.lenia.time_steps = LENIA_INIT_TIME_STEPS;
+        game_vars->settings.lenia.mu = LENIA_INIT_MU;
+        game_vars->settings.lenia.sigma = LENIA_INIT_SIGMA;
+        game_vars->settings.lenia.growth = LENIA_GROWTH_GAUSSIAN;
+        game_vars->settings.cycle_action = CYCLE_OFF;
+        game_vars->settings.cycle_period_max = CYCLE_INIT_PERIOD_MAX;
         game_vars->settings.save_modified = time(NULL);
         game_vars->settings.save_name[0] = '\0';
     }
@@ -108,7 +236,7 @@ int Game_Init_All(GameVars *game_vars, const char *title) {
         return 0;
     }
     SDL_GetWindowSize(game_vars->window, &game_vars->window_size.w, &game_vars->window_size.h);
-    game_vars->renderer = SDL_CreateRenderer(game_vars->window, -1, SDL_RENDERER_ACCELERATED);
+    game_vars->renderer = SDL_CreateRenderer(game_vars->window, -1, SDL_RENDERER_ACCELERATED|SDL_RENDERER_PRESENTVSYNC);
     if (game_vars->renderer == NULL) {
 #ifdef NDEBUG
         fprintf(stderr, "SDL hiba: %s\n", SDL_GetError());
@@ -142,12 +270,32 @@ int Game_Init_All(GameVars *game_vars, const char *title) {
 
     }
 
+    kernel_set_rule(game_vars->settings.rule);
+    kernel_select(game_vars->settings.kernel);
+    game_vars->thread_pool = thread_pool_new(game_vars->settings.thread_count);
+    if (game_vars->thread_pool == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Figyelmeztetes: a szalkeszlet nem jott letre, a leptetes egy szalon fut\n");
+#endif // NDEBUG
+    }
+    game_vars->sim = sim_new();
+    if (game_vars->sim == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Figyelmeztetes: a szimulacios szal nem jott letre, a szimulacio a fo szalon fut\n");
+#endif // NDEBUG
+    }
+
     game_vars->screen = SDL_GetWindowSurface(game_vars->window);
     render_init(game_vars);
     return 1;
 }
 
 void Game_Destroy_All(GameVars *game_vars) {
+    // A szimulacios szal a gridet lepteti, ezert mindenek elott all le
+    if (game_vars->sim != NULL) {
+        sim_free(game_vars->sim);
+        game_vars->sim = NULL;
+    }
     if (game_vars->renderer != NULL) {
         SDL_DestroyRenderer(game_vars->renderer);
         game_vars->renderer = NULL;
@@ -164,6 +312,26 @@ void Game_Destroy_All(GameVars *game_vars) {
         grid_free(game_vars->grid);
         game_vars->grid = NULL;
     }
+    if (game_vars->world != NULL) {
+        world_free(game_vars->world);
+        game_vars->world = NULL;
+    }
+    if (game_vars->lenia != NULL) {
+        lenia_free(game_vars->lenia);
+        game_vars->lenia = NULL;
+    }
+    if (game_vars->thread_pool != NULL) {
+        thread_pool_free(game_vars->thread_pool);
+        game_vars->thread_pool = NULL;
+    }
+    if (game_vars->hashlife != NULL) {
+        hashlife_free(game_vars->hashlife);
+        game_vars->hashlife = NULL;
+    }
+    if (game_vars->mip != NULL) {
+        mip_free(game_vars->mip);
+        game_vars->mip = NULL;
+    }
     render_destroy();
 }
 
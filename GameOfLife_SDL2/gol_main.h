@@ -8,6 +8,7 @@
  **********************************/
 #ifndef __GOL_MAIN_H_INCLUDED__
 #define __GOL_MAIN_H_INCLUDED__
+#include <stdint.h>
 #include <SDL.h>
 #include <SDL_ttf.h>
 
@@ -106,49 +107,415 @@ typedef struct vec_2d {
     double y;  /**< Y koordinata */
 } Vec2D;
 
+#define FONT_CACHE_SIZE 32          /**< A font gyorsitotaraban tartott szovegtexturak szama */
+#define FONT_ATLAS_GLYPHS 128       /**< A glifatlasz karaktereinek legnagyobb szama */
+#define FONT_DYNAMIC_LENGTH 256     /**< A glifatlaszbol rajzolt szoveg leghosszabb merete karakterekben */
+
+/** \brief Egy szoveg kirajzolt texturaja a font gyorsitotaraban
+ */
+typedef struct t_font_cache_entry {
+    char *text;                 /**< A szoveg (NULL: ures hely) */
+    uint32_t hash;              /**< A szoveg hash erteke (a gyors osszehasonlitashoz) */
+    SDL_Texture *texture;       /**< A szoveg texturaja */
+    Vec2D size;                 /**< A textura merete */
+    uint32_t last_used;         /**< Az utolso hasznalat ideje (tele gyorsitotarbol a legregebben hasznalt esik ki) */
+} FontCacheEntry;
+
+/** \brief Egy karakter kepe a glifatlaszban
+ */
+typedef struct t_font_glyph {
+    Uint16 ch;          /**< A karakter kodja (UCS-2) */
+    SDL_Rect rect;      /**< A karakter kepe az atlaszban (teljes sormagassaggal) */
+    int advance;        /**< A karakter utan ennyivel lep tovabb a kovetkezo karakter helye */
+} FontGlyph;
+
 /** \brief Betutipus struktura az SDL_TTF pluginhez
+ *
+ * Az allando szovegek kirajzolt texturai egy LRU gyorsitotarban maradnak, igy ujra beallitva nem
+ * rajzolodnak ujra. A gyakran valtozo (szamokat tartalmazo) szovegek egy elore kirajzolt
+ * glifatlaszbol, karakterenkent masolodnak a kepernyore.
  */
 typedef struct t_game_font {
     TTF_Font *font;           /**< A fontra mutato pointer */
     SDL_Renderer *renderer;   /**< A rendererre mutato pointer */
-    SDL_Texture *texture;     /**< A font texturaja */
-    Vec2D texture_size;       /**< A textura merete */
+    SDL_Texture *texture;     /**< A szoveg texturaja (a gyorsitotar egy eleme) */
+    Vec2D texture_size;       /**< A textura (glifatlaszbol rajzolt szovegnel a szoveg) merete */
     SDL_Color color;          /**< A font szine */
+    FontCacheEntry cache[FONT_CACHE_SIZE];  /**< A szovegtexturak gyorsitotara */
+    uint32_t cache_clock;     /**< A gyorsitotar hasznalatainak szamlaloja */
+    SDL_Texture *atlas;       /**< A glifatlasz texturaja (NULL, ha nem jott letre) */
+    FontGlyph glyphs[FONT_ATLAS_GLYPHS];    /**< A glifatlasz karakterei: elol a 32..126 kodu ASCII karakterek */
+    int glyph_count;          /**< A glifatlasz karaktereinek szama */
+    int dynamic;              /**< 1, ha a szoveg a glifatlaszbol rajzolodik */
+    int dynamic_length;       /**< A glifatlaszbol rajzolt szoveg hossza */
+    uint8_t dynamic_glyphs[FONT_DYNAMIC_LENGTH];    /**< A glifatlaszbol rajzolt szoveg karaktereinek sorszama */
 } GameFont;
 
 /** \brief A cella allapotai
  */
 typedef enum t_cell_state {
     dead = 0,     /**< Halott cella */
-    alive = 1     /**< Elo cella */
+    alive = 1,    /**< Elo cella */
+    dying = 2     /**< Haldoklo cella (Generations szabalyok): a 2, 3, ... ertekek a haldoklas fokai */
 } CellState;
 
 /** \brief A cella allapotat tarolo struktura
  */
 typedef struct t_cell {
     CellState state;       /**< A cella aktualis allapota */
-    CellState next_state;  /**< A cella kovetkezo allapota */
     CellState was_alive;   /**< A cella elt-e mar */
 } Cell;
 
+/** \brief Larger than Life szabaly: r sugaru negyzetes kornyezet, az elo cellak szamanak tartomanyai
+ */
+typedef struct t_ltl_rule {
+    uint8_t range;          /**< A kornyezet sugara (0: nem Larger than Life szabaly) */
+    uint8_t middle;         /**< 1, ha a cella sajat magat is beleszamolja az osszegbe */
+    uint16_t birth_min;     /**< A szuletes tartomanyanak also hatara */
+    uint16_t birth_max;     /**< A szuletes tartomanyanak felso hatara */
+    uint16_t survive_min;   /**< A tuleles tartomanyanak also hatara */
+    uint16_t survive_max;   /**< A tuleles tartomanyanak felso hatara */
+} LtlRule;
+
+/** \brief Izotrop (B/S) szabaly, Hensel-jelolessel
+ *
+ * A birth n. bitje: n elo szomszed eseten halott cellabol elo lesz,
+ * a survive n. bitje: n elo szomszed eseten az elo cella eletben marad.
+ * A nem totalisztikus szabalyoknal a csak reszben megadott szomszedszamok
+ * alakzatai (Hensel-betui) a *_hensel maszkokba kerulnek, ezek a kulso-totalisztikus
+ * szabalyoknal nullak (a betuk sorrendjet a gol_rule.c irja le).
+ * A Generations szabalyoknal a meghalo cella dying lepesen at haldoklik, kozben nem
+ * szamit elo szomszednak, es nem szulethet ujra.
+ * Larger than Life szabalynal (ltl.range > 0) a birth es survive helyett az ltl tartomanyai ervenyesek.
+ */
+typedef struct t_rule {
+    uint16_t birth;             /**< A szuletes szomszedszamai (0..8. bit) */
+    uint16_t survive;           /**< A tuleles szomszedszamai (0..8. bit) */
+    uint64_t birth_hensel;      /**< A szuletes tovabbi alakzatai */
+    uint64_t survive_hensel;    /**< A tuleles tovabbi alakzatai */
+    uint8_t dying;              /**< A haldoklo allapotok szama (az allapotok szama - 2, ketallapotu szabalynal 0) */
+    LtlRule ltl;                /**< Larger than Life kornyezet es tartomanyok */
+} Rule;
+
+#define RULE_CIRCUIT_INPUTS 7        /**< Az aramkor bemenetei: s0, s1, s2, s3, a kozepso cella, csupa 0, csupa 1 */
+#define RULE_CIRCUIT_MAX_GATES 32    /**< Az aramkor kapuinak maximalis szama */
+
+/** \brief Az aramkor kapuinak fajtai (a bitszeletelt kernelek muveletei)
+ */
+typedef enum t_rule_gate_op {
+    RULE_GATE_AND,      /**< a & b */
+    RULE_GATE_OR,       /**< a | b */
+    RULE_GATE_XOR,      /**< a ^ b */
+    RULE_GATE_ANDNOT    /**< (~a) & b */
+} RuleGateOp;
+
+/** \brief Az aramkor egy kapuja
+ */
+typedef struct t_rule_gate {
+    uint8_t op;     /**< A muvelet (RuleGateOp) */
+    uint8_t a;      /**< Az elso operandus: bemenet vagy korabbi kapu sorszama */
+    uint8_t b;      /**< A masodik operandus */
+} RuleGate;
+
+/** \brief Egy szabalybol forditott logikai aramkor
+ *
+ * A bemenetek a kilenc cella osszegenek bitjei (s0..s3) es a kozepso cella, ezek sorszama 0..4,
+ * az 5. a csupa 0, a 6. a csupa 1 ertek. Az i. kapu eredmenyenek sorszama RULE_CIRCUIT_INPUTS+i.
+ */
+typedef struct t_rule_circuit {
+    int gate_count;                             /**< A kapuk szama */
+    int output;                                 /**< A kovetkezo allapotot ado bemenet vagy kapu sorszama */
+    RuleGate gates[RULE_CIRCUIT_MAX_GATES];     /**< A kapuk, kiertekelesi sorrendben */
+} RuleCircuit;
+
+/** \brief A grid leptetesere hasznalhato kernelek
+ */
+typedef enum t_kernel_type {
+    KERNEL_AUTO,        /**< A leggyorsabb, a processzor altal tamogatott kernel */
+    KERNEL_SCALAR,      /**< Cellankenti referencia kernel */
+    KERNEL_LUT,         /**< Tablazatos kernel: egy 4x4-es kornyezetbol 2x2 kimeneti cella */
+    KERNEL_SWAR,        /**< Bitszeletelt kernel, hordozhato C (64 cella szavankent) */
+    KERNEL_SSE2,        /**< Bitszeletelt kernel, SSE2 (128 cella utasitasonkent) */
+    KERNEL_AVX2,        /**< Bitszeletelt kernel, AVX2 (256 cella utasitasonkent) */
+    KERNEL_AVX512,      /**< Bitszeletelt kernel, AVX-512 (512 cella utasitasonkent) */
+    KERNEL_COUNT        /**< A kernelek szama */
+} KernelType;
+
+/** \brief A grid szeleinek viselkedese
+ */
+typedef enum t_topology {
+    TOPOLOGY_PLANE,     /**< Nyilt sik: a grid a szelen elhelyezett cellak miatt szukseg szerint no */
+    TOPOLOGY_BOUNDED,   /**< Zart doboz: a szelen tul minden cella halott, a grid merete allando */
+    TOPOLOGY_TORUS,     /**< Torusz: a szemkozti szelek osszeernek */
+    TOPOLOGY_KLEIN,     /**< Klein-palack: mint a torusz, de a felso es also szel tukrozve er ossze */
+    TOPOLOGY_COUNT      /**< A topologiak szama */
+} Topology;
+
+/** \brief A folytonos (Lenia) mod novekedesi fuggvenyei
+ *
+ * Mindegyik az u potencialhoz (a kornyezet sulyozott atlagahoz) -1..1 kozotti novekedest rendel,
+ * a csucs helye mu, a szelessege sigma.
+ */
+typedef enum t_lenia_growth {
+    LENIA_GROWTH_GAUSSIAN,      /**< Haranggorbe: 2*exp(-(u-mu)^2/(2*sigma^2)) - 1 */
+    LENIA_GROWTH_POLYNOMIAL,    /**< Polinom: 2*max(0, 1-(u-mu)^2/(9*sigma^2))^4 - 1 */
+    LENIA_GROWTH_STEP,          /**< Lepcso: 1, ha |u-mu| <= sigma, kulonben -1 */
+    LENIA_GROWTH_COUNT          /**< A novekedesi fuggvenyek szama */
+} LeniaGrowth;
+
+/** \brief A folytonos (Lenia) mod parameterei
+ */
+typedef struct t_lenia_params {
+    int radius;             /**< A konvolucios kernel sugara cellakban */
+    int time_steps;         /**< Egy idoegyseg lepeseinek szama (a lepeskoz 1/time_steps) */
+    double mu;              /**< A novekedesi fuggveny csucsanak helye */
+    double sigma;           /**< A novekedesi fuggveny szelessege */
+    LeniaGrowth growth;     /**< A novekedesi fuggveny */
+} LeniaParams;
+
+/** \brief Mit tegyen a szimulacio, ha a minta stabilizalodott vagy periodikussa valt
+ */
+typedef enum t_cycle_action {
+    CYCLE_OFF,              /**< Nincs ciklusfigyeles */
+    CYCLE_REPORT,           /**< Csak kiirja a periodust */
+    CYCLE_PAUSE,            /**< Megallitja a szimulaciot */
+    CYCLE_SKIP,             /**< Tovabb lepteti a generacioszamlalot, szamolas nelkul */
+    CYCLE_ACTION_COUNT      /**< A lehetosegek szama */
+} CycleAction;
+
+/** \brief A tobbszalu lepteteshez hasznalt szalkeszlet (gol_thread.c)
+ */
+typedef struct t_thread_pool ThreadPool;
+
+/** \brief A nagy ugrasokhoz hasznalt HashLife motor (gol_hashlife.c)
+ */
+typedef struct t_hashlife HashLife;
+
+/** \brief A futo szimulaciot kulon szalon lepteto szimulacios szal (gol_sim.c)
+ */
+typedef struct t_sim Sim;
+
+/** \brief A grid allapotanak osszesitett adatai
+ */
+typedef struct t_grid_stats {
+    uint64_t population;        /**< Az elo cellak szama */
+    uint64_t births;            /**< Az utolso generacioban szuletett cellak szama */
+    uint64_t deaths;            /**< Az utolso generacioban meghalt cellak szama */
+    int x_min;                  /**< Az elo cellakat tartalmazo legkisebb teglalap bal szele (ures grid eseten x_min > x_max) */
+    int y_min;                  /**< A teglalap felso szele */
+    int x_max;                  /**< A teglalap jobb szele */
+    int y_max;                  /**< A teglalap also szele */
+} GridStats;
+
+/** \brief Egy csempe elo cellainak szama es befoglalo teglalapja (a csempen beluli koordinatakkal)
+ */
+typedef struct t_grid_tile_stats {
+    uint32_t population;        /**< Az elo cellak szama a csempeben */
+    uint16_t x_min;             /**< A befoglalo teglalap bal szele */
+    uint16_t x_max;             /**< A befoglalo teglalap jobb szele */
+    uint8_t y_min;              /**< A befoglalo teglalap felso szele */
+    uint8_t y_max;              /**< A befoglalo teglalap also szele */
+} GridTileStats;
+
+/** \brief Egy csempe valtozasa a leptetes soran (a szalak kulon-kulon irjak, a leptetes vegen osszegzodnek)
+ */
+typedef struct t_grid_tile_delta {
+    uint64_t hash;              /**< A hash valtozasa */
+    uint32_t births;            /**< A szuletesek szama */
+    uint32_t deaths;            /**< A halalozasok szama */
+} GridTileDelta;
+
 /** \brief A gridet tarolo struktura
+ *
+ * A cellak allapota bitenkent van tarolva, soronkent 64 bites szavakba pakolva.
+ * A harom bitsik egyetlen, folytonos pufferben van, soronkent stride szoval.
+ * Minden sor elejen es vegen egy-egy keret szo, a grid felett es alatt
+ * egy-egy keret sor talalhato, igy a szomszedok olvasasa sosem indexel tul.
+ * Nyilt sik es zart doboz eseten a keret (es a size_x. oszlop) halott, torusz es
+ * Klein-palack eseten a leptetes elott a szemkozti szel masolata kerul bele.
+ * Az (x, y) cella a (y+1). sor 1+x/64. szavanak x%64. bitje.
+ * Generations szabalyoknal a haldoklo cellak fokat tovabbi age_planes bitsik tarolja
+ * (a k. fokon haldoklo cellanal k, egyebkent 0); ezek egy pufferben leptetodnek.
+ * A sorok hossza egesz csempeszelessegre van kerekitve, a leptetes csempenkent, tobb szalon tortenik.
+ * Bekapcsolt hash eseten a grid allapotanak Zobrist-szeru hash erteke (a cellak es a haldoklas
+ * fokainak szavankenti hash ertekeinek kizaro vagya) a leptetes kozben, a valtozott szavakbol frissul.
+ * Ugyanebben a menetben szamolodik az elo cellak szama, a szuletesek, a halalozasok es a befoglalo teglalap.
+ * A Cell struktura csak a fuggvenyek interfeszen jelenik meg.
  */
 typedef struct t_grid {
     int size_x;                     /**< A grid szelessege */
     int size_y;                     /**< A grid magassaga */
-    int cap_x;                      /**< A grid maximalis szelessege */
-    int cap_y;                      /**< A grid maximalis magassaga */
-    Cell **cells;                   /**< A cellakat tarolo matrix */
+    int cap_x;                      /**< A grid maximalis szelessege (keret nelkul) */
+    int cap_y;                      /**< A grid maximalis magassaga (keret nelkul) */
+    int stride;                     /**< Egy sor hossza szavakban (kerettel egyutt) */
+    uint64_t *buffer;               /**< A bitsikokat tarolo kozos puffer */
+    uint64_t *cells;                /**< Az elso puffer: a cellak aktualis allapotat tarolo bitsik */
+    uint64_t *next_cells;           /**< A hatso puffer: ide kerul a kovetkezo generacio, majd a ket puffer helyet cserel */
+    uint64_t *was_alive;            /**< A mar elt cellakat tarolo bitsik */
+    int dying_states;               /**< A haldoklo allapotok szama (0: ketallapotu grid) */
+    int age_planes;                 /**< A haldoklas fokat tarolo bitsikok szama */
+    uint64_t *ages;                 /**< A haldoklas fokanak bitsikjai, egymas utan (NULL, ha nincs) */
+    int tile_stride;                /**< A csempejelzok egy soranak hossza (a kapacitashoz igazitva) */
+    uint8_t *tile_changed;          /**< Csempenkent: valtozott-e az elozo generacioban */
+    uint8_t *tile_next_changed;     /**< Csempenkent: valtozott-e az eppen szamolt generacioban */
+    uint8_t *tile_dirty;            /**< Csempenkent: valtozott-e a mip piramis utolso frissitese ota */
+    int *tile_list;                 /**< A leptetendo (ebren levo) csempek sorszamai */
+    int tile_active;                /**< Az utolso leptetesben szamolt csempek szama */
+    GridTileDelta *tile_delta;      /**< A leptetendo csempek valtozasa az eppen szamolt generacioban */
+    GridTileStats *tile_stats;      /**< Csempenkent: az elo cellak szama es befoglalo teglalapja */
+    GridStats stats;                /**< Az osszesitett adatok (ha stats_valid) */
+    int stats_valid;                /**< 0, ha az osszesitett adatokat (szerkesztes utan) elolrol kell szamolni */
+    int hash_enabled;               /**< 1 eseten a leptetes a hash erteket is frissiti */
+    int hash_valid;                 /**< 0, ha a hash erteket (szerkesztes utan) elolrol kell szamolni */
+    uint64_t hash;                  /**< A grid allapotanak hash erteke (ha hash_valid) */
+    Topology topology;              /**< A grid szeleinek viselkedese */
+    ThreadPool *pool;               /**< A lepteteshez hasznalt szalkeszlet (NULL eseten a hivo szalon fut) */
 } Grid;
 
+/** \brief Tobb generacios leptetes osszesitett adatai
+ */
+typedef struct t_grid_step_stats {
+    int generations;            /**< A leptetett generaciok szama */
+    int computed;               /**< Ebbol a tenylegesen szamolt generaciok szama (a grid elalvasa utan a tobbi valtozatlan) */
+    uint64_t tiles;             /**< A szamolt csempek szama osszesen */
+} GridStepStats;
+
+/** \brief A szimulacios szal altal kozzetett, a rajzolas idejere valtozatlan pillanatkep
+ *
+ * A szimulacios szal harom pillanatkepet forgat (harmas pufferezes): egybe ir, egy a legutobb
+ * kozzetett, egyet a fo szal rajzol. Az atadas egyetlen atomi csere, zar nelkul.
+ */
+typedef struct t_sim_snapshot {
+    Grid *grid;                 /**< A grid masolata (a cellak, a mar elt cellak es a haldoklas bitsikjai, az osszesitett adatok) */
+    uint32_t version;           /**< A kozzetetel sorszama (0: a puffer tartalma ervenytelen, teljes masolat kell) */
+    uint64_t generation;        /**< A pillanatkep generaciojanak sorszama */
+    int cycle_period;           /**< A ciklusfigyelo altal megtalalt periodus (0, ha meg nincs) */
+} SimSnapshot;
+
+#define MIP_BLOCK_LOG2 3        /**< A mip piramis also szintjen egy blokk 2^MIP_BLOCK_LOG2 oldalu (a bajtonkenti szamlalas miatt 3) */
+#define MIP_LEVELS 16           /**< A mip piramis szintjeinek legnagyobb szama */
+
+/** \brief A grid kicsinyitett kepeinek piramisa
+ *
+ * A k. szint egy eleme a grid egy 2^(MIP_BLOCK_LOG2+k) oldalu negyzetes blokkjanak elo cella surusege (0..255),
+ * a magasabb szintek a negy alattuk levo blokk atlagai. A piramis a grid csempeinek valtozasjelzoi
+ * (tile_dirty) alapjan frissul, csak a valtozott csempek blokkjai es azok felmenoi szamolodnak ujra.
+ */
+typedef struct t_grid_mip {
+    int levels;                     /**< A szintek szama */
+    int size_x[MIP_LEVELS];         /**< Szintenkent a szelesseg blokkokban */
+    int size_y[MIP_LEVELS];         /**< Szintenkent a magassag blokkokban */
+    uint8_t *level[MIP_LEVELS];     /**< Szintenkent a blokkok surusege, soronkent */
+    int *dirty;                     /**< A frissitendo csempek listaja (munkaterulet) */
+    size_t dirty_cap;               /**< A lista kapacitasa */
+} GridMip;
+
+#define WORLD_CHUNK_SIZE 64     /**< A vilag egy darabjanak oldalhossza cellakban */
+
+/** \brief A vegtelen vilag egy darabja
+ *
+ * WORLD_CHUNK_SIZE x WORLD_CHUNK_SIZE cella, soronkent egy 64 bites szo, az x. cella a szo x. bitje.
+ */
+typedef struct t_world_chunk {
+    int64_t cx;                                 /**< A darab x koordinataja (cellakban: cx*WORLD_CHUNK_SIZE) */
+    int64_t cy;                                 /**< A darab y koordinataja */
+    uint64_t cells[WORLD_CHUNK_SIZE];           /**< A cellak aktualis allapota */
+    uint64_t next_cells[WORLD_CHUNK_SIZE];      /**< A kovetkezo generacio */
+    uint64_t was_alive[WORLD_CHUNK_SIZE];       /**< A mar elt cellak */
+    struct t_world_chunk *next;                 /**< A kovetkezo darab a hash lancban */
+} WorldChunk;
+
+/** \brief A vegtelen, 64 bites koordinataju vilag
+ *
+ * Csak az elo cellat tartalmazo darabok foglalnak memoriat, ezek egy hash tablaban vannak.
+ */
+typedef struct t_world {
+    WorldChunk **table;         /**< A darabok hash tablaja */
+    size_t table_size;          /**< A tabla merete (2 hatvanya) */
+    size_t chunk_count;         /**< A lefoglalt darabok szama */
+    WorldChunk **list;          /**< A leptetes munkalistaja */
+    size_t list_cap;            /**< A munkalista kapacitasa */
+    ThreadPool *pool;           /**< A lepteteshez hasznalt szalkeszlet (NULL eseten a hivo szalon fut) */
+} World;
+
+#define LENIA_GROWTH_TABLE_SIZE 1024     /**< A novekedesi fuggveny tablazatanak felbontasa a 0..1 potencialon */
+
+/** \brief A folytonos (Lenia) mod mezeje
+ *
+ * A cellak erteke 0..1 kozotti valos szam, a mezo ket iranyban 2 hatvanya meretu torusz.
+ * A kernellel vett konvolucio a frekvenciatartomanyban tortenik (ket dimenzios FFT),
+ * a kernel spektruma csak a parameterek valtozasakor szamolodik ujra.
+ */
+typedef struct t_lenia {
+    int size_x;                 /**< A mezo szelessege (2 hatvanya) */
+    int size_y;                 /**< A mezo magassaga (2 hatvanya) */
+    float *field;               /**< A cellak erteke, soronkent */
+    float *spectrum;            /**< A konvolucio munkaterulete: size_x*size_y komplex szam (valos, kepzetes) */
+    float *kernel_spectrum;     /**< A kernel spektruma oszloponkent (valos, mert a kernel kozeppontosan szimmetrikus), 1/(size_x*size_y)-nel skalazva */
+    float *twiddle_x;           /**< A sorok FFT-jenek egyseggyokei (size_x/2 komplex szam) */
+    float *twiddle_y;           /**< Az oszlopok FFT-jenek egyseggyokei (size_y/2 komplex szam) */
+    int *bitrev_x;              /**< A sorok FFT-jenek bitfordito permutacioja */
+    int *bitrev_y;              /**< Az oszlopok FFT-jenek bitfordito permutacioja */
+    float *scratch;             /**< Szalankent egy oszlopblokk munkaterulete */
+    int scratch_workers;        /**< Hany szalnak van munkaterulet */
+    float growth_table[LENIA_GROWTH_TABLE_SIZE+1];  /**< A lepeskozzel szorzott novekedes a potencial szerint */
+    LeniaParams params;         /**< A mezo parameterei */
+    ThreadPool *pool;           /**< A lepteteshez hasznalt szalkeszlet (NULL eseten a hivo szalon fut) */
+} Lenia;
+
+#define CYCLE_HISTORY 256           /**< A ciklusfigyelo altal megjegyzett generaciok szama (a leghosszabb periodus) */
+
+/** \brief A ciklusfigyelo allapota
+ *
+ * Az utolso generaciok hash erteket tarolja egy gyuru pufferben; ha az uj hash
+ * p generacioval korabban mar szerepelt, a minta p periodusu (p=1: stabil).
+ */
+typedef struct t_cycle_detector {
+    uint64_t hashes[CYCLE_HISTORY];     /**< Az utolso generaciok hash ertekei */
+    int count;                          /**< A tarolt hash ertekek szama */
+    int head;                           /**< A kovetkezo hash helye a pufferben */
+    int period;                         /**< A megtalalt periodus (0, ha meg nincs) */
+} CycleDetector;
+
 /** \brief A beallitasokat tartalmazo struktura
  */
 typedef struct t_settings {
     int cell_size;                      /**< A cella merete pixelekben */
+    int thread_count;                   /**< A leptetes szalainak szama (0: a processzormagok szama) */
+    KernelType kernel;                  /**< A leptetes kernele */
+    int jump_log2;                      /**< A HashLife ugras kitevoje (2^jump_log2 generacio) */
+    int speed_log2;                     /**< A futo szimulacio kepkockankent (a szimulacios szal egy menetben) 2^speed_log2 generaciot lep */
+    int hashlife_cache_mb;              /**< A HashLife gyorsitotar merete megabajtban */
+    int unbounded;                      /**< 1 eseten a szimulacio a vegtelen vilagban fut */
+    Topology topology;                  /**< A veges grid topologiaja */
+    Rule rule;                          /**< A szimulacio szabalya */
+    int continuous;                     /**< 1 eseten a szimulacio a folytonos (Lenia) mezoben fut */
+    LeniaParams lenia;                  /**< A folytonos mod parameterei */
+    CycleAction cycle_action;           /**< Mit tegyen a szimulacio egy ciklus megtalalasakor */
+    int cycle_period_max;               /**< A figyelt leghosszabb periodus */
     time_t save_modified;               /**< Az utolso mentes datuma */
     char save_name[SAVENAME_LENGTH];    /**< A mentes neve */
 } Settings;
 
+/** \brief A beallitasok menu elemei
+ */
+typedef enum t_settings_item {
+    SETTINGS_THREADS,       /**< A leptetes szalainak szama */
+    SETTINGS_KERNEL,        /**< A leptetes kernele */
+    SETTINGS_SPEED,         /**< A kepkockankent leptetett generaciok szama */
+    SETTINGS_JUMP,          /**< A HashLife ugras merete */
+    SETTINGS_HASHLIFE_CACHE,    /**< A HashLife gyorsitotar merete */
+    SETTINGS_WORLD,         /**< Veges grid vagy vegtelen vilag */
+    SETTINGS_TOPOLOGY,      /**< A veges grid topologiaja */
+    SETTINGS_RULE,          /**< A szimulacio szabalya */
+    SETTINGS_LENIA,         /**< A folytonos mod es novekedesi fuggvenye */
+    SETTINGS_LENIA_MU,      /**< A novekedesi fuggveny csucsanak helye */
+    SETTINGS_LENIA_SIGMA,   /**< A novekedesi fuggveny szelessege */
+    SETTINGS_CYCLE,         /**< A ciklusfigyeles */
+    SETTINGS_CYCLE_PERIOD,  /**< A figyelt leghosszabb periodus */
+    SETTINGS_ITEM_COUNT     /**< A menu elemeinek szama */
+} SettingsItem;
+
 /** \brief Az ablak meretet tarolo struktura
  */
 typedef struct t_window_size {
@@ -164,10 +531,23 @@ typedef struct t_game_vars {
     SDL_Renderer *renderer;    /**< A rendererre mutato pointer */
     GameFont *game_font;       /**< A jatekban hasznalt betutipusra mutato pointer */
     Grid *grid;                /**< A gridre mutato pointer */
+    ThreadPool *thread_pool;   /**< A grid leptetesehez hasznalt szalkeszlet */
+    HashLife *hashlife;        /**< A nagy ugrasokhoz hasznalt HashLife (az elso ugraskor jon letre) */
+    World *world;              /**< A vegtelen vilag (NULL, ha a szimulacio a gridben fut) */
+    Lenia *lenia;              /**< A folytonos mezo (NULL, ha a szimulacio nem folytonos) */
+    uint64_t generation;       /**< Az aktualis generacio sorszama */
+    CycleDetector cycle;       /**< A ciklusfigyelo */
+    GridStepStats step_stats;  /**< Az utolso grid leptetes osszesitett adatai */
+    int64_t view_x;            /**< A kepernyo bal felso cellajanak x koordinataja (a gridben vagy a vegtelen vilagban) */
+    int64_t view_y;            /**< A kepernyo bal felso cellajanak y koordinataja (a gridben vagy a vegtelen vilagban) */
+    int zoom_log2;             /**< Kicsinyites: 0 felett egy pixel 2^zoom_log2 x 2^zoom_log2 cella surusege (ekkor cell_size 1) */
+    GridMip *mip;              /**< A kicsinyitett grid kepeinek piramisa (az elso kicsinyiteskor jon letre) */
+    Sim *sim;                  /**< A futo grid szimulacio szala (NULL eseten a fo szalon lep) */
     GameState state;           /**< A jatek aktualis allapota */
     Vec2D grid_size;           /**< A felhasznalo altal beallitott grid meret */
     Settings settings;         /**< A jatek beallitasai */
     WindowSize window_size;     /**< A jatek ablakanak merete */
+    SettingsItem settings_item; /**< A beallitasok menuben kivalasztott elem */
 } GameVars;
 
 /** \brief A jatekot vezerlo allapotgep
@@ -178,6 +558,19 @@ typedef struct t_game_vars {
  */
 GameState Game_StateMachine(GameVars *game_vars);
 
+/** \brief Lepteti a szimulaciot (a folytonos mezot vagy a vegtelen vilagot, ha az aktiv, kulonben a gridet)
+ *
+ * A grid leptetesekor a ciklusfigyelo is frissul; ha a minta mar periodikus es a beallitas ezt keri,
+ * a grid nem szamolodik, csak a generacioszamlalo lep tovabb generacionkent egy periodussal.
+ * Ha a beallitas a megallast keri, a leptetes a ciklus megtalalasakor idoben megall.
+ *
+ * \param game_vars GameVars* A fo jatekvaltozokra mutato pointer
+ * \param generations int A leptetendo generaciok szama
+ * \return int 1, ha ebben a lepesben derult ki, hogy a minta stabil vagy periodikus
+ *
+ */
+int Game_Step(GameVars *game_vars, int generations);
+
 /** \brief A fo valtozok inicializalasa
  *
  * \param game_vars GameVars* A fo valtozokra mutato pointer
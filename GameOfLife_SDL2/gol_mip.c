@@ -0,0 +1,238 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_mip.c
+ * Description:     A grid kicsinyitett kepeinek (mip) piramisa
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#include <stdlib.h>
+#include <string.h>
+#include "gol_main.h"
+#include "gol_grid.h"
+#include "gol_mip.h"
+
+#define MIP_TILE_BLOCKS_X (GRID_TILE_WORDS*GRID_WORD_BITS >> MIP_BLOCK_LOG2)    /* Egy csempe szelessege az also szinten */
+#define MIP_TILE_BLOCKS_Y (GRID_TILE_ROWS >> MIP_BLOCK_LOG2)                    /* Egy csempe magassaga az also szinten */
+
+/** \brief Visszaadja, hany blokkban fer el a megadott szamu cella az also szinten
+ *
+ * \param cells int a cellak szama
+ * \return int a blokkok szama (legalabb 1)
+ *
+ */
+static int mip_blocks(int cells) {
+    int blocks = (cells + (1 << MIP_BLOCK_LOG2) - 1) >> MIP_BLOCK_LOG2;
+    return blocks > 0 ? blocks : 1;
+}
+
+/** \brief Bajtonkent megszamolja egy szo beallitott bitjeit (egy bajt egy also szintu blokk egy sora)
+ *
+ * \param bits uint64_t a szo
+ * \return uint64_t a bajtonkenti bitszamok (0..8)
+ *
+ */
+static inline uint64_t mip_byte_counts(uint64_t bits) {
+    bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+    bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+    return (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+}
+
+/** \brief Felszabaditja a piramis szintjeit
+ *
+ * \param mip GridMip* a piramisra mutato pointer
+ * \return void
+ *
+ */
+static void mip_clear_levels(GridMip *mip) {
+    int k;
+    for (k=0; k<mip->levels; k++) {
+        free(mip->level[k]);
+        mip->level[k] = NULL;
+    }
+    mip->levels = 0;
+}
+
+/** \brief Ujrafoglalja a szinteket a grid meretenek megfeleloen (a legfelso szint egyetlen blokk, vagy MIP_LEVELS szint)
+ *
+ * \param mip GridMip* a piramisra mutato pointer
+ * \param grid const Grid* a gridre mutato pointer
+ * \return int 1, ha sikerult; 0 hiba eseten
+ *
+ */
+static int mip_resize(GridMip *mip, const Grid *grid) {
+    int size_x = mip_blocks(grid->size_x);
+    int size_y = mip_blocks(grid->size_y);
+    int k;
+    mip_clear_levels(mip);
+    for (k=0; k<MIP_LEVELS; k++) {
+        mip->level[k] = malloc((size_t)size_x*size_y);
+        if (mip->level[k] == NULL) {
+#ifdef NDEBUG
+            fprintf(stderr, "Malloc hiba a mip piramis letrehozasanal.\n");
+#endif // NDEBUG
+            mip_clear_levels(mip);
+            return 0;
+        }
+        memset(mip->level[k], 0, (size_t)size_x*size_y);
+        mip->size_x[k] = size_x;
+        mip->size_y[k] = size_y;
+        mip->levels = k + 1;
+        if (size_x == 1 && size_y == 1) {
+            break;
+        }
+        size_x = (size_x + 1) / 2;
+        size_y = (size_y + 1) / 2;
+    }
+    return 1;
+}
+
+/** \brief Ujraszamolja egy csempe also szintu blokkjait a grid cellaibol
+ *
+ * Egy sor egy szava 8 blokk egy-egy sora, a bajtonkenti bitszamok 8 soron at osszeadva adjak a blokkok cellaszamat.
+ *
+ * \param mip GridMip* a piramisra mutato pointer
+ * \param grid const Grid* a gridre mutato pointer
+ * \param tile int a csempe sorszama
+ * \return void
+ *
+ */
+static void mip_tile_base(GridMip *mip, const Grid *grid, int tile) {
+    const int words = grid_words(grid->size_x);
+    const int word_begin = (tile % grid->tile_stride)*GRID_TILE_WORDS;
+    const int block_y_begin = (tile / grid->tile_stride)*MIP_TILE_BLOCKS_Y;
+    const int blocks_per_word = GRID_WORD_BITS >> MIP_BLOCK_LOG2;
+    uint8_t *level = mip->level[0];
+    int by, w, r, b;
+    for (by=block_y_begin; by<block_y_begin + MIP_TILE_BLOCKS_Y && by<mip->size_y[0]; by++) {
+        int row_end = (by + 1) << MIP_BLOCK_LOG2;
+        if (row_end > grid->size_y) {
+            row_end = grid->size_y;
+        }
+        for (w=word_begin; w<word_begin + GRID_TILE_WORDS && w<words; w++) {
+            // A grid utani bitek (torusz es Klein-palack eseten a keret masolatai) nem szamitanak
+            int bits = grid->size_x - w*GRID_WORD_BITS;
+            uint64_t mask = bits >= GRID_WORD_BITS ? ~(uint64_t)0 : ((uint64_t)1 << bits) - 1;
+            uint64_t counts = 0;
+            for (r=by << MIP_BLOCK_LOG2; r<row_end; r++) {
+                counts += mip_byte_counts(grid_row(grid, grid->cells, r)[GRID_HALO_WORDS + w] & mask);
+            }
+            for (b=0; b<blocks_per_word && w*blocks_per_word + b < mip->size_x[0]; b++) {
+                int count = (int)((counts >> 8*b) & 0xFF);
+                level[(size_t)by*mip->size_x[0] + w*blocks_per_word + b] = (uint8_t)((count*255 + 32) >> (2*MIP_BLOCK_LOG2));
+            }
+        }
+    }
+}
+
+/** \brief Ujraszamolja egy szint teglalapjat az alatta levo szintbol (a negy gyerek atlagakent)
+ *
+ * \param mip GridMip* a piramisra mutato pointer
+ * \param k int a szint (1..levels-1)
+ * \param x_begin int a teglalap bal szele
+ * \param y_begin int a teglalap felso szele
+ * \param x_end int a teglalap utani elso oszlop
+ * \param y_end int a teglalap utani elso sor
+ * \return void
+ *
+ */
+static void mip_level_region(GridMip *mip, int k, int x_begin, int y_begin, int x_end, int y_end) {
+    const uint8_t *child = mip->level[k-1];
+    const int child_x = mip->size_x[k-1];
+    const int child_y = mip->size_y[k-1];
+    uint8_t *level = mip->level[k];
+    int x, y;
+    for (y=y_begin; y<y_end; y++) {
+        const uint8_t *up = child + (size_t)(2*y)*child_x;
+        const uint8_t *down = 2*y + 1 < child_y ? up + child_x : NULL;
+        for (x=x_begin; x<x_end; x++) {
+            // A szint szelen levo blokkok hianyzo gyerekei ures blokkok
+            int right = 2*x + 1 < child_x;
+            int sum = up[2*x] + (right ? up[2*x + 1] : 0);
+            if (down != NULL) {
+                sum += down[2*x] + (right ? down[2*x + 1] : 0);
+            }
+            level[(size_t)y*mip->size_x[k] + x] = (uint8_t)((sum + 2) >> 2);
+        }
+    }
+}
+
+GridMip *mip_new(void) {
+    GridMip *mip = malloc(sizeof(GridMip));
+    if (mip == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a mip piramis letrehozasanal.\n");
+#endif // NDEBUG
+        return NULL;
+    }
+    memset(mip, 0, sizeof(GridMip));
+    return mip;
+}
+
+void mip_free(GridMip *mip) {
+    mip_clear_levels(mip);
+    free(mip->dirty);
+    free(mip);
+}
+
+int mip_update(GridMip *mip, Grid *grid) {
+    const int tile_cols = (grid_words(grid->size_x) + GRID_TILE_WORDS - 1) / GRID_TILE_WORDS;
+    const int tile_rows = (grid->size_y + GRID_TILE_ROWS - 1) / GRID_TILE_ROWS;
+    const size_t tiles = (size_t)tile_cols*tile_rows;
+    int force = 0;
+    int count = 0;
+    int i, k, tx, ty;
+    if (mip->levels == 0 || mip->size_x[0] != mip_blocks(grid->size_x) || mip->size_y[0] != mip_blocks(grid->size_y)) {
+        // Uj meret: minden csempet ujraszamolunk
+        if (!mip_resize(mip, grid)) {
+            return 0;
+        }
+        force = 1;
+    }
+    if (mip->dirty_cap < tiles) {
+        int *dirty = realloc(mip->dirty, sizeof(int)*tiles);
+        if (dirty == NULL) {
+#ifdef NDEBUG
+            fprintf(stderr, "Malloc hiba a mip piramis frissitesenel.\n");
+#endif // NDEBUG
+            return 0;
+        }
+        mip->dirty = dirty;
+        mip->dirty_cap = tiles;
+    }
+    for (ty=0; ty<tile_rows; ty++) {
+        for (tx=0; tx<tile_cols; tx++) {
+            int tile = ty*grid->tile_stride + tx;
+            if (force || grid->tile_dirty[tile]) {
+                grid->tile_dirty[tile] = 0;
+                mip->dirty[count++] = tile;
+            }
+        }
+    }
+    for (i=0; i<count; i++) {
+        mip_tile_base(mip, grid, mip->dirty[i]);
+    }
+    // A valtozott csempek felmenoi szintenkent (egy csempe a felsobb szinteken egyre kisebb teglalap)
+    for (k=1; k<mip->levels; k++) {
+        for (i=0; i<count; i++) {
+            int x_begin = (mip->dirty[i] % grid->tile_stride)*MIP_TILE_BLOCKS_X >> k;
+            int y_begin = (mip->dirty[i] / grid->tile_stride)*MIP_TILE_BLOCKS_Y >> k;
+            int x_end = ((((mip->dirty[i] % grid->tile_stride) + 1)*MIP_TILE_BLOCKS_X - 1) >> k) + 1;
+            int y_end = ((((mip->dirty[i] / grid->tile_stride) + 1)*MIP_TILE_BLOCKS_Y - 1) >> k) + 1;
+            if (x_end > mip->size_x[k]) {
+                x_end = mip->size_x[k];
+            }
+            if (y_end > mip->size_y[k]) {
+                y_end = mip->size_y[k];
+            }
+            mip_level_region(mip, k, x_begin, y_begin, x_end, y_end);
+        }
+    }
+    return 1;
+}
+
+void mip_invalidate(GridMip *mip) {
+    if (mip != NULL) {
+        mip_clear_levels(mip);
+    }
+}
@@ -0,0 +1,48 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_mip.h
+ * Description:     A grid kicsinyitett kepeinek (mip) piramisa
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#ifndef __GOL_MIP_H_INCLUDED__
+#define __GOL_MIP_H_INCLUDED__
+
+/** \brief Letrehoz egy uj, ures mip piramist
+ *
+ * \return GridMip* a piramisra mutato pointer (Hiba eseten NULL)
+ *
+ */
+GridMip *mip_new(void);
+
+/** \brief Felszabaditja a mip piramist
+ *
+ * \param mip GridMip* a piramisra mutato pointer
+ * \return void
+ *
+ */
+void mip_free(GridMip *mip);
+
+/** \brief Frissiti a piramist a grid valtozott csempei alapjan, es torli a csempek valtozasjelzoit
+ *
+ * A grid meretenek valtozasakor a szinteket ujrafoglalja; ilyenkor a grid minden csempeje valtozottnak szamit.
+ *
+ * \param mip GridMip* a piramisra mutato pointer
+ * \param grid Grid* a gridre mutato pointer
+ * \return int 1, ha sikerult; 0 hiba eseten
+ *
+ */
+int mip_update(GridMip *mip, Grid *grid);
+
+/** \brief Ervenyteleniti a piramist: a kovetkezo frissites a csempek valtozasjelzoitol fuggetlenul mindent ujraszamol
+ *
+ * Akkor kell, ha a piramis mas grid (peldaul egy pillanatkep) valtozasjelzoi alapjan frissult.
+ *
+ * \param mip GridMip* a piramisra mutato pointer (NULL eseten nem tesz semmit)
+ * \return void
+ *
+ */
+void mip_invalidate(GridMip *mip);
+
+#endif // __GOL_MIP_H_INCLUDED__
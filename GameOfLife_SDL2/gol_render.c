@@ -7,20 +7,28 @@
  *
  **********************************/
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include <time.h>
 #include "gol_main.h"
 #include "gol_grid.h"
 #include "gol_font.h"
+#include "gol_thread.h"
+#include "gol_kernel.h"
+#include "gol_hashlife.h"
+#include "gol_world.h"
+#include "gol_lenia.h"
+#include "gol_rule.h"
+#include "gol_mip.h"
+#include "gol_sim.h"
 
-static const char CELL_TEXTURE_ALIVE_PATH[] = "assets/texture/cell_rect.png";
-// static const char CELL_TEXTURE_ALIVE_PATH[] = "assets/texture/cell_blue.png";
-// static const char CELL_TEXTURE_ALIVE_PATH[] = "assets/texture/jelly.png";
-static SDL_Texture *cell_texture_alive = NULL;
-
-static const char CELL_TEXTURE_DEAD_PATH[] = "assets/texture/cell_rect_dead.png";
-// static const char CELL_TEXTURE_DEAD_PATH[] = "assets/texture/cell_blue_dead.png";
-// static const char CELL_TEXTURE_DEAD_PATH[] = "assets/texture/jelly_dead.png";
-static SDL_Texture *cell_texture_dead = NULL;
+// A grid es a vegtelen vilag kepe: egyetlen, kockankent egyszer feltoltott textura, cellankent egy texellel
+static SDL_Texture *cell_texture = NULL;
+static int cell_texture_w = 0;
+static int cell_texture_h = 0;
+// A cellak szinei (hatter, valaha elt, elo): a korabbi cell_rect texturak atlagszine
+static const uint32_t CELL_COLORS[3] = {0xFF000000, 0xFF414141, 0xFF5F7FEF};
 
 static const char MENU_BG_TEXTURE_PATH[] = "assets/texture/menualpha.png";
 static SDL_Texture *menubg = NULL;
@@ -35,31 +43,623 @@ static SDL_Texture *gamelogo[4] = {NULL};
 static const int LOGO_ANIM_SPEED = 512;
 static int logo_state = 0;
 
-static char buf[128];
+// A folytonos mezo kepe: egyetlen, kockankent egyszer feltoltott textura, a cellaertekekbol palettaval
+static SDL_Texture *lenia_texture = NULL;
+static int lenia_texture_w = 0;
+static int lenia_texture_h = 0;
+static Uint32 lenia_palette[256];
+
+// A kicsinyitett kep szinei a blokkok surusege szerint (a hatterbol az elo cella szinebe)
+static Uint32 zoom_palette[256];
+// A vegtelen vilag kicsinyitett kepenek pixelenkenti cellaszamai
+static uint32_t *zoom_counts = NULL;
+static size_t zoom_counts_cap = 0;
+
+static const char *LENIA_GROWTH_NAMES[LENIA_GROWTH_COUNT] = {
+    "Gauss",
+    "polinom",
+    "lépcső"
+};
+
+static const char *CYCLE_ACTION_NAMES[CYCLE_ACTION_COUNT] = {
+    "ki",
+    "csak kiírás",
+    "megállítás",
+    "átugrás"
+};
+
+static char buf[256];
+
+/** \brief Osszeallitja a beallitasok menu egy soranak szoveget
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param item SettingsItem A menu eleme
+ * \param text char* A szoveg helye
+ * \return void
+ *
+ */
+static void render_settings_item_text(GameVars *game_vars, SettingsItem item, char *text) {
+    char rule[RULE_TEXT_LENGTH];
+    switch (item) {
+    case SETTINGS_THREADS:
+        if (game_vars->settings.thread_count == 0) {
+            sprintf(text, "Szálak száma: automatikus (%d)", thread_pool_size(game_vars->thread_pool));
+        } else {
+            sprintf(text, "Szálak száma: %d", thread_pool_size(game_vars->thread_pool));
+        }
+        break;
+    case SETTINGS_KERNEL:
+        if (game_vars->settings.kernel == KERNEL_AUTO) {
+            sprintf(text, "Kernel: automatikus (%s)", kernel_name(kernel_current()));
+        } else {
+            sprintf(text, "Kernel: %s", kernel_name(kernel_current()));
+        }
+        // A meres eredmenye, ha mar volt (SPACE)
+        if (kernel_benchmark_result(kernel_current()) > 0) {
+            sprintf(text+strlen(text), " (%.0f Mcella/s)", kernel_benchmark_result(kernel_current()));
+        }
+        break;
+    case SETTINGS_SPEED:
+        sprintf(text, "Sebesség: %d generáció képkockánként", 1 << game_vars->settings.speed_log2);
+        if (game_vars->step_stats.generations > 0) {
+            sprintf(text + strlen(text), " (utoljára %d számolt, átlag %.0f csempe)", game_vars->step_stats.computed,
+                    game_vars->step_stats.computed > 0 ? (double)game_vars->step_stats.tiles/game_vars->step_stats.computed : 0.0);
+        }
+        break;
+    case SETTINGS_JUMP:
+        sprintf(text, "Ugrás (J): 2^%d generáció", game_vars->settings.jump_log2);
+        break;
+    case SETTINGS_HASHLIFE_CACHE:
+        if (game_vars->hashlife != NULL) {
+            sprintf(text, "HashLife gyorsítótár: %d MB (%u csomópont)", game_vars->settings.hashlife_cache_mb, (unsigned)hashlife_node_count(game_vars->hashlife));
+        } else {
+            sprintf(text, "HashLife gyorsítótár: %d MB", game_vars->settings.hashlife_cache_mb);
+        }
+        break;
+    case SETTINGS_WORLD:
+        if (game_vars->lenia != NULL) {
+            sprintf(text, "Élettér: folytonos tórusz (%dx%d, tömeg: %.0f)", game_vars->lenia->size_x, game_vars->lenia->size_y, lenia_mass(game_vars->lenia));
+        } else if (game_vars->world != NULL) {
+            sprintf(text, "Élettér: végtelen sík (%u darab)", (unsigned)game_vars->world->chunk_count);
+        } else if (game_vars->settings.unbounded) {
+            sprintf(text, "Élettér: végtelen sík");
+        } else {
+            sprintf(text, "Élettér: véges grid");
+        }
+        break;
+    case SETTINGS_TOPOLOGY:
+        switch (game_vars->settings.topology) {
+        case TOPOLOGY_BOUNDED:
+            sprintf(text, "Grid széle: zárt doboz");
+            break;
+        case TOPOLOGY_TORUS:
+            sprintf(text, "Grid széle: tórusz");
+            break;
+        case TOPOLOGY_KLEIN:
+            sprintf(text, "Grid széle: Klein-palack");
+            break;
+        default:
+            sprintf(text, "Grid széle: nyílt sík (növekvő)");
+            break;
+        }
+        break;
+    case SETTINGS_RULE:
+        rule_format(game_vars->settings.rule, rule);
+        if (rule_name(game_vars->settings.rule) != NULL) {
+            sprintf(text, "Szabály: %s (%s)", rule, rule_name(game_vars->settings.rule));
+        } else {
+            sprintf(text, "Szabály: %s", rule);
+        }
+        if (!kernel_specialized()) {
+            if (kernel_circuit_gates() >= 0) {
+                sprintf(text + strlen(text), ", áramkör: %d kapu", kernel_circuit_gates());
+            } else {
+                strcat(text, ", általános kernel");
+            }
+        }
+        break;
+    case SETTINGS_LENIA:
+        if (game_vars->settings.continuous) {
+            sprintf(text, "Folytonos mód (Lenia): %s növekedés, R=%d, T=%d", LENIA_GROWTH_NAMES[game_vars->settings.lenia.growth],
+                    game_vars->settings.lenia.radius, game_vars->settings.lenia.time_steps);
+        } else {
+            sprintf(text, "Folytonos mód (Lenia): ki");
+        }
+        break;
+    case SETTINGS_LENIA_MU:
+        sprintf(text, "Lenia növekedés közepe (μ): %.3f", game_vars->settings.lenia.mu);
+        break;
+    case SETTINGS_LENIA_SIGMA:
+        sprintf(text, "Lenia növekedés szélessége (σ): %.3f", game_vars->settings.lenia.sigma);
+        break;
+    case SETTINGS_CYCLE:
+        sprintf(text, "Ciklusfigyelés: %s", CYCLE_ACTION_NAMES[game_vars->settings.cycle_action]);
+        break;
+    case SETTINGS_CYCLE_PERIOD:
+        sprintf(text, "Leghosszabb figyelt periódus: %d generáció", game_vars->settings.cycle_period_max);
+        break;
+    default:
+        text[0] = '\0';
+        break;
+    }
+}
+
+/** \brief Kiirja a szimulacio cimsorat: az allapotot, a generaciot, a megtalalt periodust es (grid eseten) az elo cellak szamat
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param state const char* A szimulacio allapota
+ * \return void
+ *
+ */
+static void render_sim_title(GameVars *game_vars, const char *state) {
+    // Futo szimulacios szal eseten a szamlalokat is a rajzolt pillanatkep adja
+    const SimSnapshot *snapshot = sim_snapshot(game_vars->sim);
+    const uint64_t generation = snapshot != NULL ? snapshot->generation : game_vars->generation;
+    const int period = snapshot != NULL ? snapshot->cycle_period : game_vars->cycle.period;
+    sprintf(buf, "Szimuláció (%s), %llu. generáció", state, (unsigned long long)generation);
+    if (period == 1) {
+        sprintf(buf + strlen(buf), ", stabil");
+    } else if (period > 1) {
+        sprintf(buf + strlen(buf), ", periódus: %d", period);
+    }
+    if (game_vars->lenia == NULL && game_vars->world == NULL) {
+        GridStats stats = grid_stats(sim_view_grid(game_vars));
+        sprintf(buf + strlen(buf), ", %llu élő sejt (+%llu, -%llu)", (unsigned long long)stats.population,
+                (unsigned long long)stats.births, (unsigned long long)stats.deaths);
+    }
+    if (game_vars->zoom_log2 > 0) {
+        sprintf(buf + strlen(buf), ", kicsinyítés: 1:%d", 1 << game_vars->zoom_log2);
+    }
+    Game_SetFontDynamicText(game_vars->game_font, buf);
+    Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, 8);
+}
+
+/** \brief Letrehozza (szukseg eseten ujrameretezi) es zarolja a cellak texturajat
+ *
+ * A textura a cellameretre nagyitva is eles marad: a letrehozasakor a legkozelebbi szomszed szurest kerjuk.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param w int a textura szelessege cellakban
+ * \param h int a textura magassaga cellakban
+ * \param pitch int* ide kerul a sorok tavolsaga pixelekben
+ * \return Uint32* a textura pixelei (Hiba eseten NULL)
+ *
+ */
+static Uint32 *render_cells_lock(GameVars *game_vars, int w, int h, int *pitch) {
+    void *pixels;
+    char quality[16];
+    if (cell_texture == NULL || cell_texture_w != w || cell_texture_h != h) {
+        if (cell_texture != NULL) {
+            SDL_DestroyTexture(cell_texture);
+        }
+        // Az SDL 2.0.3-ban a szures csak a letrehozaskor, a hinten at allithato
+        SDL_strlcpy(quality, SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY) != NULL ? SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY) : "0", sizeof(quality));
+        SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "0");
+        cell_texture = SDL_CreateTexture(game_vars->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+        SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, quality);
+        if (cell_texture == NULL) {
+#ifdef NDEBUG
+            fprintf(stderr, "SDL hiba: %s\n", SDL_GetError());
+#endif // NDEBUG
+            return NULL;
+        }
+        cell_texture_w = w;
+        cell_texture_h = h;
+    }
+    if (SDL_LockTexture(cell_texture, NULL, &pixels, pitch) != 0) {
+#ifdef NDEBUG
+        fprintf(stderr, "SDL hiba: %s\n", SDL_GetError());
+#endif // NDEBUG
+        return NULL;
+    }
+    *pitch /= sizeof(Uint32);
+    return (Uint32*)pixels;
+}
+
+/** \brief Feloldja a cellak texturajat, es egyetlen SDL_RenderCopy-val kirajzolja
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param x int a textura bal szelenek helye a kepernyon cellakban
+ * \param y int a textura felso szelenek helye a kepernyon cellakban
+ * \return void
+ *
+ */
+static void render_cells_present(GameVars *game_vars, int x, int y) {
+    const int cell_size = game_vars->settings.cell_size;
+    SDL_Rect itemrect = {
+        x*cell_size, y*cell_size, cell_texture_w*cell_size, cell_texture_h*cell_size
+    };
+    SDL_UnlockTexture(cell_texture);
+    SDL_RenderCopy(game_vars->renderer, cell_texture, NULL, &itemrect);
+}
+
+/** \brief Kiirja egy cellasor bitjeit a textura egy soraba
+ *
+ * \param dst Uint32* a sor elso pixele
+ * \param alive const uint64_t* az elo cellak bitsikjanak sora
+ * \param seen const uint64_t* a valaha elt cellak bitsikjanak sora
+ * \param pos int az elso cella bitje a sorban
+ * \param count int a cellak szama
+ * \return void
+ *
+ */
+static void render_cell_row(Uint32 *dst, const uint64_t *alive, const uint64_t *seen, int pos, int count) {
+    // Szavankent bontjuk, igy a szohatarokon nem kell biteket atvinni
+    while (count > 0) {
+        int shift = pos % GRID_WORD_BITS;
+        int n = count < GRID_WORD_BITS - shift ? count : GRID_WORD_BITS - shift;
+        kernel_expand_bits(alive[pos / GRID_WORD_BITS] >> shift, seen[pos / GRID_WORD_BITS] >> shift, n, CELL_COLORS, dst);
+        dst += n;
+        pos += n;
+        count -= n;
+    }
+}
+
+/** \brief Kirajzolja a vegtelen vilag egy darabjanak kepernyore eso cellait a cellak texturajaba
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param chunk const WorldChunk* a darab
+ * \param pixels Uint32* a textura pixelei
+ * \param pitch int a sorok tavolsaga pixelekben
+ * \return void
+ *
+ */
+static void render_world_chunk(GameVars *game_vars, const WorldChunk *chunk, Uint32 *pixels, int pitch) {
+    const int64_t x0 = chunk->cx*WORLD_CHUNK_SIZE - game_vars->view_x;
+    const int64_t y0 = chunk->cy*WORLD_CHUNK_SIZE - game_vars->view_y;
+    int x_begin, x_end, r;
+    if (x0 >= cell_texture_w || y0 >= cell_texture_h || x0 + WORLD_CHUNK_SIZE <= 0 || y0 + WORLD_CHUNK_SIZE <= 0) {
+        return;
+    }
+    x_begin = x0 < 0 ? 0 : (int)x0;
+    x_end = x0 + WORLD_CHUNK_SIZE > cell_texture_w ? cell_texture_w : (int)x0 + WORLD_CHUNK_SIZE;
+    for (r=0; r<WORLD_CHUNK_SIZE; r++) {
+        if (y0 + r < 0 || y0 + r >= cell_texture_h || (chunk->cells[r] | chunk->was_alive[r]) == 0) {
+            continue;
+        }
+        render_cell_row(pixels + (y0 + r)*pitch + x_begin, &chunk->cells[r], &chunk->was_alive[r], x_begin - (int)x0, x_end - x_begin);
+    }
+}
+
+/** \brief Kirajzolja a vegtelen vilag kepernyore eso darabjait
+ *
+ * Ha a kepernyore kevesebb darab fer, mint ahany a vilagban van, a latszo darabokat
+ * egyenkent keresi meg a hash tablaban, igy a rajzolas ideje a kepernyo meretetol fugg, nem a vilagetol.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \return void
+ *
+ */
+static void render_world(GameVars *game_vars) {
+    const World *world = game_vars->world;
+    const int cell_size = game_vars->settings.cell_size;
+    const int cols = game_vars->window_size.w/cell_size + 1;
+    const int rows = game_vars->window_size.h/cell_size + 1;
+    const int64_t cx_begin = world_chunk_coord(game_vars->view_x);
+    const int64_t cy_begin = world_chunk_coord(game_vars->view_y);
+    const int64_t cx_end = world_chunk_coord(game_vars->view_x + cols - 1) + 1;
+    const int64_t cy_end = world_chunk_coord(game_vars->view_y + rows - 1) + 1;
+    const WorldChunk *chunk;
+    Uint32 *pixels;
+    int64_t cx, cy;
+    size_t i;
+    int pitch, y;
+    pixels = render_cells_lock(game_vars, cols, rows, &pitch);
+    if (pixels == NULL) {
+        return;
+    }
+    for (y=0; y<rows; y++) {
+        SDL_memset4(pixels + y*pitch, CELL_COLORS[0], cols);
+    }
+    if ((uint64_t)((cx_end - cx_begin)*(cy_end - cy_begin)) < world->chunk_count) {
+        for (cy=cy_begin; cy<cy_end; cy++) {
+            for (cx=cx_begin; cx<cx_end; cx++) {
+                chunk = world_chunk_find(world, cx, cy);
+                if (chunk != NULL) {
+                    render_world_chunk(game_vars, chunk, pixels, pitch);
+                }
+            }
+        }
+    } else {
+        for (i=0; i<world->table_size; i++) {
+            for (chunk=world->table[i]; chunk!=NULL; chunk=chunk->next) {
+                render_world_chunk(game_vars, chunk, pixels, pitch);
+            }
+        }
+    }
+    render_cells_present(game_vars, 0, 0);
+}
+
+/** \brief Kirajzolja a grid kicsinyitett kepet: egy pixel egy 2^zoom_log2 oldalu blokk surusege
+ *
+ * A nagy blokkok a mip piramisbol jonnek (ezt a grid valtozott csempei frissitik, nem az egesz grid),
+ * a MIP_BLOCK_LOG2-nel kisebbek kozvetlenul a bitsikbol.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \return void
+ *
+ */
+static void render_grid_zoomed(GameVars *game_vars) {
+    Grid *grid = sim_view_grid(game_vars);
+    const int zoom = game_vars->zoom_log2;
+    const int block = 1 << zoom;
+    const int64_t bx_begin = game_vars->view_x >> zoom;
+    const int64_t by_begin = game_vars->view_y >> zoom;
+    const int w = game_vars->window_size.w;
+    const int h = game_vars->window_size.h;
+    Uint32 *pixels;
+    int pitch, px, py, r;
+    if (game_vars->mip == NULL) {
+        game_vars->mip = mip_new();
+    }
+    if (game_vars->mip == NULL || !mip_update(game_vars->mip, grid)) {
+        return;
+    }
+    pixels = render_cells_lock(game_vars, w, h, &pitch);
+    if (pixels == NULL) {
+        return;
+    }
+    for (py=0; py<h; py++) {
+        Uint32 *dst = pixels + py*pitch;
+        const int64_t by = by_begin + py;
+        SDL_memset4(dst, zoom_palette[0], w);
+        if (zoom >= MIP_BLOCK_LOG2) {
+            const GridMip *mip = game_vars->mip;
+            const int k = zoom - MIP_BLOCK_LOG2 < mip->levels ? zoom - MIP_BLOCK_LOG2 : mip->levels - 1;
+            const uint8_t *level;
+            if (by >= mip->size_y[k]) {
+                continue;
+            }
+            level = mip->level[k] + (size_t)by*mip->size_x[k];
+            for (px=0; px<w && bx_begin + px<mip->size_x[k]; px++) {
+                dst[px] = zoom_palette[level[bx_begin + px]];
+            }
+        } else {
+            // Egy blokk egy szon belul van (a blokk merete 64 osztoja)
+            const uint64_t block_mask = ((uint64_t)1 << block) - 1;
+            for (px=0; px<w && (bx_begin + px)*block<grid->size_x; px++) {
+                const int x = (int)(bx_begin + px)*block;
+                const int shift = (x + GRID_HALO_WORDS*GRID_WORD_BITS) % GRID_WORD_BITS;
+                uint64_t mask = block_mask;
+                int count = 0;
+                if (x + block > grid->size_x) {
+                    mask = ((uint64_t)1 << (grid->size_x - x)) - 1;
+                }
+                for (r=(int)by*block; r<(int)(by + 1)*block && r<grid->size_y; r++) {
+                    const uint64_t *row = grid_row(grid, grid->cells, r);
+                    count += grid_popcount((row[(x + GRID_HALO_WORDS*GRID_WORD_BITS) / GRID_WORD_BITS] >> shift) & mask);
+                }
+                dst[px] = zoom_palette[count*255 >> (2*zoom)];
+            }
+        }
+    }
+    render_cells_present(game_vars, 0, 0);
+}
+
+/** \brief Hozzaadja a vegtelen vilag egy darabjanak cellaszamait a kicsinyitett kep pixeleihez
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \param chunk const WorldChunk* a darab
+ * \param w int a kep szelessege
+ * \param h int a kep magassaga
+ * \return void
+ *
+ */
+static void render_world_zoomed_chunk(GameVars *game_vars, const WorldChunk *chunk, int w, int h) {
+    const int zoom = game_vars->zoom_log2;
+    const int64_t bx_begin = game_vars->view_x >> zoom;
+    const int64_t by_begin = game_vars->view_y >> zoom;
+    const int64_t x0 = chunk->cx*WORLD_CHUNK_SIZE;
+    const int64_t y0 = chunk->cy*WORLD_CHUNK_SIZE;
+    const int block = zoom < 6 ? 1 << zoom : WORLD_CHUNK_SIZE;
+    const uint64_t block_mask = block < GRID_WORD_BITS ? ((uint64_t)1 << block) - 1 : ~(uint64_t)0;
+    int r, b;
+    if ((x0 >> zoom) - bx_begin >= w || (y0 >> zoom) - by_begin >= h ||
+            ((x0 + WORLD_CHUNK_SIZE - 1) >> zoom) < bx_begin || ((y0 + WORLD_CHUNK_SIZE - 1) >> zoom) < by_begin) {
+        return;
+    }
+    for (r=0; r<WORLD_CHUNK_SIZE; r++) {
+        const int64_t py = ((y0 + r) >> zoom) - by_begin;
+        if (py < 0 || py >= h || chunk->cells[r] == 0) {
+            continue;
+        }
+        // A darab egy sora blokkonkent (a 64-nel nagyobb blokkoknal egyben) egy-egy pixelhez adodik
+        for (b=0; b<WORLD_CHUNK_SIZE; b+=block) {
+            const int64_t px = ((x0 + b) >> zoom) - bx_begin;
+            if (px >= 0 && px < w) {
+                zoom_counts[py*w + px] += grid_popcount((chunk->cells[r] >> b) & block_mask);
+            }
+        }
+    }
+}
+
+/** \brief Kirajzolja a vegtelen vilag kicsinyitett kepet: egy pixel egy 2^zoom_log2 oldalu blokk surusege
+ *
+ * A pixelek cellaszamai a latszo (vagy, ha az kevesebb, az osszes) darabbol gyulnek, igy a munka
+ * az elo cellakat tartalmazo darabok szamatol fugg, nem a kepernyon latszo teruletetol.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \return void
+ *
+ */
+static void render_world_zoomed(GameVars *game_vars) {
+    const World *world = game_vars->world;
+    const int zoom = game_vars->zoom_log2;
+    const int w = game_vars->window_size.w;
+    const int h = game_vars->window_size.h;
+    const int64_t block = (int64_t)1 << zoom;
+    const int64_t cx_begin = world_chunk_coord((game_vars->view_x >> zoom)*block);
+    const int64_t cy_begin = world_chunk_coord((game_vars->view_y >> zoom)*block);
+    const int64_t cx_end = world_chunk_coord(((game_vars->view_x >> zoom) + w)*block - 1) + 1;
+    const int64_t cy_end = world_chunk_coord(((game_vars->view_y >> zoom) + h)*block - 1) + 1;
+    const WorldChunk *chunk;
+    Uint32 *pixels;
+    int64_t cx, cy;
+    size_t i;
+    int pitch, px, py;
+    if (zoom_counts_cap < (size_t)w*h) {
+        uint32_t *counts = realloc(zoom_counts, sizeof(uint32_t)*w*h);
+        if (counts == NULL) {
+#ifdef NDEBUG
+            fprintf(stderr, "Malloc hiba a kicsinyitett kep letrehozasanal.\n");
+#endif // NDEBUG
+            return;
+        }
+        zoom_counts = counts;
+        zoom_counts_cap = (size_t)w*h;
+    }
+    memset(zoom_counts, 0, sizeof(uint32_t)*w*h);
+    if ((uint64_t)((cx_end - cx_begin)*(cy_end - cy_begin)) < world->chunk_count) {
+        for (cy=cy_begin; cy<cy_end; cy++) {
+            for (cx=cx_begin; cx<cx_end; cx++) {
+                chunk = world_chunk_find(world, cx, cy);
+                if (chunk != NULL) {
+                    render_world_zoomed_chunk(game_vars, chunk, w, h);
+                }
+            }
+        }
+    } else {
+        for (i=0; i<world->table_size; i++) {
+            for (chunk=world->table[i]; chunk!=NULL; chunk=chunk->next) {
+                render_world_zoomed_chunk(game_vars, chunk, w, h);
+            }
+        }
+    }
+    pixels = render_cells_lock(game_vars, w, h, &pitch);
+    if (pixels == NULL) {
+        return;
+    }
+    for (py=0; py<h; py++) {
+        for (px=0; px<w; px++) {
+            uint64_t density = ((uint64_t)zoom_counts[py*w + px]*255) >> (2*zoom);
+            pixels[py*pitch + px] = zoom_palette[density < 255 ? density : 255];
+        }
+    }
+    render_cells_present(game_vars, 0, 0);
+}
+
+/** \brief Kirajzolja a folytonos mezo kepernyore eso reszet
+ *
+ * A cellak nem egyenkent kerulnek a kepernyore: a lathato resz a palettan at egy streaming
+ * texturaba irodik (egyetlen feltoltes), amit egyetlen SDL_RenderCopy nagyit a cellameretre.
+ *
+ * \param game_vars GameVars* A jatek fo valtozoja
+ * \return void
+ *
+ */
+static void render_lenia(GameVars *game_vars) {
+    const Lenia *lenia = game_vars->lenia;
+    const int cell_size = game_vars->settings.cell_size;
+    int w = game_vars->window_size.w/cell_size + 1;
+    int h = game_vars->window_size.h/cell_size + 1;
+    SDL_Rect itemrect;
+    void *pixels;
+    int pitch, x, y;
+    if (w > lenia->size_x) {
+        w = lenia->size_x;
+    }
+    if (h > lenia->size_y) {
+        h = lenia->size_y;
+    }
+    if (lenia_texture == NULL || lenia_texture_w != w || lenia_texture_h != h) {
+        if (lenia_texture != NULL) {
+            SDL_DestroyTexture(lenia_texture);
+        }
+        lenia_texture = SDL_CreateTexture(game_vars->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+        if (lenia_texture == NULL) {
+#ifdef NDEBUG
+            fprintf(stderr, "SDL hiba: %s\n", SDL_GetError());
+#endif // NDEBUG
+            return;
+        }
+        lenia_texture_w = w;
+        lenia_texture_h = h;
+    }
+    if (SDL_LockTexture(lenia_texture, NULL, &pixels, &pitch) != 0) {
+#ifdef NDEBUG
+        fprintf(stderr, "SDL hiba: %s\n", SDL_GetError());
+#endif // NDEBUG
+        return;
+    }
+    for (y=0; y<h; y++) {
+        const float *src = lenia->field + (size_t)y*lenia->size_x;
+        Uint32 *dst = (Uint32*)((Uint8*)pixels + y*pitch);
+        for (x=0; x<w; x++) {
+            dst[x] = lenia_palette[(int)(src[x]*255.0f + 0.5f)];
+        }
+    }
+    SDL_UnlockTexture(lenia_texture);
+    itemrect = (SDL_Rect) {
+        0, 0, w*cell_size, h*cell_size
+    };
+    SDL_RenderCopy(game_vars->renderer, lenia_texture, NULL, &itemrect);
+}
+
+/** \brief Kitolti a folytonos mezo palettajat (fekete, majd kek-cian-sarga-voros atmenet)
+ *
+ * \return void
+ *
+ */
+static void render_lenia_palette(void) {
+    int i;
+    lenia_palette[0] = 0xFF000000;
+    for (i=1; i<256; i++) {
+        double t = i/255.0;
+        double r = 1.5 - fabs(4*t - 3);
+        double g = 1.5 - fabs(4*t - 2);
+        double b = 1.5 - fabs(4*t - 1);
+        r = r < 0 ? 0 : r > 1 ? 1 : r;
+        g = g < 0 ? 0 : g > 1 ? 1 : g;
+        b = b < 0 ? 0 : b > 1 ? 1 : b;
+        lenia_palette[i] = 0xFF000000 | (Uint32)(r*255) << 16 | (Uint32)(g*255) << 8 | (Uint32)(b*255);
+    }
+}
+
+/** \brief Kitolti a kicsinyitett kep palettajat: a hattertol az elo cella szineig, a ritka blokkok is lathatoak maradnak
+ *
+ * \return void
+ *
+ */
+static void render_zoom_palette(void) {
+    int i, c;
+    for (i=0; i<256; i++) {
+        // Negyzetgyokos atmenet, hogy az egy-ket elo cellat tartalmazo blokkok se olvadjanak a hatterbe
+        double t = sqrt(i/255.0);
+        zoom_palette[i] = 0xFF000000;
+        for (c=0; c<24; c+=8) {
+            double from = (CELL_COLORS[0] >> c) & 0xFF;
+            double to = (CELL_COLORS[2] >> c) & 0xFF;
+            zoom_palette[i] |= (Uint32)(from + (to - from)*t + 0.5) << c;
+        }
+    }
+}
 
 void render_init(GameVars *game_vars) {
-    cell_texture_alive = Game_Load_Texture(CELL_TEXTURE_ALIVE_PATH, game_vars->renderer);
-    cell_texture_dead = Game_Load_Texture(CELL_TEXTURE_DEAD_PATH, game_vars->renderer);
     menubg = Game_Load_Texture(MENU_BG_TEXTURE_PATH, game_vars->renderer);
     int i;
     for (i=0; i<4; i++) {
         gamelogo[i] = Game_Load_Texture(GAME_LOGO_TEXTURE_PATH[i], game_vars->renderer);
     }
+    render_lenia_palette();
+    render_zoom_palette();
 }
 
 void render_destroy(void) {
-    if (cell_texture_alive != NULL) {
-        SDL_DestroyTexture(cell_texture_alive);
-        cell_texture_alive = NULL;
-    }
-    if (cell_texture_dead != NULL) {
-        SDL_DestroyTexture(cell_texture_dead);
-        cell_texture_dead = NULL;
+    if (cell_texture != NULL) {
+        SDL_DestroyTexture(cell_texture);
+        cell_texture = NULL;
     }
     if (menubg != NULL) {
         SDL_DestroyTexture(menubg);
         menubg = NULL;
     }
+    if (lenia_texture != NULL) {
+        SDL_DestroyTexture(lenia_texture);
+        lenia_texture = NULL;
+    }
+    free(zoom_counts);
+    zoom_counts = NULL;
+    zoom_counts_cap = 0;
     int i;
     for (i=0; i<4; i++) {
         if (gamelogo[i] != NULL) {
@@ -70,25 +670,66 @@ void render_destroy(void) {
 }
 
 void render_grid(GameVars *game_vars) {
-    int i,j;
-    SDL_Rect itemrect;
-    // Az elso ervenyes elem az 1. indexu - a szegely miatt
-    for (i=0; i<game_vars->grid->size_x-1; i++) {
-        for (j=0; j<game_vars->grid->size_y-1; j++) {
-            Cell tmpcell = game_vars->grid->cells[i+1][j+1];
-            if (tmpcell.state) {
-                itemrect = (SDL_Rect) {
-                    game_vars->settings.cell_size *i, game_vars->settings.cell_size *j, game_vars->settings.cell_size, game_vars->settings.cell_size
-                };
-                SDL_RenderCopy(game_vars->renderer, cell_texture_alive, NULL, &itemrect);
-            } else if (tmpcell.was_alive) {
-                itemrect = (SDL_Rect) {
-                    game_vars->settings.cell_size *i, game_vars->settings.cell_size *j, game_vars->settings.cell_size, game_vars->settings.cell_size
-                };
-                SDL_RenderCopy(game_vars->renderer, cell_texture_dead, NULL, &itemrect);
+    if (game_vars->lenia != NULL) {
+        render_lenia(game_vars);
+        return;
+    }
+    if (game_vars->world != NULL) {
+        if (game_vars->zoom_log2 > 0) {
+            render_world_zoomed(game_vars);
+        } else {
+            render_world(game_vars);
+        }
+        return;
+    }
+    if (game_vars->zoom_log2 > 0) {
+        render_grid_zoomed(game_vars);
+        return;
+    }
+    Grid *grid = sim_view_grid(game_vars);
+    const int cell_size = game_vars->settings.cell_size;
+    const int dying_states = grid->dying_states;
+    // Csak a kepernyore eso cellak teglalapjat rajzoljuk (a grid utolso sora es oszlopa a novekedes tartaleka)
+    const int x_begin = game_vars->view_x > 0 ? (int)game_vars->view_x : 0;
+    const int y_begin = game_vars->view_y > 0 ? (int)game_vars->view_y : 0;
+    const int halo = GRID_HALO_WORDS*GRID_WORD_BITS;
+    int x_end = (int)game_vars->view_x + game_vars->window_size.w/cell_size + 1;
+    int y_end = (int)game_vars->view_y + game_vars->window_size.h/cell_size + 1;
+    Uint32 *pixels;
+    int pitch, j, w, p, bit;
+    if (x_end > grid->size_x - 1) {
+        x_end = grid->size_x - 1;
+    }
+    if (y_end > grid->size_y - 1) {
+        y_end = grid->size_y - 1;
+    }
+    if (x_end <= x_begin || y_end <= y_begin) {
+        return;
+    }
+    pixels = render_cells_lock(game_vars, x_end - x_begin, y_end - y_begin, &pitch);
+    if (pixels == NULL) {
+        return;
+    }
+    for (j=y_begin; j<y_end; j++) {
+        Uint32 *dst = pixels + (j - y_begin)*pitch;
+        render_cell_row(dst, grid_row(grid, grid->cells, j), grid_row(grid, grid->was_alive, j), x_begin + halo, x_end - x_begin);
+        // A haldoklo cellak (ritkak) utolag, cellankent kapjak meg fokonkent egyre sotetebb kek szinuket
+        for (w=(x_begin + halo)/GRID_WORD_BITS; w<=(x_end - 1 + halo)/GRID_WORD_BITS; w++) {
+            uint64_t bits = 0;
+            for (p=0; p<grid->age_planes; p++) {
+                bits |= grid_row(grid, grid->ages + p*grid_plane_words(grid), j)[w];
+            }
+            for (bit=0; bits!=0; bit++, bits>>=1) {
+                int x = w*GRID_WORD_BITS + bit - halo;
+                if ((bits & 1) && x >= x_begin && x < x_end) {
+                    int shade = 255 - 160*((int)grid_get(grid, x, j).state - dying)/dying_states;
+                    dst[x - x_begin] = 0xFF000000 | ((CELL_COLORS[2] >> 16 & 0xFF)*shade/4/255) << 16 |
+                                       ((CELL_COLORS[2] >> 8 & 0xFF)*shade/2/255) << 8 | (CELL_COLORS[2] & 0xFF)*shade/255;
+                }
             }
         }
     }
+    render_cells_present(game_vars, x_begin - (int)game_vars->view_x, y_begin - (int)game_vars->view_y);
 }
 
 void render_menu_main(GameVars *game_vars) {
@@ -115,7 +756,7 @@ void render_menu_load(GameVars *game_vars) {
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, 8);
     struct tm *save_date = localtime(&(game_vars->settings.save_modified));
     sprintf(buf, "A mentés létrehozva: %4d.%02d.%02d. %02d:%02d", 1900+save_date->tm_year, save_date->tm_mon, 1+save_date->tm_mday, save_date->tm_hour, save_date->tm_min);
-    Game_SetFontText(game_vars->game_font, buf);
+    Game_SetFontDynamicText(game_vars->game_font, buf);
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h/2-game_vars->game_font->texture_size.y/2);
     Game_SetFontText(game_vars->game_font, "ESC: Főmenü, SPACE: Élettér betöltése");
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h-game_vars->game_font->texture_size.y-8);
@@ -132,10 +773,10 @@ void render_menu_new(GameVars *game_vars) {
     Game_SetFontText(game_vars->game_font, "BAL/JOBB: Grid szélessége, FEL/LE: Grid magassága");
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h-game_vars->game_font->texture_size.y-32);
     sprintf(buf, "Szélesség: %g", game_vars->grid_size.x);
-    Game_SetFontText(game_vars->game_font, buf);
+    Game_SetFontDynamicText(game_vars->game_font, buf);
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h/2-game_vars->game_font->texture_size.y/2);
     sprintf(buf, "Magasság: %g",  game_vars->grid_size.y);
-    Game_SetFontText(game_vars->game_font, buf);
+    Game_SetFontDynamicText(game_vars->game_font, buf);
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h/2+game_vars->game_font->texture_size.y/2);
     SDL_RenderPresent(game_vars->renderer);
 }
@@ -160,8 +801,23 @@ void render_menu_settings(GameVars *game_vars) {
     SDL_RenderClear(game_vars->renderer);
     Game_SetFontText(game_vars->game_font, "Szimuláció beállításai");
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, 8);
+    int i;
+    char text[160];
+    // A kivalasztott elemet nyilak jelolik
+    for (i=0; i<SETTINGS_ITEM_COUNT; i++) {
+        render_settings_item_text(game_vars, i, text);
+        if (i == (int)game_vars->settings_item) {
+            sprintf(buf, "> %s <", text);
+        } else {
+            sprintf(buf, "%s", text);
+        }
+        Game_SetFontDynamicText(game_vars->game_font, buf);
+        Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h/2+(i-SETTINGS_ITEM_COUNT/2)*(game_vars->game_font->texture_size.y+8));
+    }
     Game_SetFontText(game_vars->game_font, "ESC: Vissza a Szimuláció menübe");
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h-game_vars->game_font->texture_size.y-8);
+    Game_SetFontText(game_vars->game_font, "FEL/LE: Beállítás kiválasztása, BAL/JOBB: Érték módosítása, SPACE: Kernelek mérése");
+    Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h-game_vars->game_font->texture_size.y-32);
     SDL_RenderPresent(game_vars->renderer);
 }
 
@@ -191,11 +847,14 @@ void render_sim_paused(GameVars *game_vars) {
     SDL_SetRenderDrawColor(game_vars->renderer, 0x00, 0x00, 0x00, 0xFF);
     SDL_RenderClear(game_vars->renderer);
     render_grid(game_vars);
-    Game_SetFontText(game_vars->game_font, "Szimuláció (szünetel)");
-    Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, 8);
-    Game_SetFontText(game_vars->game_font, "ESC: Szimuláció menü, SPACE: Szimuláció futtatása");
+    render_sim_title(game_vars, "szünetel");
+    Game_SetFontText(game_vars->game_font, "ESC: Szimuláció menü, SPACE: Szimuláció futtatása, J: Ugrás (HashLife)");
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h-game_vars->game_font->texture_size.y-8);
-    Game_SetFontText(game_vars->game_font, "Bal egér: Cella felélesztése, Jobb egér: Cella megölése");
+    if (game_vars->lenia != NULL) {
+        Game_SetFontText(game_vars->game_font, "Bal egér: Véletlen folt rajzolása, Jobb egér: Folt törlése");
+    } else {
+        Game_SetFontText(game_vars->game_font, "Bal egér: Cella felélesztése, Jobb egér: Cella megölése, WASD: Nézet mozgatása");
+    }
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h-game_vars->game_font->texture_size.y-32);
     SDL_RenderPresent(game_vars->renderer);
 
@@ -205,11 +864,14 @@ void render_sim_running(GameVars *game_vars) {
     SDL_SetRenderDrawColor(game_vars->renderer, 0x00, 0x00, 0x00, 0xFF);
     SDL_RenderClear(game_vars->renderer);
     render_grid(game_vars);
-    Game_SetFontText(game_vars->game_font, "Szimuláció (fut)");
-    Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, 8);
+    render_sim_title(game_vars, "fut");
     Game_SetFontText(game_vars->game_font, "ESC: Szimuláció menü, SPACE: Szimuláció szüneteltetése");
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h-game_vars->game_font->texture_size.y-8);
-    Game_SetFontText(game_vars->game_font, "Bal egér: Cella felélesztése, Jobb egér: Cella megölése");
+    if (game_vars->lenia != NULL) {
+        Game_SetFontText(game_vars->game_font, "Bal egér: Véletlen folt rajzolása, Jobb egér: Folt törlése");
+    } else {
+        Game_SetFontText(game_vars->game_font, "Bal egér: Cella felélesztése, Jobb egér: Cella megölése, WASD: Nézet mozgatása");
+    }
     Game_RenderFont(game_vars->game_font, game_vars->window_size.w/2-game_vars->game_font->texture_size.x/2, game_vars->window_size.h-game_vars->game_font->texture_size.y-32);
     SDL_RenderPresent(game_vars->renderer);
 
@@ -0,0 +1,760 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_rule.c
+ * Description:     A B/S szabalyok beolvasasa, kiirasa es forditasa
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include "gol_main.h"
+#include "gol_rule.h"
+
+/** \brief Egy elore megadott, kozismert szabaly
+ */
+typedef struct t_rule_preset {
+    const char *name;   /**< A szabaly neve */
+    Rule rule;          /**< A szabaly */
+} RulePreset;
+
+// Az elso elem az alapertelmezett eletjatek
+static const RulePreset rule_presets[] = {
+    {"Életjáték", {0x008, 0x00C, 0, 0, 0, {0}}},          // B3/S23
+    {"HighLife", {0x048, 0x00C, 0, 0, 0, {0}}},           // B36/S23
+    {"Day & Night", {0x1C8, 0x1D8, 0, 0, 0, {0}}},        // B3678/S34678
+    {"Seeds", {0x004, 0x000, 0, 0, 0, {0}}},              // B2/S
+    {"Halál nélküli élet", {0x008, 0x1FF, 0, 0, 0, {0}}}, // B3/S012345678
+    {"2x2", {0x048, 0x026, 0, 0, 0, {0}}},                // B36/S125
+    {"Morley", {0x148, 0x034, 0, 0, 0, {0}}},             // B368/S245
+    {"Diamoeba", {0x1E8, 0x1E0, 0, 0, 0, {0}}},           // B35678/S5678
+    {"Replicator", {0x0AA, 0x0AA, 0, 0, 0, {0}}},         // B1357/S1357
+    {"Maze", {0x008, 0x03E, 0, 0, 0, {0}}},               // B3/S12345
+    {"Just Friends", {0x000, 0x006, 0x0DC, 0x0, 0, {0}}}, // B2-a/S12
+    {"tlife", {0x008, 0x008, 0x0, 0x20000BC, 0, {0}}},    // B3/S2-i34q
+    {"Brian's Brain", {0x004, 0x000, 0, 0, 1, {0}}},      // B2/S/C3
+    {"Star Wars", {0x004, 0x038, 0, 0, 2, {0}}},          // B2/S345/C4
+    {"Bosco", {0, 0, 0, 0, 0, {5, 1, 34, 45, 34, 58}}},   // R5,C0,M1,S34..58,B34..45,NM
+    {"Majority", {0, 0, 0, 0, 0, {4, 1, 41, 81, 41, 81}}} // R4,C0,M1,S41..81,B41..81,NM
+};
+
+// A Hensel-jeloles betui: az n szomszedhoz tartozo alakzatok a betusor elso rule_hensel_letters[n] betuje
+// (5..7 szomszednal a 3..1 szomszedos alakzatok negaltjai), a maszkban az n. szomszedszam betui
+// a rule_hensel_offset[n]. bittol kezdodnek.
+static const char rule_hensel_alphabet[] = "cekainyqjrtwz";
+static const int rule_hensel_letters[9] = {0, 2, 6, 10, 13, 10, 6, 2, 0};
+static const int rule_hensel_offset[9] = {0, 0, 2, 8, 18, 31, 41, 47, 49};
+
+// Az alakzatok egy-egy kepviseloje 1..4 szomszedra, a betuk sorrendjeben.
+// A szomszedok bitjei: 0: E (eszak), 1: EK, 2: K, 3: DK, 4: D, 5: DNy, 6: Ny, 7: ENy
+static const uint8_t rule_hensel_shapes[5][13] = {
+    {0},
+    {0x02, 0x01},
+    {0x0A, 0x05, 0x09, 0x03, 0x11, 0x22},
+    {0x2A, 0x15, 0x25, 0x07, 0x83, 0x0B, 0x29, 0x23, 0x43, 0x13},
+    {0xAA, 0x55, 0x4B, 0x0F, 0x1B, 0x8B, 0x2B, 0x27, 0x53, 0x17, 0x93, 0x63, 0x33}
+};
+
+// A szomszedok 256 lehetseges elrendezesenek alakzata (a maszk bitje, -1: 0 es 8 szomszed)
+static int8_t rule_hensel_class[256];
+static int rule_hensel_ready = 0;
+
+/** \brief Feltolti a szomszedsagok alakzatainak tablajat
+ *
+ * Minden kepviselot a negyzet nyolc szimmetriajaval (forgatasok es tukrozesek) vesz fel.
+ *
+ * \return void
+ *
+ */
+static void rule_hensel_init(void) {
+    int n, letter, sym, bit;
+    if (rule_hensel_ready) {
+        return;
+    }
+    memset(rule_hensel_class, -1, sizeof(rule_hensel_class));
+    for (n=1; n<=7; n++) {
+        for (letter=0; letter<rule_hensel_letters[n]; letter++) {
+            unsigned shape = n <= 4 ? rule_hensel_shapes[n][letter] : ~rule_hensel_shapes[8-n][letter] & 0xFF;
+            for (sym=0; sym<4; sym++) {
+                unsigned mirrored = 0;
+                // Tukrozes a fuggoleges tengelyre: az i. szomszed a (8-i). helyre kerul
+                for (bit=0; bit<8; bit++) {
+                    if (shape & (1 << bit)) {
+                        mirrored |= 1 << ((8 - bit) % 8);
+                    }
+                }
+                rule_hensel_class[shape] = rule_hensel_offset[n] + letter;
+                rule_hensel_class[mirrored] = rule_hensel_offset[n] + letter;
+                // Forgatas 90 fokkal
+                shape = ((shape << 2) | (shape >> 6)) & 0xFF;
+            }
+        }
+    }
+    rule_hensel_ready = 1;
+}
+
+/** \brief Visszaadja az n szomszedhoz tartozo osszes alakzat maszkjat
+ *
+ * \param n int a szomszedok szama
+ * \return uint64_t a maszk (a rule_hensel_offset[n]. bittol)
+ *
+ */
+static uint64_t rule_hensel_all(int n) {
+    return (((uint64_t)1 << rule_hensel_letters[n]) - 1) << rule_hensel_offset[n];
+}
+
+/** \brief A teljesen megadott szomszedszamok alakzatait a szomszedszam bitjebe vonja ossze
+ *
+ * \param counts uint16_t* a szomszedszamok maszkja
+ * \param hensel uint64_t* az alakzatok maszkja
+ * \return void
+ *
+ */
+static void rule_normalize(uint16_t *counts, uint64_t *hensel) {
+    int n;
+    for (n=0; n<=8; n++) {
+        uint64_t all = rule_hensel_all(n);
+        if (all != 0 && (*hensel & all) == all) {
+            *counts |= 1 << n;
+        }
+        if (*counts & (1 << n)) {
+            *hensel &= ~all;
+        }
+    }
+}
+
+/** \brief Beolvas egy szomszedszam-felsorolast (peldaul "2-a34q")
+ *
+ * A szamjegy utani betuk az alakzatok kozul csak a felsoroltakat, a '-' utaniak a felsoroltak
+ * kivetelevel az osszeset jelolik; betu nelkul a szamjegy minden alakzatot jelent.
+ *
+ * \param text const char** a szoveg, az olvasas utan a felsorolas utan mutat
+ * \param counts uint16_t* ide kerulnek a teljes szomszedszamok
+ * \param hensel uint64_t* ide kerulnek az alakzatok
+ * \return int 1, ha sikerult; 0, ha a '-' utan nem all betu
+ *
+ */
+static int rule_parse_counts(const char **text, uint16_t *counts, uint64_t *hensel) {
+    while (**text >= '0' && **text <= '8') {
+        int n = *(*text)++ - '0';
+        int negate = 0;
+        uint64_t letters = 0;
+        const char *letter;
+        if (**text == '-') {
+            negate = 1;
+            (*text)++;
+        }
+        while (**text != '\0' && (letter = strchr(rule_hensel_alphabet, tolower((unsigned char)**text))) != NULL
+                && letter - rule_hensel_alphabet < rule_hensel_letters[n]) {
+            letters |= (uint64_t)1 << (letter - rule_hensel_alphabet);
+            (*text)++;
+        }
+        if (negate && letters == 0) {
+            return 0;
+        }
+        if (letters == 0) {
+            *counts |= 1 << n;
+        } else {
+            *hensel |= (negate ? ~letters : letters) << rule_hensel_offset[n] & rule_hensel_all(n);
+        }
+    }
+    rule_normalize(counts, hensel);
+    return 1;
+}
+
+/** \brief Beolvas egy nem negativ egesz szamot
+ *
+ * \param text const char** a szoveg, az olvasas utan a szam utan mutat
+ * \param value int* ide kerul a szam
+ * \param max int a legnagyobb elfogadott ertek
+ * \return int 1, ha sikerult; 0, ha a szam hianyzik vagy nagyobb mint max
+ *
+ */
+static int rule_parse_number(const char **text, int *value, int max) {
+    int number = 0;
+    if (!isdigit((unsigned char)**text)) {
+        return 0;
+    }
+    while (isdigit((unsigned char)**text)) {
+        number = number*10 + *(*text)++ - '0';
+        if (number > max) {
+            return 0;
+        }
+    }
+    *value = number;
+    return 1;
+}
+
+/** \brief Beolvassa az allapotok szamat (Generations szabalyok)
+ *
+ * \param text const char** a szoveg, az olvasas utan a szam utan mutat
+ * \param dying uint8_t* ide kerul a haldoklo allapotok szama
+ * \return int 1, ha sikerult; 0, ha a szam hianyzik vagy kivul esik a 2..RULE_STATES_MAX tartomanyon
+ *
+ */
+static int rule_parse_states(const char **text, uint8_t *dying) {
+    int states;
+    if (!rule_parse_number(text, &states, RULE_STATES_MAX) || states < 2) {
+        return 0;
+    }
+    *dying = states - 2;
+    return 1;
+}
+
+/** \brief Beolvas egy "min..max" tartomanyt
+ *
+ * \param text const char** a szoveg, az olvasas utan a tartomany utan mutat
+ * \param min uint16_t* ide kerul az also hatar
+ * \param max uint16_t* ide kerul a felso hatar
+ * \return int 1, ha sikerult; 0 hibas tartomany eseten
+ *
+ */
+static int rule_parse_interval(const char **text, uint16_t *min, uint16_t *max) {
+    int low, high;
+    if (!rule_parse_number(text, &low, RULE_LTL_CELLS_MAX) || strncmp(*text, "..", 2) != 0) {
+        return 0;
+    }
+    *text += 2;
+    if (!rule_parse_number(text, &high, RULE_LTL_CELLS_MAX) || high < low) {
+        return 0;
+    }
+    *min = low;
+    *max = high;
+    return 1;
+}
+
+/** \brief Beolvas egy Larger than Life szabalyt ("R5,C0,M1,S34..58,B34..45,NM")
+ *
+ * Csak a Moore-kornyezetet (NM) ismeri; a C0 es C2 ketallapotu, a nagyobb C Generations jellegu szabaly.
+ *
+ * \param text const char* a szoveg
+ * \param rule Rule* ide kerul a beolvasott szabaly
+ * \return const char* a szabaly utani pozicio (NULL hiba eseten)
+ *
+ */
+static const char *rule_parse_ltl(const char *text, Rule *rule) {
+    Rule parsed = {0, 0, 0, 0, 0, {0}};
+    int has_survive = 0, has_birth = 0;
+    int value;
+    while (*text != '\0' && !isspace((unsigned char)*text)) {
+        switch (toupper((unsigned char)*text++)) {
+        case 'R':
+            if (!rule_parse_number(&text, &value, RULE_LTL_RANGE_MAX) || value < 1) {
+                return NULL;
+            }
+            parsed.ltl.range = value;
+            break;
+        case 'C':
+            if (!rule_parse_number(&text, &value, RULE_STATES_MAX)) {
+                return NULL;
+            }
+            parsed.dying = value > 2 ? value - 2 : 0;
+            break;
+        case 'M':
+            if (!rule_parse_number(&text, &value, 1)) {
+                return NULL;
+            }
+            parsed.ltl.middle = value;
+            break;
+        case 'S':
+            if (!rule_parse_interval(&text, &parsed.ltl.survive_min, &parsed.ltl.survive_max)) {
+                return NULL;
+            }
+            has_survive = 1;
+            break;
+        case 'B':
+            if (!rule_parse_interval(&text, &parsed.ltl.birth_min, &parsed.ltl.birth_max)) {
+                return NULL;
+            }
+            has_birth = 1;
+            break;
+        case 'N':
+            // Csak a Moore-kornyezet (negyzet) szamolhato dobozosszegekkel
+            if (toupper((unsigned char)*text++) != 'M') {
+                return NULL;
+            }
+            break;
+        case ',':
+            break;
+        default:
+            return NULL;
+        }
+    }
+    if (parsed.ltl.range == 0 || !has_survive || !has_birth) {
+        return NULL;
+    }
+    *rule = parsed;
+    return text;
+}
+
+int rule_parse(const char *text, Rule *rule) {
+    Rule parsed = {0, 0, 0, 0, 0, {0}};
+    int has_birth = 0, has_survive = 0, has_states = 0;
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+    if (toupper((unsigned char)*text) == 'R' && isdigit((unsigned char)text[1])) {
+        // Larger than Life
+        text = rule_parse_ltl(text, &parsed);
+        if (text == NULL) {
+            return 0;
+        }
+    } else if (isdigit((unsigned char)*text) || *text == '/') {
+        // Regi jeloles: tuleles/szuletes
+        if (!rule_parse_counts(&text, &parsed.survive, &parsed.survive_hensel) || *text != '/') {
+            return 0;
+        }
+        text++;
+        if (!rule_parse_counts(&text, &parsed.birth, &parsed.birth_hensel)) {
+            return 0;
+        }
+        // Generations: tuleles/szuletes/allapotok
+        if (*text == '/') {
+            text++;
+            if (!rule_parse_states(&text, &parsed.dying)) {
+                return 0;
+            }
+        }
+    } else {
+        // B.../S... vagy S.../B..., a ket resz kozott '/' allhat, Generations szabalynal utana /C...
+        while (*text != '\0' && !isspace((unsigned char)*text)) {
+            char c = toupper((unsigned char)*text++);
+            if (c == 'B' && !has_birth) {
+                if (!rule_parse_counts(&text, &parsed.birth, &parsed.birth_hensel)) {
+                    return 0;
+                }
+                has_birth = 1;
+            } else if (c == 'S' && !has_survive) {
+                if (!rule_parse_counts(&text, &parsed.survive, &parsed.survive_hensel)) {
+                    return 0;
+                }
+                has_survive = 1;
+            } else if (c == 'C' && !has_states) {
+                if (!rule_parse_states(&text, &parsed.dying)) {
+                    return 0;
+                }
+                has_states = 1;
+            } else if (c != '/') {
+                return 0;
+            }
+        }
+        if (!has_birth || !has_survive) {
+            return 0;
+        }
+    }
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+    if (*text != '\0') {
+        return 0;
+    }
+    *rule = parsed;
+    return 1;
+}
+
+/** \brief Kiir egy szomszedszam-felsorolast; a betuket a rovidebb (felsorolo vagy '-' utani) alakban
+ *
+ * \param text char* a szoveg helye
+ * \param counts uint16_t a teljes szomszedszamok
+ * \param hensel uint64_t az alakzatok
+ * \return char* a kiirt szoveg utani pozicio
+ *
+ */
+static char *rule_format_counts(char *text, uint16_t counts, uint64_t hensel) {
+    int n, i;
+    for (n=0; n<=8; n++) {
+        uint64_t letters = (hensel & rule_hensel_all(n)) >> rule_hensel_offset[n];
+        int count = 0;
+        int negate;
+        if (!(counts & (1 << n)) && letters == 0) {
+            continue;
+        }
+        *text++ = '0' + n;
+        if (counts & (1 << n)) {
+            continue;
+        }
+        for (i=0; i<rule_hensel_letters[n]; i++) {
+            count += (letters >> i) & 1;
+        }
+        negate = 1 + rule_hensel_letters[n] - count < count;
+        if (negate) {
+            *text++ = '-';
+        }
+        for (i=0; i<rule_hensel_letters[n]; i++) {
+            if ((int)((letters >> i) & 1) != negate) {
+                *text++ = rule_hensel_alphabet[i];
+            }
+        }
+    }
+    return text;
+}
+
+void rule_format(const Rule rule, char *text) {
+    if (rule.ltl.range > 0) {
+        sprintf(text, "R%d,C%d,M%d,S%d..%d,B%d..%d,NM", rule.ltl.range, rule.dying > 0 ? rule.dying + 2 : 0, rule.ltl.middle,
+                rule.ltl.survive_min, rule.ltl.survive_max, rule.ltl.birth_min, rule.ltl.birth_max);
+        return;
+    }
+    *text++ = 'B';
+    text = rule_format_counts(text, rule.birth, rule.birth_hensel);
+    *text++ = '/';
+    *text++ = 'S';
+    text = rule_format_counts(text, rule.survive, rule.survive_hensel);
+    if (rule.dying > 0) {
+        sprintf(text, "/C%d", rule.dying + 2);
+    } else {
+        *text = '\0';
+    }
+}
+
+int rule_equal(const Rule a, const Rule b) {
+    return a.birth == b.birth && a.survive == b.survive
+           && a.birth_hensel == b.birth_hensel && a.survive_hensel == b.survive_hensel && a.dying == b.dying
+           && a.ltl.range == b.ltl.range && a.ltl.middle == b.ltl.middle
+           && a.ltl.birth_min == b.ltl.birth_min && a.ltl.birth_max == b.ltl.birth_max
+           && a.ltl.survive_min == b.ltl.survive_min && a.ltl.survive_max == b.ltl.survive_max;
+}
+
+int rule_is_totalistic(const Rule rule) {
+    return rule.birth_hensel == 0 && rule.survive_hensel == 0;
+}
+
+void rule_table(const Rule rule, uint8_t *table) {
+    // A tabla indexenek bitjei az egyes szomszedok (0: E, 1: EK, ... 7: ENy) sorrendjeben
+    static const int neighbour_bits[8] = {3, 6, 7, 8, 5, 2, 1, 0};
+    int index, k;
+    rule_hensel_init();
+    for (index=0; index<RULE_TABLE_SIZE; index++) {
+        int state = (index >> 4) & 1;
+        unsigned neighbours = 0;
+        int count = 0;
+        for (k=0; k<8; k++) {
+            if ((index >> neighbour_bits[k]) & 1) {
+                neighbours |= 1 << k;
+                count++;
+            }
+        }
+        uint16_t counts = state ? rule.survive : rule.birth;
+        uint64_t hensel = state ? rule.survive_hensel : rule.birth_hensel;
+        int shape = rule_hensel_class[neighbours];
+        table[index] = ((counts >> count) & 1) || (shape >= 0 && ((hensel >> shape) & 1));
+    }
+}
+
+int rule_is_life(const Rule rule) {
+    return rule_equal(rule, rule_presets[0].rule);
+}
+
+int rule_preset_count(void) {
+    return sizeof(rule_presets) / sizeof(rule_presets[0]);
+}
+
+Rule rule_preset(int index) {
+    if (index < 0 || index >= rule_preset_count()) {
+        return rule_presets[0].rule;
+    }
+    return rule_presets[index].rule;
+}
+
+int rule_preset_index(const Rule rule) {
+    int i;
+    for (i=0; i<rule_preset_count(); i++) {
+        if (rule_equal(rule, rule_presets[i].rule)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const char *rule_name(const Rule rule) {
+    int index = rule_preset_index(rule);
+    return index < 0 ? NULL : rule_presets[index].name;
+}
+
+// Az aramkor forditasa: a fuggveny 32 soros igazsagtablaja egy 32 bites szo, a sor indexenek v. bitje
+// a v. bemenet (s0, s1, s2, s3, kozepso cella). A v. bemenet igazsagtablaja:
+static const uint32_t rule_var_rows[5] = {0xAAAAAAAAu, 0xCCCCCCCCu, 0xF0F0F0F0u, 0xFF00FF00u, 0xFFFF0000u};
+
+#define RULE_MEMO_SIZE 4096     /* A reszfuggvenyek tablajanak merete (2 hatvanya) */
+
+/** \brief A reszfuggveny legjobb felbontasanak fajtaja
+ */
+typedef enum t_rule_node_kind {
+    RULE_NODE_ZERO,     /**< Allando 0 */
+    RULE_NODE_ONE,      /**< Allando 1 */
+    RULE_NODE_VAR,      /**< x */
+    RULE_NODE_NOTVAR,   /**< ~x */
+    RULE_NODE_AND,      /**< x & f1 */
+    RULE_NODE_ANDNOT,   /**< ~x & f0 */
+    RULE_NODE_OR,       /**< x | f0 */
+    RULE_NODE_ORNOT,    /**< ~x | f1 */
+    RULE_NODE_XOR,      /**< x ^ f0 */
+    RULE_NODE_SKIP,     /**< f0 (a fuggveny nem fugg x-tol) */
+    RULE_NODE_MUX       /**< x ? f1 : f0 */
+} RuleNodeKind;
+
+/** \brief Egy reszfuggveny a forditas memoizalo tablajaban
+ */
+typedef struct t_rule_memo {
+    uint32_t f;         /**< A fuggveny igazsagtablaja (a care-en kivul nulla) */
+    uint32_t care;      /**< A lehetseges (nem szabadon kezelheto) sorok */
+    int cost;           /**< A legjobb felbontas kapuinak szama */
+    int kind;           /**< A legjobb felbontas fajtaja (RuleNodeKind) */
+    int var;            /**< A felbontas valtozoja */
+    int used;           /**< 1, ha a bejegyzes foglalt */
+} RuleMemo;
+
+/** \brief A fordito allapota
+ */
+typedef struct t_rule_compiler {
+    RuleMemo memo[RULE_MEMO_SIZE];  /**< A mar felbontott reszfuggvenyek */
+    int memo_count;                 /**< A foglalt bejegyzesek szama */
+    RuleCircuit *circuit;           /**< A keszulo aramkor */
+    int overflow;                   /**< 1, ha az aramkor nem fert el */
+} RuleCompiler;
+
+static RuleCompiler rule_compiler;
+
+/** \brief Visszaadja az igazsagtablat a v. valtozo rogzitett ertekenel (a masik felre is atmasolva)
+ *
+ * \param t uint32_t az igazsagtabla
+ * \param v int a valtozo
+ * \param value int a valtozo erteke
+ * \return uint32_t a v-tol fuggetlen igazsagtabla
+ *
+ */
+static uint32_t rule_cofactor(uint32_t t, int v, int value) {
+    const uint32_t rows = rule_var_rows[v];
+    const int shift = 1 << v;
+    if (value) {
+        t &= rows;
+        return t | (t >> shift);
+    }
+    t &= ~rows;
+    return t | (t << shift);
+}
+
+/** \brief A reszfuggvenyek tablajanak hash fuggvenye
+ *
+ * \param f uint32_t a fuggveny igazsagtablaja
+ * \param care uint32_t a lehetseges sorok
+ * \return uint32_t a kezdo hely a tablaban
+ *
+ */
+static uint32_t rule_memo_hash(uint32_t f, uint32_t care) {
+    return ((f * 0x9E3779B1u) ^ (care * 0x85EBCA77u)) & (RULE_MEMO_SIZE - 1);
+}
+
+/** \brief Kiertekel egy jeloltet, es ha olcsobb, megjegyzi
+ *
+ * \param best RuleMemo* az eddigi legjobb felbontas
+ * \param cost int a jelolt kapuinak szama
+ * \param kind int a jelolt fajtaja
+ * \param var int a jelolt valtozoja
+ * \return void
+ *
+ */
+static void rule_candidate(RuleMemo *best, int cost, int kind, int var) {
+    if (cost < best->cost) {
+        best->cost = cost;
+        best->kind = kind;
+        best->var = var;
+    }
+}
+
+/** \brief Megkeresi egy reszfuggveny legkevesebb kapubol allo felbontasat
+ *
+ * \param rc RuleCompiler* a fordito
+ * \param f uint32_t a fuggveny igazsagtablaja
+ * \param care uint32_t a lehetseges sorok
+ * \return RuleMemo* a felbontas (a fordito tablajaban vagy, ha az megtelt, egy atmeneti helyen)
+ *
+ */
+static RuleMemo *rule_solve(RuleCompiler *rc, uint32_t f, uint32_t care) {
+    static RuleMemo spill;
+    RuleMemo best;
+    uint32_t slot;
+    int v;
+    f &= care;
+    slot = rule_memo_hash(f, care);
+    while (rc->memo[slot].used) {
+        if (rc->memo[slot].f == f && rc->memo[slot].care == care) {
+            return &rc->memo[slot];
+        }
+        slot = (slot + 1) & (RULE_MEMO_SIZE - 1);
+    }
+
+    best.f = f;
+    best.care = care;
+    best.cost = INT_MAX;
+    best.kind = RULE_NODE_ZERO;
+    best.var = 0;
+    best.used = 1;
+    if (f == 0) {
+        best.cost = 0;
+    } else if (f == care) {
+        best.cost = 0;
+        best.kind = RULE_NODE_ONE;
+    }
+    for (v=0; v<5 && best.cost > 0; v++) {
+        if (f == (rule_var_rows[v] & care)) {
+            rule_candidate(&best, 0, RULE_NODE_VAR, v);
+        } else if (f == (~rule_var_rows[v] & care)) {
+            rule_candidate(&best, 1, RULE_NODE_NOTVAR, v);
+        }
+    }
+    for (v=0; v<5 && best.cost > 1; v++) {
+        uint32_t c0 = rule_cofactor(care, v, 0), c1 = rule_cofactor(care, v, 1);
+        uint32_t f0 = rule_cofactor(f, v, 0) & c0, f1 = rule_cofactor(f, v, 1) & c1;
+        uint32_t joint = c0 & c1;
+        if (f0 == f1 && c0 == c1) {
+            // A fuggveny mar nem fugg ettol a valtozotol
+            continue;
+        }
+        if (((f0 ^ f1) & joint) == 0) {
+            // Ahol mindket fel szamit, ott egyenloek: a valtozo elhagyhato
+            rule_candidate(&best, rule_solve(rc, f0 | f1, c0 | c1)->cost, RULE_NODE_SKIP, v);
+            continue;
+        }
+        if (f0 == 0) {
+            rule_candidate(&best, 1 + rule_solve(rc, f1, c1)->cost, RULE_NODE_AND, v);
+        }
+        if (f1 == 0) {
+            rule_candidate(&best, 1 + rule_solve(rc, f0, c0)->cost, RULE_NODE_ANDNOT, v);
+        }
+        if (f1 == c1) {
+            rule_candidate(&best, 1 + rule_solve(rc, f0, c0)->cost, RULE_NODE_OR, v);
+        }
+        if (f0 == c0) {
+            rule_candidate(&best, 2 + rule_solve(rc, f1, c1)->cost, RULE_NODE_ORNOT, v);
+        }
+        if (((f0 ^ ~f1) & joint) == 0) {
+            rule_candidate(&best, 1 + rule_solve(rc, f0 | (~f1 & c1 & ~c0), c0 | c1)->cost, RULE_NODE_XOR, v);
+        }
+        rule_candidate(&best, 3 + rule_solve(rc, f0, c0)->cost + rule_solve(rc, f1, c1)->cost, RULE_NODE_MUX, v);
+    }
+
+    // A rekurzio kozben a tabla valtozott, ezert a helyet ujra meg kell keresni
+    if (rc->memo_count >= RULE_MEMO_SIZE - 1) {
+        spill = best;
+        return &spill;
+    }
+    slot = rule_memo_hash(f, care);
+    while (rc->memo[slot].used) {
+        slot = (slot + 1) & (RULE_MEMO_SIZE - 1);
+    }
+    rc->memo[slot] = best;
+    rc->memo_count++;
+    return &rc->memo[slot];
+}
+
+/** \brief Hozzaad egy kaput az aramkorhoz (a mar meglevo azonos kaput ujrahasznalja)
+ *
+ * \param rc RuleCompiler* a fordito
+ * \param op RuleGateOp a muvelet
+ * \param a int az elso operandus
+ * \param b int a masodik operandus
+ * \return int a kapu eredmenyenek sorszama
+ *
+ */
+static int rule_gate(RuleCompiler *rc, RuleGateOp op, int a, int b) {
+    RuleCircuit *circuit = rc->circuit;
+    int i;
+    for (i=0; i<circuit->gate_count; i++) {
+        const RuleGate *gate = &circuit->gates[i];
+        if (gate->op == op && ((gate->a == a && gate->b == b) || (op != RULE_GATE_ANDNOT && gate->a == b && gate->b == a))) {
+            return RULE_CIRCUIT_INPUTS + i;
+        }
+    }
+    if (circuit->gate_count == RULE_CIRCUIT_MAX_GATES) {
+        rc->overflow = 1;
+        return 5;
+    }
+    circuit->gates[circuit->gate_count].op = op;
+    circuit->gates[circuit->gate_count].a = a;
+    circuit->gates[circuit->gate_count].b = b;
+    return RULE_CIRCUIT_INPUTS + circuit->gate_count++;
+}
+
+/** \brief Felepiti a reszfuggveny kapuit a legjobb felbontas szerint
+ *
+ * \param rc RuleCompiler* a fordito
+ * \param f uint32_t a fuggveny igazsagtablaja
+ * \param care uint32_t a lehetseges sorok
+ * \return int a fuggveny erteket ado bemenet vagy kapu sorszama
+ *
+ */
+static int rule_emit(RuleCompiler *rc, uint32_t f, uint32_t care) {
+    const RuleMemo *node = rule_solve(rc, f, care);
+    const int kind = node->kind;
+    const int v = node->var;
+    uint32_t c0, c1, f0, f1;
+    int high, low;
+    f &= care;
+    c0 = rule_cofactor(care, v, 0);
+    c1 = rule_cofactor(care, v, 1);
+    f0 = rule_cofactor(f, v, 0) & c0;
+    f1 = rule_cofactor(f, v, 1) & c1;
+    switch (kind) {
+    case RULE_NODE_ONE:
+        return 6;
+    case RULE_NODE_VAR:
+        return v;
+    case RULE_NODE_NOTVAR:
+        return rule_gate(rc, RULE_GATE_ANDNOT, v, 6);
+    case RULE_NODE_AND:
+        return rule_gate(rc, RULE_GATE_AND, v, rule_emit(rc, f1, c1));
+    case RULE_NODE_ANDNOT:
+        return rule_gate(rc, RULE_GATE_ANDNOT, v, rule_emit(rc, f0, c0));
+    case RULE_NODE_OR:
+        return rule_gate(rc, RULE_GATE_OR, v, rule_emit(rc, f0, c0));
+    case RULE_NODE_ORNOT:
+        // ~x | f1 = ~(x & ~f1)
+        return rule_gate(rc, RULE_GATE_ANDNOT, rule_gate(rc, RULE_GATE_ANDNOT, rule_emit(rc, f1, c1), v), 6);
+    case RULE_NODE_XOR:
+        return rule_gate(rc, RULE_GATE_XOR, v, rule_emit(rc, f0 | (~f1 & c1 & ~c0), c0 | c1));
+    case RULE_NODE_SKIP:
+        return rule_emit(rc, f0 | f1, c0 | c1);
+    case RULE_NODE_MUX:
+        high = rule_emit(rc, f1, c1);
+        low = rule_emit(rc, f0, c0);
+        return rule_gate(rc, RULE_GATE_OR, rule_gate(rc, RULE_GATE_AND, v, high), rule_gate(rc, RULE_GATE_ANDNOT, v, low));
+    default:
+        return 5;
+    }
+}
+
+int rule_compile(const Rule rule, RuleCircuit *circuit) {
+    RuleCompiler *rc = &rule_compiler;
+    uint32_t f = 0, care = 0;
+    int row;
+    if (!rule_is_totalistic(rule) || rule.ltl.range > 0) {
+        // Az alakzatfuggo es a nagy kornyezetu szabalyok nem irhatok fel a 3x3-as kornyezet osszegebol
+        circuit->gate_count = 0;
+        circuit->output = 5;
+        return 0;
+    }
+    // Az igazsagtabla: a sor also negy bitje a kilenc cella osszege, a felso a kozepso cella
+    for (row=0; row<32; row++) {
+        int sum = row & 15;
+        int center = row >> 4;
+        if (sum > 9 || (center && sum == 0) || (!center && sum == 9)) {
+            // Lehetetlen sor, az erteke szabadon valaszthato
+            continue;
+        }
+        care |= (uint32_t)1 << row;
+        if (center ? (rule.survive >> (sum - 1)) & 1 : (rule.birth >> sum) & 1) {
+            f |= (uint32_t)1 << row;
+        }
+    }
+
+    memset(rc->memo, 0, sizeof(rc->memo));
+    rc->memo_count = 0;
+    rc->overflow = 0;
+    rc->circuit = circuit;
+    circuit->gate_count = 0;
+    circuit->output = rule_emit(rc, f, care);
+    return !rc->overflow;
+}
@@ -0,0 +1,126 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_rule.h
+ * Description:     A B/S szabalyok beolvasasa, kiirasa es forditasa
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#ifndef __GOL_RULE_H_INCLUDED__
+#define __GOL_RULE_H_INCLUDED__
+
+#define RULE_TEXT_LENGTH 80     /**< A szabaly szoveges alakjanak maximalis hossza (lezaro nullaval) */
+#define RULE_TABLE_SIZE 512     /**< A 3x3-as kornyezetek szama */
+#define RULE_STATES_MAX 256     /**< A Generations szabalyok allapotainak maximalis szama */
+#define RULE_LTL_RANGE_MAX 10   /**< A Larger than Life kornyezet legnagyobb sugara */
+#define RULE_LTL_CELLS_MAX ((2*RULE_LTL_RANGE_MAX+1)*(2*RULE_LTL_RANGE_MAX+1))   /**< A legnagyobb kornyezet cellainak szama */
+
+/** \brief Beolvas egy szabalyt
+ *
+ * Elfogadja a "B36/S23" alakot (kis- es nagybetuvel, barmelyik sorrendben),
+ * a Hensel-fele izotrop, nem totalisztikus "B2-a/S12" alakot, a regi "23/36" (tuleles/szuletes)
+ * alakot, a Generations szabalyok "B2/S345/C4" es "345/2/4" alakjat, valamint
+ * a Larger than Life szabalyok "R5,C0,M1,S34..58,B34..45,NM" alakjat.
+ *
+ * \param text const char* a szabaly szovege
+ * \param rule Rule* ide kerul a beolvasott szabaly
+ * \return int 1, ha sikerult; 0 hibas szoveg eseten (ekkor a rule valtozatlan)
+ *
+ */
+int rule_parse(const char *text, Rule *rule);
+
+/** \brief Kiirja a szabalyt "B36/S23" alakban
+ *
+ * A Hensel-jelolesu szabaly "B2-a/S12", a Generations szabaly "B2/S345/C4",
+ * a Larger than Life szabaly "R5,C0,M1,S34..58,B34..45,NM" alakot kap.
+ *
+ * \param rule const Rule a szabaly
+ * \param text char* legalabb RULE_TEXT_LENGTH hosszu puffer
+ * \return void
+ *
+ */
+void rule_format(const Rule rule, char *text);
+
+/** \brief Osszehasonlit ket szabalyt
+ *
+ * \param a const Rule az egyik szabaly
+ * \param b const Rule a masik szabaly
+ * \return int 1, ha megegyeznek
+ *
+ */
+int rule_equal(const Rule a, const Rule b);
+
+/** \brief Visszaadja, hogy a szabaly Conway eredeti eletjateka (B3/S23)-e
+ *
+ * \param rule const Rule a szabaly
+ * \return int 1, ha a szabaly B3/S23
+ *
+ */
+int rule_is_life(const Rule rule);
+
+/** \brief Visszaadja, hogy a szabaly csak az elo szomszedok szamatol fugg-e
+ *
+ * \param rule const Rule a szabaly
+ * \return int 1, ha a szabalyban nincs Hensel-betu
+ *
+ */
+int rule_is_totalistic(const Rule rule);
+
+/** \brief Feltolti a szabaly 3x3-as kornyezetenkenti tablajat
+ *
+ * Az index 3*(dx+1) + (dy+1). bitje a cella (dx, dy) szomszedja (a 4. bit maga a cella),
+ * igy a bal, kozepso es jobb oszlop rendre a 0..2., 3..5. es 6..8. bit: egy cellaval jobbra
+ * lepve az index harommal jobbra tolodik, es csak az uj oszlopot kell beolvasni.
+ *
+ * \param rule const Rule a szabaly
+ * \param table uint8_t* RULE_TABLE_SIZE elemu tabla, ide kerul a kovetkezo allapot
+ * \return void
+ *
+ */
+void rule_table(const Rule rule, uint8_t *table);
+
+/** \brief Visszaadja az elore megadott szabalyok szamat
+ *
+ * \return int a szabalyok szama
+ *
+ */
+int rule_preset_count(void);
+
+/** \brief Visszaadja az index. elore megadott szabalyt (a 0. az eletjatek)
+ *
+ * \param index int a szabaly sorszama (0..rule_preset_count()-1)
+ * \return Rule a szabaly
+ *
+ */
+Rule rule_preset(int index);
+
+/** \brief Megkeresi a szabalyt az elore megadottak kozott
+ *
+ * \param rule const Rule a szabaly
+ * \return int a szabaly sorszama (-1, ha nincs a listaban)
+ *
+ */
+int rule_preset_index(const Rule rule);
+
+/** \brief Visszaadja az elore megadott szabaly kozismert nevet
+ *
+ * \param rule const Rule a szabaly
+ * \return const char* a szabaly neve (NULL, ha nincs a listaban)
+ *
+ */
+const char *rule_name(const Rule rule);
+
+/** \brief Logikai aramkorre forditja a szabalyt a bitszeletelt kernelek szamara
+ *
+ * A kovetkezo allapot a kilenc cella osszegenek negy bitjebol es a kozepso cellabol szamolhato.
+ * Ennek az ot valtozos fuggvenynek (a lehetetlen osszegeket szabadon kezelve) a fordito
+ * Shannon-felbontassal keresi meg a legkevesebb kapubol allo valtozatat, a kozos reszeket egyszer szamolva.
+ *
+ * \param rule const Rule a szabaly
+ * \param circuit RuleCircuit* ide kerul az aramkor
+ * \return int 1, ha sikerult; 0, ha a szabaly nem totalisztikus vagy az aramkor nem fert el RULE_CIRCUIT_MAX_GATES kapuban
+ *
+ */
+int rule_compile(const Rule rule, RuleCircuit *circuit);
+
+#endif // __GOL_RULE_H_INCLUDED__
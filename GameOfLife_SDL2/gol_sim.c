@@ -0,0 +1,326 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_sim.c
+ * Description:     A futo szimulaciot kulon szalon lepteto szimulacios szal
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#include <stdlib.h>
+#include <string.h>
+#include "gol_main.h"
+#include "gol_grid.h"
+#include "gol_cycle.h"
+#include "gol_sim.h"
+
+#define SIM_SNAPSHOTS 3             /**< A pillanatkepek szama (harmas pufferezes) */
+#define SIM_EDIT_QUEUE 4096         /**< A szerkesztesek soranak hossza */
+
+static const int SIM_INDEX_MASK = 3;    /**< A kozzetett pillanatkep sorszama a middle also bitjein */
+static const int SIM_FRESH = 4;         /**< A kozzetett pillanatkepet a fo szal meg nem vette at */
+
+/** \brief Egy cella szerkesztese, amit a szimulacios szal a kovetkezo leptetes elott alkalmaz
+ */
+typedef struct t_sim_edit {
+    int x;              /**< A cella x koordinataja */
+    int y;              /**< A cella y koordinataja */
+    CellState state;    /**< A cella uj allapota */
+} SimEdit;
+
+struct t_sim {
+    SimSnapshot snapshots[SIM_SNAPSHOTS];   /**< A pillanatkepek */
+    SDL_atomic_t middle;            /**< A legutobb kozzetett pillanatkep sorszama (es a SIM_FRESH jelzo) */
+    int back;                       /**< A szal altal irt pillanatkep sorszama */
+    int front;                      /**< A fo szal altal rajzolt pillanatkep sorszama */
+    uint32_t version;               /**< Az utolso kozzetetel sorszama */
+    uint32_t *tile_version;         /**< Az elo grid csempeinek utolso valtozasa (kozzetetelek sorszamaval) */
+    uint8_t *tile_copy;             /**< Az eppen irt pillanatkepbe masolando csempek (munkaterulet) */
+    size_t tile_count;              /**< A csempetombok merete */
+    int layout_stride;              /**< Az elo grid sorhossza az utolso kozzetetelkor */
+    int layout_cap_y;               /**< Az elo grid magassagi kapacitasa az utolso kozzetetelkor */
+    SimEdit edits[SIM_EDIT_QUEUE];  /**< A szerkesztesek gyuru puffere */
+    SDL_atomic_t edit_head;         /**< A kovetkezo szerkesztes helye (a fo szal irja) */
+    SDL_atomic_t edit_tail;         /**< A kovetkezo feldolgozando szerkesztes (a szal irja) */
+    SDL_atomic_t quit;              /**< A szal leallitasa */
+    SDL_atomic_t cycle_found;       /**< A szal a ciklusfigyelo kerese miatt megallt */
+    SDL_Thread *thread;             /**< Az SDL szal (NULL, ha nem fut) */
+    GameVars *game_vars;            /**< A leptetett jatek fo valtozoja */
+};
+
+/** \brief Alkalmazza a sorban varakozo szerkeszteseket az elo gridre
+ *
+ * \param sim Sim* a szimulacios szalra mutato pointer
+ * \return void
+ *
+ */
+static void sim_apply_edits(Sim *sim) {
+    const int head = SDL_AtomicGet(&sim->edit_head);
+    int tail = SDL_AtomicGet(&sim->edit_tail);
+    if (tail == head) {
+        return;
+    }
+    for (; tail != head; tail = (tail + 1) % SIM_EDIT_QUEUE) {
+        const SimEdit *edit = &sim->edits[tail];
+        if (edit->state == alive) {
+            grid_set_alive(sim->game_vars->grid, edit->x, edit->y);
+        } else {
+            grid_set_dead(sim->game_vars->grid, edit->x, edit->y);
+        }
+    }
+    SDL_AtomicSet(&sim->edit_tail, tail);
+    cycle_reset(&sim->game_vars->cycle);
+}
+
+/** \brief Az elo grid elrendezesenek valtozasakor ujrafoglalja a csempetombokat, es minden pillanatkepet ervenytelenit
+ *
+ * \param sim Sim* a szimulacios szalra mutato pointer
+ * \param grid const Grid* az elo grid
+ * \return int 1, ha sikerult; 0 hiba eseten
+ *
+ */
+static int sim_layout(Sim *sim, const Grid *grid) {
+    const size_t tiles = (size_t)grid->tile_stride*((grid->cap_y + GRID_TILE_ROWS - 1) / GRID_TILE_ROWS);
+    int i;
+    if (grid->stride == sim->layout_stride && grid->cap_y == sim->layout_cap_y) {
+        return 1;
+    }
+    if (tiles > sim->tile_count) {
+        uint32_t *tile_version = realloc(sim->tile_version, sizeof(uint32_t)*tiles);
+        uint8_t *tile_copy;
+        if (tile_version == NULL) {
+#ifdef NDEBUG
+            fprintf(stderr, "Malloc hiba a pillanatkep kozzetetelenel.\n");
+#endif // NDEBUG
+            return 0;
+        }
+        sim->tile_version = tile_version;
+        tile_copy = realloc(sim->tile_copy, tiles);
+        if (tile_copy == NULL) {
+#ifdef NDEBUG
+            fprintf(stderr, "Malloc hiba a pillanatkep kozzetetelenel.\n");
+#endif // NDEBUG
+            return 0;
+        }
+        sim->tile_copy = tile_copy;
+        sim->tile_count = tiles;
+    }
+    // A csempek sorszama megvaltozott: a pillanatkepek a kovetkezo kozzeteteltol teljes masolatot kapnak
+    memset(sim->tile_version, 0, sizeof(uint32_t)*tiles);
+    for (i=0; i<SIM_SNAPSHOTS; i++) {
+        sim->snapshots[i].version = 0;
+    }
+    sim->layout_stride = grid->stride;
+    sim->layout_cap_y = grid->cap_y;
+    return 1;
+}
+
+/** \brief Kozzeteszi az elo grid allapotat a szal pillanatkepeben, majd kicsereli a legutobb kozzetettel
+ *
+ * A pillanatkepbe csak a legutobbi tartalma ota valtozott csempek masolodnak at; hogy melyek ezek,
+ * azt az elo grid valtozasjelzoibol (tile_dirty) vezetett csempenkenti kozzeteteli sorszam adja meg.
+ *
+ * \param sim Sim* a szimulacios szalra mutato pointer
+ * \return int 1, ha sikerult; 0 hiba eseten (ekkor a korabbi pillanatkep marad)
+ *
+ */
+static int sim_publish(Sim *sim) {
+    GameVars *game_vars = sim->game_vars;
+    Grid *grid = game_vars->grid;
+    SimSnapshot *snapshot = &sim->snapshots[sim->back];
+    size_t tiles, i;
+    if (!sim_layout(sim, grid)) {
+        return 0;
+    }
+    tiles = (size_t)grid->tile_stride*((grid->cap_y + GRID_TILE_ROWS - 1) / GRID_TILE_ROWS);
+    sim->version++;
+    for (i=0; i<tiles; i++) {
+        if (grid->tile_dirty[i]) {
+            grid->tile_dirty[i] = 0;
+            sim->tile_version[i] = sim->version;
+        }
+        sim->tile_copy[i] = sim->tile_version[i] > snapshot->version;
+    }
+    if (!grid_copy_tiles(snapshot->grid, grid, snapshot->version == 0 ? NULL : sim->tile_copy)) {
+        snapshot->version = 0;
+        return 0;
+    }
+    snapshot->version = sim->version;
+    snapshot->generation = game_vars->generation;
+    snapshot->cycle_period = game_vars->cycle.period;
+    sim->back = SDL_AtomicSet(&sim->middle, sim->back | SIM_FRESH) & SIM_INDEX_MASK;
+    return 1;
+}
+
+/** \brief A szimulacios szal fuggvenye: amig le nem allitjak, lepteti a gridet, es a fo szal kereseire kozzeteszi
+ *
+ * Uj pillanatkep csak akkor keszul, ha a fo szal az elozot mar atvette, igy a masolas a kepfrissiteshez igazodik.
+ *
+ * \param data void* a szimulacios szalra mutato pointer
+ * \return int a szal visszateresi erteke
+ *
+ */
+static int SDLCALL sim_thread(void *data) {
+    Sim *sim = data;
+    GameVars *game_vars = sim->game_vars;
+    while (!SDL_AtomicGet(&sim->quit)) {
+        sim_apply_edits(sim);
+        if (Game_Step(game_vars, 1 << game_vars->settings.speed_log2) && game_vars->settings.cycle_action == CYCLE_PAUSE) {
+            SDL_AtomicSet(&sim->cycle_found, 1);
+            break;
+        }
+        if (!(SDL_AtomicGet(&sim->middle) & SIM_FRESH)) {
+            sim_publish(sim);
+        }
+        if (game_vars->step_stats.computed == 0) {
+            // A grid elaludt (vagy csak a periodus szamlaloja lep): nem porgetjuk feleslegesen a processzort
+            SDL_Delay(1);
+        }
+    }
+    return 0;
+}
+
+Sim *sim_new(void) {
+    Sim *sim = malloc(sizeof(Sim));
+    int i;
+    if (sim == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a szimulacios szal letrehozasanal.\n");
+#endif // NDEBUG
+        return NULL;
+    }
+    sim->back = 0;
+    sim->front = 1;
+    SDL_AtomicSet(&sim->middle, 2);
+    sim->version = 0;
+    sim->tile_version = NULL;
+    sim->tile_copy = NULL;
+    sim->tile_count = 0;
+    sim->layout_stride = 0;
+    sim->layout_cap_y = 0;
+    SDL_AtomicSet(&sim->edit_head, 0);
+    SDL_AtomicSet(&sim->edit_tail, 0);
+    SDL_AtomicSet(&sim->quit, 0);
+    SDL_AtomicSet(&sim->cycle_found, 0);
+    sim->thread = NULL;
+    sim->game_vars = NULL;
+    for (i=0; i<SIM_SNAPSHOTS; i++) {
+        sim->snapshots[i].grid = NULL;
+    }
+    for (i=0; i<SIM_SNAPSHOTS; i++) {
+        sim->snapshots[i].version = 0;
+        sim->snapshots[i].generation = 0;
+        sim->snapshots[i].cycle_period = 0;
+        sim->snapshots[i].grid = grid_new(0, 0);
+        if (sim->snapshots[i].grid == NULL) {
+            sim_free(sim);
+            return NULL;
+        }
+    }
+    return sim;
+}
+
+void sim_free(Sim *sim) {
+    int i;
+    if (sim == NULL) {
+        return;
+    }
+    sim_stop(sim);
+    for (i=0; i<SIM_SNAPSHOTS; i++) {
+        if (sim->snapshots[i].grid != NULL) {
+            grid_free(sim->snapshots[i].grid);
+        }
+    }
+    free(sim->tile_version);
+    free(sim->tile_copy);
+    free(sim);
+}
+
+int sim_start(Sim *sim, GameVars *game_vars) {
+    int i;
+    if (sim == NULL || game_vars->grid == NULL) {
+        return 0;
+    }
+    if (sim->thread != NULL) {
+        return 1;
+    }
+    // A szal allasa kozben a gridet a fo szal szabadon irta: minden pillanatkep teljes masolatot kap
+    sim->game_vars = game_vars;
+    for (i=0; i<SIM_SNAPSHOTS; i++) {
+        sim->snapshots[i].version = 0;
+    }
+    SDL_AtomicSet(&sim->middle, SDL_AtomicGet(&sim->middle) & SIM_INDEX_MASK);
+    SDL_AtomicSet(&sim->quit, 0);
+    SDL_AtomicSet(&sim->cycle_found, 0);
+    if (!sim_publish(sim)) {
+        return 0;
+    }
+    sim_acquire(sim);
+    sim->thread = SDL_CreateThread(sim_thread, "gol_sim", sim);
+    if (sim->thread == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "SDL hiba a szimulacios szal inditasanal: %s\n", SDL_GetError());
+#endif // NDEBUG
+        return 0;
+    }
+    return 1;
+}
+
+void sim_stop(Sim *sim) {
+    if (sim == NULL || sim->thread == NULL) {
+        return;
+    }
+    SDL_AtomicSet(&sim->quit, 1);
+    SDL_WaitThread(sim->thread, NULL);
+    sim->thread = NULL;
+    // A szal leallasa utan erkezett (vagy meg fel nem dolgozott) szerkesztesek sem vesznek el
+    sim_apply_edits(sim);
+}
+
+int sim_running(const Sim *sim) {
+    return sim != NULL && sim->thread != NULL;
+}
+
+int sim_cycle_found(Sim *sim) {
+    return sim != NULL && SDL_AtomicGet(&sim->cycle_found);
+}
+
+SimSnapshot *sim_acquire(Sim *sim) {
+    if (sim == NULL) {
+        return NULL;
+    }
+    if (SDL_AtomicGet(&sim->middle) & SIM_FRESH) {
+        sim->front = SDL_AtomicSet(&sim->middle, sim->front) & SIM_INDEX_MASK;
+    }
+    return sim_snapshot(sim);
+}
+
+SimSnapshot *sim_snapshot(Sim *sim) {
+    if (!sim_running(sim)) {
+        return NULL;
+    }
+    return &sim->snapshots[sim->front];
+}
+
+Grid *sim_view_grid(GameVars *game_vars) {
+    SimSnapshot *snapshot = sim_snapshot(game_vars->sim);
+    return snapshot != NULL ? snapshot->grid : game_vars->grid;
+}
+
+void sim_edit(Sim *sim, int x, int y, CellState state) {
+    const int head = SDL_AtomicGet(&sim->edit_head);
+    const int next = (head + 1) % SIM_EDIT_QUEUE;
+    while (next == SDL_AtomicGet(&sim->edit_tail)) {
+        // Tele sor: megvarjuk, amig a szal a kovetkezo leptetes elott kiuriti (a magatol megallt szal mar nem uriti)
+        if (SDL_AtomicGet(&sim->cycle_found)) {
+#ifdef NDEBUG
+            fprintf(stderr, "Figyelmeztetes (sim_edit): a szerkesztesek sora megtelt!\n");
+#endif // NDEBUG
+            return;
+        }
+        SDL_Delay(1);
+    }
+    sim->edits[head].x = x;
+    sim->edits[head].y = y;
+    sim->edits[head].state = state;
+    SDL_AtomicSet(&sim->edit_head, next);
+}
@@ -0,0 +1,103 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_sim.h
+ * Description:     A futo szimulaciot kulon szalon lepteto szimulacios szal
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#ifndef __GOL_SIM_H_INCLUDED__
+#define __GOL_SIM_H_INCLUDED__
+
+/** \brief Letrehoz egy uj, allo szimulacios szalat (a pillanatkepek gridjeivel egyutt)
+ *
+ * \return Sim* a szimulacios szalra mutato pointer (Hiba eseten NULL)
+ *
+ */
+Sim *sim_new(void);
+
+/** \brief Leallitja a szalat (ha fut) es felszabaditja
+ *
+ * \param sim Sim* a szimulacios szalra mutato pointer (NULL eseten nem tesz semmit)
+ * \return void
+ *
+ */
+void sim_free(Sim *sim);
+
+/** \brief Elinditja a grid szimulaciojat a szimulacios szalon
+ *
+ * Indulas elott kozzetesz es at is vesz egy pillanatkepet, igy a fo szal azonnal rajzolhat.
+ * Amig a szal fut, a gridet, a generacioszamlalot es a ciklusfigyelot csak a szal irja:
+ * a fo szal a pillanatkepeket rajzolja, a szerkesztest a sim_edit adja at.
+ *
+ * \param sim Sim* a szimulacios szalra mutato pointer (NULL eseten 0)
+ * \param game_vars GameVars* a jatek fo valtozoja (a szimulacio a gridjet lepteti)
+ * \return int 1, ha a szal elindult; 0 hiba eseten (ekkor a szimulacio a fo szalon leptetheto)
+ *
+ */
+int sim_start(Sim *sim, GameVars *game_vars);
+
+/** \brief Leallitja a szimulacios szalat, megvarja, es a fo szalon alkalmazza a meg fel nem dolgozott szerkeszteseket
+ *
+ * \param sim Sim* a szimulacios szalra mutato pointer (NULL eseten nem tesz semmit)
+ * \return void
+ *
+ */
+void sim_stop(Sim *sim);
+
+/** \brief Visszaadja, hogy fut-e (es meg nem allt le sim_stop-pal) a szimulacios szal
+ *
+ * \param sim const Sim* a szimulacios szalra mutato pointer (NULL eseten 0)
+ * \return int 1, ha a szal fut
+ *
+ */
+int sim_running(const Sim *sim);
+
+/** \brief Visszaadja, hogy a szal azert allt-e meg, mert a ciklusfigyelo a megallast kerte
+ *
+ * \param sim Sim* a szimulacios szalra mutato pointer (NULL eseten 0)
+ * \return int 1, ha a szal magatol megallt (ekkor is sim_stop-pal kell leallitani)
+ *
+ */
+int sim_cycle_found(Sim *sim);
+
+/** \brief Atveszi a legutobb kozzetett pillanatkepet (ha van ujabb a rajzolt peldanynal)
+ *
+ * Kepkockankent egyszer hivando, a kepkocka minden resze ugyanazt a pillanatkepet latja.
+ *
+ * \param sim Sim* a szimulacios szalra mutato pointer
+ * \return SimSnapshot* az atvett pillanatkep (NULL, ha a szal nem fut)
+ *
+ */
+SimSnapshot *sim_acquire(Sim *sim);
+
+/** \brief Visszaadja az utoljara atvett pillanatkepet
+ *
+ * \param sim Sim* a szimulacios szalra mutato pointer (NULL eseten NULL)
+ * \return SimSnapshot* a pillanatkep (NULL, ha a szal nem fut)
+ *
+ */
+SimSnapshot *sim_snapshot(Sim *sim);
+
+/** \brief Visszaadja a megjelenitendo gridet: futo szal eseten a pillanatkepet, kulonben az elo gridet
+ *
+ * \param game_vars GameVars* a jatek fo valtozoja
+ * \return Grid* a gridre mutato pointer
+ *
+ */
+Grid *sim_view_grid(GameVars *game_vars);
+
+/** \brief Atadja a szalnak egy cella szerkeszteset (a kovetkezo leptetes elott alkalmazza, es torli a ciklusfigyelo elozmenyeit)
+ *
+ * Tele sor eseten megvarja, amig a szal helyet csinal; ha a szal a ciklusfigyelo miatt mar megallt, a szerkesztes elveszik.
+ *
+ * \param sim Sim* a szimulacios szalra mutato pointer
+ * \param x int a cella x koordinataja
+ * \param y int a cella y koordinataja
+ * \param state CellState a cella uj allapota (alive vagy dead)
+ * \return void
+ *
+ */
+void sim_edit(Sim *sim, int x, int y, CellState state);
+
+#endif // __GOL_SIM_H_INCLUDED__
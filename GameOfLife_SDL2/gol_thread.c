@@ -0,0 +1,244 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_thread.c
+ * Description:     A tobbszalu lepteteshez hasznalt szalkeszlet
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#include <stdlib.h>
+#include "gol_main.h"
+#include "gol_thread.h"
+
+static const int THREAD_POOL_MAX = 64;
+
+/** \brief Egy szal feladattartomanya, a szalak kozti hamis megosztas ellen cache sornyira kiparnazva
+ */
+typedef struct t_thread_queue {
+    SDL_SpinLock lock;                  /**< A tartomanyt vedo zar */
+    int head;                           /**< A kovetkezo sajat feladat */
+    int tail;                           /**< A tartomany vege (innen lopnak a tobbiek) */
+    char padding[64-3*sizeof(int)];     /**< Kitoltes egy teljes cache sorra */
+} ThreadQueue;
+
+/** \brief Egy munkaszal adatai
+ */
+typedef struct t_thread_worker {
+    ThreadPool *pool;       /**< A szalkeszletre mutato pointer */
+    int index;              /**< A szal sorszama */
+    SDL_Thread *thread;     /**< Az SDL szal */
+} ThreadWorker;
+
+struct t_thread_pool {
+    int thread_count;               /**< A szalak szama a hivo szallal egyutt */
+    ThreadWorker *workers;          /**< A munkaszalak (thread_count-1 darab) */
+    ThreadQueue *queues;            /**< A szalak feladattartomanyai */
+    SDL_sem *work_sem;              /**< Uj feladat jelzese a munkaszalaknak */
+    SDL_sem *done_sem;              /**< A munkaszalak vegeztek */
+    SDL_atomic_t workers_done;      /**< A mar vegzett munkaszalak szama */
+    int quit;                       /**< A munkaszalak leallitasa */
+    ThreadTask task;                /**< Az aktualis feladat */
+    void *data;                     /**< Az aktualis feladat adata */
+};
+
+/** \brief Kivesz egy feladatot a szal sajat tartomanyanak elejerol
+ *
+ * \param queue ThreadQueue* a tartomany
+ * \return int a feladat sorszama (-1, ha a tartomany ures)
+ *
+ */
+static int thread_queue_pop(ThreadQueue *queue) {
+    int task = -1;
+    SDL_AtomicLock(&queue->lock);
+    if (queue->head < queue->tail) {
+        task = queue->head++;
+    }
+    SDL_AtomicUnlock(&queue->lock);
+    return task;
+}
+
+/** \brief Ellop egy masik szal hatralevo feladatainak felet
+ *
+ * \param pool ThreadPool* a szalkeszlet
+ * \param index int a lopo szal sorszama
+ * \return int 1, ha sikerult lopni; 0, ha minden tartomany ures
+ *
+ */
+static int thread_pool_steal(ThreadPool *pool, int index) {
+    int i;
+    for (i=1; i<pool->thread_count; i++) {
+        ThreadQueue *victim = &pool->queues[(index+i) % pool->thread_count];
+        int head = 0, tail = 0;
+        SDL_AtomicLock(&victim->lock);
+        if (victim->head < victim->tail) {
+            tail = victim->tail;
+            head = tail - (victim->tail - victim->head + 1)/2;
+            victim->tail = head;
+        }
+        SDL_AtomicUnlock(&victim->lock);
+        if (head < tail) {
+            ThreadQueue *own = &pool->queues[index];
+            SDL_AtomicLock(&own->lock);
+            own->head = head;
+            own->tail = tail;
+            SDL_AtomicUnlock(&own->lock);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/** \brief Vegrehajtja a szal feladatait, majd lop, amig van mit
+ *
+ * \param pool ThreadPool* a szalkeszlet
+ * \param index int a szal sorszama
+ * \return void
+ *
+ */
+static void thread_pool_work(ThreadPool *pool, int index) {
+    for (;;) {
+        int task = thread_queue_pop(&pool->queues[index]);
+        if (task < 0) {
+            if (!thread_pool_steal(pool, index)) {
+                return;
+            }
+            continue;
+        }
+        pool->task(pool->data, task, index);
+    }
+}
+
+/** \brief A munkaszalak fuggvenye
+ *
+ * \param data void* a szal adatai (ThreadWorker*)
+ * \return int a szal visszateresi erteke
+ *
+ */
+static int SDLCALL thread_worker(void *data) {
+    ThreadWorker *worker = data;
+    ThreadPool *pool = worker->pool;
+    for (;;) {
+        SDL_SemWait(pool->work_sem);
+        if (pool->quit) {
+            break;
+        }
+        thread_pool_work(pool, worker->index);
+        if (SDL_AtomicAdd(&pool->workers_done, 1) + 1 == pool->thread_count - 1) {
+            SDL_SemPost(pool->done_sem);
+        }
+    }
+    return 0;
+}
+
+ThreadPool *thread_pool_new(int thread_count) {
+    if (thread_count <= 0) {
+        thread_count = SDL_GetCPUCount();
+    }
+    if (thread_count < 1) {
+        thread_count = 1;
+    } else if (thread_count > THREAD_POOL_MAX) {
+        thread_count = THREAD_POOL_MAX;
+    }
+
+    ThreadPool *pool = malloc(sizeof(ThreadPool));
+    if (pool == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a szalkeszlet letrehozasanal.\n");
+#endif // NDEBUG
+        return NULL;
+    }
+    pool->thread_count = thread_count;
+    pool->quit = 0;
+    pool->task = NULL;
+    pool->data = NULL;
+    SDL_AtomicSet(&pool->workers_done, 0);
+    pool->queues = malloc(sizeof(ThreadQueue)*thread_count);
+    pool->workers = malloc(sizeof(ThreadWorker)*thread_count);
+    pool->work_sem = SDL_CreateSemaphore(0);
+    pool->done_sem = SDL_CreateSemaphore(0);
+    if (pool->queues == NULL || pool->workers == NULL || pool->work_sem == NULL || pool->done_sem == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Hiba a szalkeszlet letrehozasanal: %s\n", SDL_GetError());
+#endif // NDEBUG
+        pool->thread_count = 1;
+        thread_pool_free(pool);
+        return NULL;
+    }
+
+    int i;
+    for (i=0; i<thread_count; i++) {
+        pool->queues[i].lock = 0;
+        pool->queues[i].head = 0;
+        pool->queues[i].tail = 0;
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        pool->workers[i].thread = NULL;
+    }
+    // A 0. szal maga a hivo, annak nem kell uj szalat inditani
+    for (i=1; i<thread_count; i++) {
+        pool->workers[i].thread = SDL_CreateThread(thread_worker, "gol_worker", &pool->workers[i]);
+        if (pool->workers[i].thread == NULL) {
+#ifdef NDEBUG
+            fprintf(stderr, "SDL hiba a szal inditasanal: %s\n", SDL_GetError());
+#endif // NDEBUG
+            pool->thread_count = i;
+            break;
+        }
+    }
+
+    return pool;
+}
+
+void thread_pool_free(ThreadPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    int i;
+    if (pool->workers != NULL && pool->work_sem != NULL) {
+        pool->quit = 1;
+        for (i=1; i<pool->thread_count; i++) {
+            SDL_SemPost(pool->work_sem);
+        }
+        for (i=1; i<pool->thread_count; i++) {
+            SDL_WaitThread(pool->workers[i].thread, NULL);
+        }
+    }
+    if (pool->work_sem != NULL) {
+        SDL_DestroySemaphore(pool->work_sem);
+    }
+    if (pool->done_sem != NULL) {
+        SDL_DestroySemaphore(pool->done_sem);
+    }
+    free(pool->workers);
+    free(pool->queues);
+    free(pool);
+}
+
+int thread_pool_size(const ThreadPool *pool) {
+    return pool == NULL ? 1 : pool->thread_count;
+}
+
+void thread_pool_run(ThreadPool *pool, ThreadTask task, void *data, int task_count) {
+    int i;
+    if (pool == NULL || pool->thread_count == 1 || task_count <= 1) {
+        for (i=0; i<task_count; i++) {
+            task(data, i, 0);
+        }
+        return;
+    }
+
+    // A feladatokat egyenletesen, folytonos tartomanyokban osztjuk szet
+    pool->task = task;
+    pool->data = data;
+    for (i=0; i<pool->thread_count; i++) {
+        pool->queues[i].head = (int)((long long)task_count*i/pool->thread_count);
+        pool->queues[i].tail = (int)((long long)task_count*(i+1)/pool->thread_count);
+    }
+    SDL_AtomicSet(&pool->workers_done, 0);
+    for (i=1; i<pool->thread_count; i++) {
+        SDL_SemPost(pool->work_sem);
+    }
+    // A hivo szal is dolgozik, majd megvarja a tobbieket
+    thread_pool_work(pool, 0);
+    SDL_SemWait(pool->done_sem);
+}
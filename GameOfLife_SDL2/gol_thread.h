@@ -0,0 +1,62 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_thread.h
+ * Description:     A tobbszalu lepteteshez hasznalt szalkeszlet
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#ifndef __GOL_THREAD_H_INCLUDED__
+#define __GOL_THREAD_H_INCLUDED__
+
+/** \brief A szalkeszlet altal vegrehajtott feladat
+ *
+ * \param data void* a feladat kozos adata
+ * \param task int a feladat sorszama
+ * \param worker int a feladatot vegrehajto szal sorszama (0 a hivo szal)
+ * \return void
+ *
+ */
+typedef void (*ThreadTask)(void *data, int task, int worker);
+
+/** \brief Letrehoz egy uj szalkeszletet
+ *
+ * A hivo szal is dolgozik, igy thread_count-1 uj szal indul.
+ *
+ * \param thread_count int a szalak szama (0 vagy negativ eseten a processzormagok szama)
+ * \return ThreadPool* a szalkeszletre mutato pointer (Hiba eseten NULL)
+ *
+ */
+ThreadPool *thread_pool_new(int thread_count);
+
+/** \brief Leallitja a szalakat es felszabaditja a szalkeszletet
+ *
+ * \param pool ThreadPool* a szalkeszletre mutato pointer
+ * \return void
+ *
+ */
+void thread_pool_free(ThreadPool *pool);
+
+/** \brief Visszaadja a szalkeszlet szalainak szamat (a hivo szallal egyutt)
+ *
+ * \param pool const ThreadPool* a szalkeszletre mutato pointer (NULL eseten 1)
+ * \return int a szalak szama
+ *
+ */
+int thread_pool_size(const ThreadPool *pool);
+
+/** \brief Vegrehajtja a 0..task_count-1 sorszamu feladatokat, es megvarja a veguket
+ *
+ * A feladatok folytonos tartomanyokban kerulnek a szalakhoz, a kifogyott szalak
+ * a tobbiek tartomanyanak vegerol lopnak (work stealing).
+ *
+ * \param pool ThreadPool* a szalkeszletre mutato pointer (NULL eseten a hivo szalon fut)
+ * \param task ThreadTask a vegrehajtando feladat
+ * \param data void* a feladat kozos adata
+ * \param task_count int a feladatok szama
+ * \return void
+ *
+ */
+void thread_pool_run(ThreadPool *pool, ThreadTask task, void *data, int task_count);
+
+#endif // __GOL_THREAD_H_INCLUDED__
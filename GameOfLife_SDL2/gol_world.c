@@ -0,0 +1,431 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_world.c
+ * Description:     A vegtelen, darabokbol allo elettel kapcsolatos fuggvenyek es definiciok
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#include <stdlib.h>
+#include <string.h>
+#include "gol_main.h"
+#include "gol_grid.h"
+#include "gol_thread.h"
+#include "gol_world.h"
+
+static const size_t WORLD_TABLE_INIT = 256;
+static const uint64_t WORLD_EMPTY_ROWS[WORLD_CHUNK_SIZE];
+
+/** \brief Visszaadja a darab koordinatainak hash erteket
+ *
+ * \param cx int64_t a darab x koordinataja
+ * \param cy int64_t a darab y koordinataja
+ * \return uint64_t a hash ertek
+ *
+ */
+static uint64_t world_hash(int64_t cx, int64_t cy) {
+    uint64_t h = (uint64_t)cx*0x9E3779B97F4A7C15ULL ^ (uint64_t)cy*0xC2B2AE3D27D4EB4FULL;
+    return h ^ (h >> 31);
+}
+
+/** \brief Ketszeresere noveli a hash tablat
+ *
+ * \param world World* a vilagra mutato pointer
+ * \return void
+ *
+ */
+static void world_table_grow(World *world) {
+    size_t new_size = world->table_size*2;
+    WorldChunk **table = malloc(sizeof(WorldChunk*)*new_size);
+    size_t i;
+    if (table == NULL) {
+        // Hosszabb lancokkal is mukodik tovabb
+        return;
+    }
+    memset(table, 0, sizeof(WorldChunk*)*new_size);
+    for (i=0; i<world->table_size; i++) {
+        WorldChunk *chunk = world->table[i];
+        while (chunk != NULL) {
+            WorldChunk *next = chunk->next;
+            size_t slot = world_hash(chunk->cx, chunk->cy) & (new_size-1);
+            chunk->next = table[slot];
+            table[slot] = chunk;
+            chunk = next;
+        }
+    }
+    free(world->table);
+    world->table = table;
+    world->table_size = new_size;
+}
+
+/** \brief Visszaadja a darabot; ha nem letezik, uj, ures darabot foglal
+ *
+ * \param world World* a vilagra mutato pointer
+ * \param cx int64_t a darab x koordinataja
+ * \param cy int64_t a darab y koordinataja
+ * \return WorldChunk* a darab (Hiba eseten NULL)
+ *
+ */
+static WorldChunk *world_chunk_get(World *world, int64_t cx, int64_t cy) {
+    WorldChunk *chunk = world_chunk_find(world, cx, cy);
+    size_t slot;
+    if (chunk != NULL) {
+        return chunk;
+    }
+    chunk = malloc(sizeof(WorldChunk));
+    if (chunk == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a vilag darabjanak letrehozasanal.\n");
+#endif // NDEBUG
+        return NULL;
+    }
+    memset(chunk, 0, sizeof(WorldChunk));
+    chunk->cx = cx;
+    chunk->cy = cy;
+    slot = world_hash(cx, cy) & (world->table_size-1);
+    chunk->next = world->table[slot];
+    world->table[slot] = chunk;
+    world->chunk_count++;
+    if (world->chunk_count > world->table_size) {
+        world_table_grow(world);
+    }
+    return chunk;
+}
+
+/** \brief Kiveszi a darabot a tablabol es felszabaditja
+ *
+ * \param world World* a vilagra mutato pointer
+ * \param chunk WorldChunk* a darab
+ * \return void
+ *
+ */
+static void world_chunk_remove(World *world, WorldChunk *chunk) {
+    WorldChunk **link = &world->table[world_hash(chunk->cx, chunk->cy) & (world->table_size-1)];
+    while (*link != chunk) {
+        link = &(*link)->next;
+    }
+    *link = chunk->next;
+    free(chunk);
+    world->chunk_count--;
+}
+
+/** \brief Felszabaditja az osszes darabot
+ *
+ * \param world World* a vilagra mutato pointer
+ * \return void
+ *
+ */
+static void world_clear(World *world) {
+    size_t i;
+    for (i=0; i<world->table_size; i++) {
+        while (world->table[i] != NULL) {
+            WorldChunk *next = world->table[i]->next;
+            free(world->table[i]);
+            world->table[i] = next;
+        }
+    }
+    world->chunk_count = 0;
+}
+
+/** \brief Hozzaad egy darabot a leptetes munkalistajahoz
+ *
+ * \param world World* a vilagra mutato pointer
+ * \param count size_t* a lista aktualis hossza
+ * \param chunk WorldChunk* a darab
+ * \return int 1, ha sikerult; 0 hiba eseten
+ *
+ */
+static int world_list_push(World *world, size_t *count, WorldChunk *chunk) {
+    if (*count == world->list_cap) {
+        size_t new_cap = world->list_cap < 64 ? 64 : world->list_cap*2;
+        WorldChunk **list = realloc(world->list, sizeof(WorldChunk*)*new_cap);
+        if (list == NULL) {
+#ifdef NDEBUG
+            fprintf(stderr, "Realloc hiba a vilag leptetesenel.\n");
+#endif // NDEBUG
+            return 0;
+        }
+        world->list = list;
+        world->list_cap = new_cap;
+    }
+    world->list[(*count)++] = chunk;
+    return 1;
+}
+
+World *world_new(void) {
+    World *world = malloc(sizeof(World));
+    if (world == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a vilag letrehozasanal.\n");
+#endif // NDEBUG
+        return NULL;
+    }
+    world->table_size = WORLD_TABLE_INIT;
+    world->table = malloc(sizeof(WorldChunk*)*world->table_size);
+    if (world->table == NULL) {
+#ifdef NDEBUG
+        fprintf(stderr, "Malloc hiba a vilag letrehozasanal.\n");
+#endif // NDEBUG
+        free(world);
+        return NULL;
+    }
+    memset(world->table, 0, sizeof(WorldChunk*)*world->table_size);
+    world->chunk_count = 0;
+    world->list = NULL;
+    world->list_cap = 0;
+    world->pool = NULL;
+    return world;
+}
+
+void world_free(World *world) {
+    world_clear(world);
+    free(world->table);
+    free(world->list);
+    free(world);
+}
+
+void world_clear_cells(World *world) {
+    size_t i;
+    WorldChunk *chunk;
+    // Az uresse valt darabok a kovetkezo lepesben szabadulnak fel
+    for (i=0; i<world->table_size; i++) {
+        for (chunk=world->table[i]; chunk!=NULL; chunk=chunk->next) {
+            memset(chunk->cells, 0, sizeof(chunk->cells));
+        }
+    }
+}
+
+WorldChunk *world_chunk_find(const World *world, int64_t cx, int64_t cy) {
+    WorldChunk *chunk = world->table[world_hash(cx, cy) & (world->table_size-1)];
+    while (chunk != NULL && (chunk->cx != cx || chunk->cy != cy)) {
+        chunk = chunk->next;
+    }
+    return chunk;
+}
+
+void world_set(World *world, int64_t x, int64_t y, const Cell cell) {
+    int64_t cx = world_chunk_coord(x);
+    int64_t cy = world_chunk_coord(y);
+    int bit = (int)(x - cx*WORLD_CHUNK_SIZE);
+    int row = (int)(y - cy*WORLD_CHUNK_SIZE);
+    uint64_t mask = (uint64_t)1 << bit;
+    // Halott cellahoz nem foglalunk uj darabot, a nem letezo darab minden cellaja halott
+    WorldChunk *chunk = cell.state == alive ? world_chunk_get(world, cx, cy) : world_chunk_find(world, cx, cy);
+    if (chunk == NULL) {
+        return;
+    }
+    if (cell.state == alive) {
+        chunk->cells[row] |= mask;
+    } else {
+        chunk->cells[row] &= ~mask;
+    }
+    if (cell.was_alive == alive) {
+        chunk->was_alive[row] |= mask;
+    } else {
+        chunk->was_alive[row] &= ~mask;
+    }
+}
+
+Cell world_get(const World *world, int64_t x, int64_t y) {
+    int64_t cx = world_chunk_coord(x);
+    int64_t cy = world_chunk_coord(y);
+    int bit = (int)(x - cx*WORLD_CHUNK_SIZE);
+    int row = (int)(y - cy*WORLD_CHUNK_SIZE);
+    const WorldChunk *chunk = world_chunk_find(world, cx, cy);
+    if (chunk == NULL) {
+        return (Cell) {
+            dead, dead
+        };
+    }
+    return (Cell) {
+        (chunk->cells[row] >> bit) & 1 ? alive : dead,
+        (chunk->was_alive[row] >> bit) & 1 ? alive : dead
+    };
+}
+
+/** \brief Kiszamolja egy darab kovetkezo generaciojat
+ *
+ * A darab es a nyolc szomszedja aktualis allapotabol olvas, csak a darab next_cells tombjet irja.
+ * Ugyanaz a bitszeletelt osszeadas, mint a grid kerneleiben, a szomszedos darabok
+ * szelso bitjeivel es soraival kiegeszitve.
+ *
+ * \param world const World* a vilagra mutato pointer
+ * \param chunk WorldChunk* a darab
+ * \return void
+ *
+ */
+static void world_chunk_step(const World *world, WorldChunk *chunk) {
+    const uint64_t *rows[3][3];
+    uint64_t sum0[WORLD_CHUNK_SIZE+2], sum1[WORLD_CHUNK_SIZE+2];
+    int dx, dy, r;
+    for (dy=0; dy<3; dy++) {
+        for (dx=0; dx<3; dx++) {
+            const WorldChunk *n = dx == 1 && dy == 1 ? chunk : world_chunk_find(world, chunk->cx+dx-1, chunk->cy+dy-1);
+            rows[dy][dx] = n != NULL ? n->cells : WORLD_EMPTY_ROWS;
+        }
+    }
+
+    // A darab feletti es alatti sorral egyutt minden sor vizszintes harmas osszege
+    for (r=0; r<WORLD_CHUNK_SIZE+2; r++) {
+        int band = r == 0 ? 0 : r == WORLD_CHUNK_SIZE+1 ? 2 : 1;
+        int y = (r + WORLD_CHUNK_SIZE - 1) % WORLD_CHUNK_SIZE;
+        uint64_t mid = rows[band][1][y];
+        uint64_t left = mid << 1 | rows[band][0][y] >> 63;
+        uint64_t right = mid >> 1 | rows[band][2][y] << 63;
+        sum0[r] = left ^ mid ^ right;
+        sum1[r] = (left & mid) | (right & (left ^ mid));
+    }
+    for (r=0; r<WORLD_CHUNK_SIZE; r++) {
+        uint64_t up0 = sum0[r], mid0 = sum0[r+1], down0 = sum0[r+2];
+        uint64_t up1 = sum1[r], mid1 = sum1[r+1], down1 = sum1[r+2];
+        uint64_t s0 = up0 ^ mid0 ^ down0;
+        uint64_t carry = (up0 & mid0) | (down0 & (up0 ^ mid0));
+        uint64_t half0 = up1 ^ mid1;
+        uint64_t half1 = down1 ^ carry;
+        uint64_t s1 = half0 ^ half1;
+        uint64_t s2 = (up1 & mid1) ^ (down1 & carry) ^ (half0 & half1);
+        uint64_t s3 = up1 & mid1 & down1 & carry;
+        uint64_t three = s0 & s1 & ~s2;
+        uint64_t four = ~s0 & ~s1 & s2 & chunk->cells[r];
+        chunk->next_cells[r] = (three | four) & ~s3;
+    }
+}
+
+/** \brief A szalkeszlet altal vegrehajtott feladat: egy darab leptetese
+ *
+ * \param data void* a vilagra mutato pointer
+ * \param task int a darab sorszama a munkalistaban
+ * \param worker int a vegrehajto szal sorszama
+ * \return void
+ *
+ */
+static void world_step_task(void *data, int task, int worker) {
+    World *world = data;
+    (void)worker;
+    world_chunk_step(world, world->list[task]);
+}
+
+void world_step(World *world) {
+    size_t count = 0, alive_count, i;
+    int r;
+    WorldChunk *chunk;
+
+    for (i=0; i<world->table_size; i++) {
+        for (chunk=world->table[i]; chunk!=NULL; chunk=chunk->next) {
+            if (!world_list_push(world, &count, chunk)) {
+                return;
+            }
+        }
+    }
+
+    // Ahol a szelen elo cella van, ott a szomszedos darabban szulethet uj cella
+    alive_count = count;
+    for (i=0; i<alive_count; i++) {
+        const uint64_t *cells = world->list[i]->cells;
+        uint64_t left = 0, right = 0;
+        int dx, dy;
+        for (r=0; r<WORLD_CHUNK_SIZE; r++) {
+            left |= cells[r];
+            right |= cells[r];
+        }
+        left &= 1;
+        right >>= 63;
+        for (dy=-1; dy<=1; dy++) {
+            uint64_t row = dy < 0 ? cells[0] : dy > 0 ? cells[WORLD_CHUNK_SIZE-1] : (left | right << 63);
+            for (dx=-1; dx<=1; dx++) {
+                int edge = dx < 0 ? (row & 1) != 0 : dx > 0 ? (row >> 63) != 0 : (dy != 0 && row != 0);
+                int64_t cx = world->list[i]->cx + dx;
+                int64_t cy = world->list[i]->cy + dy;
+                if (edge && world_chunk_find(world, cx, cy) == NULL) {
+                    chunk = world_chunk_get(world, cx, cy);
+                    if (chunk == NULL || !world_list_push(world, &count, chunk)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    thread_pool_run(world->pool, world_step_task, world, (int)count);
+
+    // Az uj generacio atvetele, az uresse valt darabok felszabaditasa
+    for (i=0; i<count; i++) {
+        uint64_t any = 0;
+        chunk = world->list[i];
+        for (r=0; r<WORLD_CHUNK_SIZE; r++) {
+            chunk->cells[r] = chunk->next_cells[r];
+            chunk->was_alive[r] |= chunk->cells[r];
+            any |= chunk->cells[r];
+        }
+        if (any == 0) {
+            world_chunk_remove(world, chunk);
+        }
+    }
+}
+
+uint64_t world_population(const World *world) {
+    uint64_t population = 0;
+    size_t i;
+    int r;
+    const WorldChunk *chunk;
+    for (i=0; i<world->table_size; i++) {
+        for (chunk=world->table[i]; chunk!=NULL; chunk=chunk->next) {
+            for (r=0; r<WORLD_CHUNK_SIZE; r++) {
+                population += grid_popcount(chunk->cells[r]);
+            }
+        }
+    }
+    return population;
+}
+
+void world_from_grid(World *world, const Grid *grid) {
+    // A grid szavai pontosan egy-egy darab soraira esnek
+    int words = grid_words(grid->size_x);
+    int w, y;
+    world_clear(world);
+    for (y=0; y<grid->size_y; y++) {
+        const uint64_t *cells = grid_row(grid, grid->cells, y) + GRID_HALO_WORDS;
+        const uint64_t *was_alive = grid_row(grid, grid->was_alive, y) + GRID_HALO_WORDS;
+        for (w=0; w<words; w++) {
+            if (cells[w] | was_alive[w]) {
+                WorldChunk *chunk = world_chunk_get(world, w, y / WORLD_CHUNK_SIZE);
+                if (chunk == NULL) {
+                    return;
+                }
+                chunk->cells[y % WORLD_CHUNK_SIZE] = cells[w];
+                chunk->was_alive[y % WORLD_CHUNK_SIZE] = was_alive[w];
+            }
+        }
+    }
+}
+
+uint64_t world_to_grid(const World *world, Grid *grid) {
+    uint64_t lost = 0;
+    size_t i;
+    int r, bit;
+    const WorldChunk *chunk;
+    grid_clear_cells(grid);
+    for (i=0; i<world->table_size; i++) {
+        for (chunk=world->table[i]; chunk!=NULL; chunk=chunk->next) {
+            for (r=0; r<WORLD_CHUNK_SIZE; r++) {
+                uint64_t bits = chunk->cells[r] | chunk->was_alive[r];
+                int64_t y = chunk->cy*WORLD_CHUNK_SIZE + r;
+                for (bit=0; bits!=0; bit++, bits>>=1) {
+                    int64_t x = chunk->cx*WORLD_CHUNK_SIZE + bit;
+                    int state = (chunk->cells[r] >> bit) & 1;
+                    if (!(bits & 1)) {
+                        continue;
+                    }
+                    if (x < 0 || y < 0 || x >= GRID_COORD_LIMIT || y >= GRID_COORD_LIMIT) {
+                        lost += state;
+                    } else {
+                        grid_set(grid, (int)x, (int)y, (Cell) {
+                            state ? alive : dead, alive
+                        });
+                    }
+                }
+            }
+        }
+    }
+    return lost;
+}
@@ -0,0 +1,117 @@
+/**********************************
+ * Project:         Game of Life
+ * Filename:        gol_world.h
+ * Description:     A vegtelen, darabokbol allo elettel kapcsolatos fuggvenyek
+ *
+ * Copyright Telek Istvan 2015
+ *
+ **********************************/
+#ifndef __GOL_WORLD_H_INCLUDED__
+#define __GOL_WORLD_H_INCLUDED__
+
+#define WORLD_CHUNK_SHIFT 6     /**< log2(WORLD_CHUNK_SIZE) */
+
+/** \brief Visszaadja a koordinatat tartalmazo darab koordinatajat
+ *
+ * Negativ koordinatakra is lefele kerekit (a GCC a negativ szamokat aritmetikaian tolja el).
+ *
+ * \param x int64_t a cella koordinataja
+ * \return int64_t a darab koordinataja
+ *
+ */
+static inline int64_t world_chunk_coord(int64_t x) {
+    return x >> WORLD_CHUNK_SHIFT;
+}
+
+/** \brief Letrehoz egy uj, ures vilagot
+ *
+ * \return World* a vilagra mutato pointer (Hiba eseten NULL)
+ *
+ */
+World *world_new(void);
+
+/** \brief Felszabaditja a vilagot
+ *
+ * \param world World* a vilagra mutato pointer
+ * \return void
+ *
+ */
+void world_free(World *world);
+
+/** \brief Minden cellat halottra allit, a mar elt cellak nyilvantartasa megmarad
+ *
+ * \param world World* a vilagra mutato pointer
+ * \return void
+ *
+ */
+void world_clear_cells(World *world);
+
+/** \brief Visszaadja a darabot, ha letezik
+ *
+ * \param world const World* a vilagra mutato pointer
+ * \param cx int64_t a darab x koordinataja
+ * \param cy int64_t a darab y koordinataja
+ * \return WorldChunk* a darab (NULL, ha nincs lefoglalva)
+ *
+ */
+WorldChunk *world_chunk_find(const World *world, int64_t cx, int64_t cy);
+
+/** \brief Beallitja a cellat; elo cellanal szukseg eseten uj darabot foglal
+ *
+ * \param world World* a vilagra mutato pointer
+ * \param x int64_t a cella x koordinataja
+ * \param y int64_t a cella y koordinataja
+ * \param cell const Cell a tarolni kivant ertek
+ * \return void
+ *
+ */
+void world_set(World *world, int64_t x, int64_t y, const Cell cell);
+
+/** \brief Visszaadja a cella erteket (a nem lefoglalt darabok cellai halottak)
+ *
+ * \param world const World* a vilagra mutato pointer
+ * \param x int64_t a cella x koordinataja
+ * \param y int64_t a cella y koordinataja
+ * \return Cell a cella erteke
+ *
+ */
+Cell world_get(const World *world, int64_t x, int64_t y);
+
+/** \brief Kiszamolja a kovetkezo generaciot
+ *
+ * Az elo cellat tartalmazo darabok szelein szukseg szerint uj darabok jonnek letre,
+ * a lepes utan elo cella nelkul maradt darabok (a was_alive nyomukkal egyutt) felszabadulnak.
+ *
+ * \param world World* a vilagra mutato pointer
+ * \return void
+ *
+ */
+void world_step(World *world);
+
+/** \brief Visszaadja az elo cellak szamat
+ *
+ * \param world const World* a vilagra mutato pointer
+ * \return uint64_t az elo cellak szama
+ *
+ */
+uint64_t world_population(const World *world);
+
+/** \brief Atmasolja a grid cellait a vilagba (a vilag elozo tartalma torlodik)
+ *
+ * \param world World* a vilagra mutato pointer
+ * \param grid const Grid* a gridre mutato pointer
+ * \return void
+ *
+ */
+void world_from_grid(World *world, const Grid *grid);
+
+/** \brief Atmasolja a vilag nem negativ koordinataju cellait a gridbe
+ *
+ * \param world const World* a vilagra mutato pointer
+ * \param grid Grid* a gridre mutato pointer
+ * \return uint64_t a gridbe nem fero (elvesztett) elo cellak szama
+ *
+ */
+uint64_t world_to_grid(const World *world, Grid *grid);
+
+#endif // __GOL_WORLD_H_INCLUDED__